@@ -0,0 +1,334 @@
+/**
+ * simd lanes for the batched collision kernel
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#ifndef __COLLISION_LANES_H__
+#define __COLLISION_LANES_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "types.h"
+
+#if !defined(TASPATHS_NO_SIMD) && defined(__AVX2__)
+	#include <immintrin.h>
+	#define TASPATHS_SIMD_AVX2
+#elif !defined(TASPATHS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+	#include <emmintrin.h>
+	#define TASPATHS_SIMD_SSE2
+#endif
+
+
+// ----------------------------------------------------------------------------
+// lane types:
+// every operation acts element-wise and is exactly rounded, so all
+// implementations give bit-identical results for the same inputs
+// ----------------------------------------------------------------------------
+#if defined(TASPATHS_SIMD_AVX2)
+
+/**
+ * four double lanes using avx2
+ */
+struct CollisionLanes
+{
+	static constexpr std::size_t NUM = 4;
+	static constexpr const char* NAME = "avx2";
+
+	struct t_mask { __m256d m; };
+	__m256d v;
+
+
+	static CollisionLanes set(t_real val) { return { _mm256_set1_pd(val) }; }
+	static CollisionLanes load(const t_real* arr) { return { _mm256_loadu_pd(arr) }; }
+	void store(t_real* arr) const { _mm256_storeu_pd(arr, v); }
+
+	friend CollisionLanes operator+(CollisionLanes a, CollisionLanes b) { return { _mm256_add_pd(a.v, b.v) }; }
+	friend CollisionLanes operator-(CollisionLanes a, CollisionLanes b) { return { _mm256_sub_pd(a.v, b.v) }; }
+	friend CollisionLanes operator*(CollisionLanes a, CollisionLanes b) { return { _mm256_mul_pd(a.v, b.v) }; }
+	friend CollisionLanes operator/(CollisionLanes a, CollisionLanes b) { return { _mm256_div_pd(a.v, b.v) }; }
+
+	friend CollisionLanes min(CollisionLanes a, CollisionLanes b) { return { _mm256_min_pd(a.v, b.v) }; }
+	friend CollisionLanes max(CollisionLanes a, CollisionLanes b) { return { _mm256_max_pd(a.v, b.v) }; }
+
+	friend t_mask operator<(CollisionLanes a, CollisionLanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+	friend t_mask operator>(CollisionLanes a, CollisionLanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+	friend t_mask operator==(CollisionLanes a, CollisionLanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ) }; }
+	friend t_mask operator!=(CollisionLanes a, CollisionLanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ) }; }
+
+	friend t_mask operator&(t_mask a, t_mask b) { return { _mm256_and_pd(a.m, b.m) }; }
+	friend t_mask operator|(t_mask a, t_mask b) { return { _mm256_or_pd(a.m, b.m) }; }
+	friend t_mask operator!(t_mask a) { return { _mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))) }; }
+
+	static t_mask none() { return { _mm256_setzero_pd() }; }
+	static bool any(t_mask a) { return _mm256_movemask_pd(a.m) != 0; }
+	static bool all(t_mask a) { return _mm256_movemask_pd(a.m) == 0xf; }
+	static bool get(t_mask a, std::size_t lane) { return (_mm256_movemask_pd(a.m) >> lane) & 1; }
+
+	friend CollisionLanes select(t_mask mask, CollisionLanes a, CollisionLanes b)
+	{ return { _mm256_blendv_pd(b.v, a.v, mask.m) }; }
+};
+
+#elif defined(TASPATHS_SIMD_SSE2)
+
+/**
+ * two double lanes using sse2
+ */
+struct CollisionLanes
+{
+	static constexpr std::size_t NUM = 2;
+	static constexpr const char* NAME = "sse2";
+
+	struct t_mask { __m128d m; };
+	__m128d v;
+
+
+	static CollisionLanes set(t_real val) { return { _mm_set1_pd(val) }; }
+	static CollisionLanes load(const t_real* arr) { return { _mm_loadu_pd(arr) }; }
+	void store(t_real* arr) const { _mm_storeu_pd(arr, v); }
+
+	friend CollisionLanes operator+(CollisionLanes a, CollisionLanes b) { return { _mm_add_pd(a.v, b.v) }; }
+	friend CollisionLanes operator-(CollisionLanes a, CollisionLanes b) { return { _mm_sub_pd(a.v, b.v) }; }
+	friend CollisionLanes operator*(CollisionLanes a, CollisionLanes b) { return { _mm_mul_pd(a.v, b.v) }; }
+	friend CollisionLanes operator/(CollisionLanes a, CollisionLanes b) { return { _mm_div_pd(a.v, b.v) }; }
+
+	friend CollisionLanes min(CollisionLanes a, CollisionLanes b) { return { _mm_min_pd(a.v, b.v) }; }
+	friend CollisionLanes max(CollisionLanes a, CollisionLanes b) { return { _mm_max_pd(a.v, b.v) }; }
+
+	friend t_mask operator<(CollisionLanes a, CollisionLanes b) { return { _mm_cmplt_pd(a.v, b.v) }; }
+	friend t_mask operator>(CollisionLanes a, CollisionLanes b) { return { _mm_cmpgt_pd(a.v, b.v) }; }
+	friend t_mask operator==(CollisionLanes a, CollisionLanes b) { return { _mm_cmpeq_pd(a.v, b.v) }; }
+	friend t_mask operator!=(CollisionLanes a, CollisionLanes b) { return { _mm_cmpneq_pd(a.v, b.v) }; }
+
+	friend t_mask operator&(t_mask a, t_mask b) { return { _mm_and_pd(a.m, b.m) }; }
+	friend t_mask operator|(t_mask a, t_mask b) { return { _mm_or_pd(a.m, b.m) }; }
+	friend t_mask operator!(t_mask a) { return { _mm_xor_pd(a.m, _mm_castsi128_pd(_mm_set1_epi32(-1))) }; }
+
+	static t_mask none() { return { _mm_setzero_pd() }; }
+	static bool any(t_mask a) { return _mm_movemask_pd(a.m) != 0; }
+	static bool all(t_mask a) { return _mm_movemask_pd(a.m) == 0x3; }
+	static bool get(t_mask a, std::size_t lane) { return (_mm_movemask_pd(a.m) >> lane) & 1; }
+
+	friend CollisionLanes select(t_mask mask, CollisionLanes a, CollisionLanes b)
+	{ return { _mm_or_pd(_mm_and_pd(mask.m, a.v), _mm_andnot_pd(mask.m, b.v)) }; }
+};
+
+#else
+
+/**
+ * scalar fallback with a single lane
+ */
+struct CollisionLanes
+{
+	static constexpr std::size_t NUM = 1;
+	static constexpr const char* NAME = "scalar";
+
+	struct t_mask { bool m; };
+	t_real v;
+
+
+	static CollisionLanes set(t_real val) { return { val }; }
+	static CollisionLanes load(const t_real* arr) { return { *arr }; }
+	void store(t_real* arr) const { *arr = v; }
+
+	friend CollisionLanes operator+(CollisionLanes a, CollisionLanes b) { return { a.v + b.v }; }
+	friend CollisionLanes operator-(CollisionLanes a, CollisionLanes b) { return { a.v - b.v }; }
+	friend CollisionLanes operator*(CollisionLanes a, CollisionLanes b) { return { a.v * b.v }; }
+	friend CollisionLanes operator/(CollisionLanes a, CollisionLanes b) { return { a.v / b.v }; }
+
+	// same operand order as the min/max instructions
+	friend CollisionLanes min(CollisionLanes a, CollisionLanes b) { return { a.v < b.v ? a.v : b.v }; }
+	friend CollisionLanes max(CollisionLanes a, CollisionLanes b) { return { a.v > b.v ? a.v : b.v }; }
+
+	friend t_mask operator<(CollisionLanes a, CollisionLanes b) { return { a.v < b.v }; }
+	friend t_mask operator>(CollisionLanes a, CollisionLanes b) { return { a.v > b.v }; }
+	friend t_mask operator==(CollisionLanes a, CollisionLanes b) { return { a.v == b.v }; }
+	friend t_mask operator!=(CollisionLanes a, CollisionLanes b) { return { a.v != b.v }; }
+
+	friend t_mask operator&(t_mask a, t_mask b) { return { a.m && b.m }; }
+	friend t_mask operator|(t_mask a, t_mask b) { return { a.m || b.m }; }
+	friend t_mask operator!(t_mask a) { return { !a.m }; }
+
+	static t_mask none() { return { false }; }
+	static bool any(t_mask a) { return a.m; }
+	static bool all(t_mask a) { return a.m; }
+	static bool get(t_mask a, std::size_t) { return a.m; }
+
+	friend CollisionLanes select(t_mask mask, CollisionLanes a, CollisionLanes b)
+	{ return { mask.m ? a.v : b.v }; }
+};
+
+#endif
+// ----------------------------------------------------------------------------
+
+
+// number of vertices of the projected boxes
+constexpr std::size_t COLLISION_BOX_VERTS = 4;
+
+
+// ----------------------------------------------------------------------------
+// allocation-free primitive tests, evaluated in simd lanes
+// ----------------------------------------------------------------------------
+/**
+ * check two circles for collision
+ */
+template<class t_lanes>
+static inline typename t_lanes::t_mask collide_circle_circle(
+	t_lanes x1, t_lanes y1, t_lanes rad1,
+	t_lanes x2, t_lanes y2, t_lanes rad2)
+{
+	const t_lanes dx = x2 - x1;
+	const t_lanes dy = y2 - y1;
+	const t_lanes rad = rad1 + rad2;
+
+	return dx*dx + dy*dy < rad*rad;
+}
+
+
+/**
+ * check a circle and a convex quadrilateral for collision
+ */
+template<class t_lanes>
+static inline typename t_lanes::t_mask collide_circle_box(
+	t_lanes x, t_lanes y, t_lanes rad,
+	const t_lanes* box_x, const t_lanes* box_y)
+{
+	constexpr std::size_t N = COLLISION_BOX_VERTS;
+	const t_lanes zero = t_lanes::set(0);
+	const t_lanes one = t_lanes::set(1);
+
+	// orientation of the box vertices
+	t_lanes area = zero;
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+		area = area + (box_x[idx1]*box_y[idx2] - box_x[idx2]*box_y[idx1]);
+	}
+
+	typename t_lanes::t_mask inside = (area != zero);
+	t_lanes min_dist_sq = t_lanes::set(std::numeric_limits<t_real>::max());
+
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+
+		const t_lanes edge_x = box_x[idx2] - box_x[idx1];
+		const t_lanes edge_y = box_y[idx2] - box_y[idx1];
+		const t_lanes pt_x = x - box_x[idx1];
+		const t_lanes pt_y = y - box_y[idx1];
+
+		// circle centre on the outer side of the edge?
+		inside = inside & !((edge_x*pt_y - edge_y*pt_x) * area < zero);
+
+		// distance to the closest point on the edge
+		const t_lanes len_sq = edge_x*edge_x + edge_y*edge_y;
+		t_lanes param = select(len_sq > zero, (pt_x*edge_x + pt_y*edge_y) / len_sq, zero);
+		param = min(max(param, zero), one);
+
+		const t_lanes dx = pt_x - param*edge_x;
+		const t_lanes dy = pt_y - param*edge_y;
+		min_dist_sq = min(min_dist_sq, dx*dx + dy*dy);
+	}
+
+	return inside | (min_dist_sq < rad*rad);
+}
+
+
+/**
+ * is there a separating axis among the edge normals of the first box?
+ * the boxes are separated by at least the given margin along the axis
+ */
+template<class t_lanes>
+static inline typename t_lanes::t_mask separated_box_box(
+	const t_lanes* box1_x, const t_lanes* box1_y,
+	const t_lanes* box2_x, const t_lanes* box2_y,
+	t_real margin = 0)
+{
+	constexpr std::size_t N = COLLISION_BOX_VERTS;
+	const t_lanes zero = t_lanes::set(0);
+
+	typename t_lanes::t_mask separated = t_lanes::none();
+
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+
+		const t_lanes norm_x = box1_y[idx1] - box1_y[idx2];
+		const t_lanes norm_y = box1_x[idx2] - box1_x[idx1];
+
+		t_lanes min1 = norm_x*box1_x[0] + norm_y*box1_y[0];
+		t_lanes min2 = norm_x*box2_x[0] + norm_y*box2_y[0];
+		t_lanes max1 = min1, max2 = min2;
+
+		for(std::size_t vert=1; vert<N; ++vert)
+		{
+			const t_lanes proj1 = norm_x*box1_x[vert] + norm_y*box1_y[vert];
+			const t_lanes proj2 = norm_x*box2_x[vert] + norm_y*box2_y[vert];
+
+			min1 = min(min1, proj1);
+			max1 = max(max1, proj1);
+			min2 = min(min2, proj2);
+			max2 = max(max2, proj2);
+		}
+
+		// ignore degenerate edges
+		typename t_lanes::t_mask valid = (norm_x != zero) | (norm_y != zero);
+
+		if(margin > 0)
+		{
+			// the normals are not normalised, compare the squared gaps instead
+			const t_lanes margin_sq = t_lanes::set(margin*margin) * (norm_x*norm_x + norm_y*norm_y);
+			const t_lanes gap1 = min2 - max1;
+			const t_lanes gap2 = min1 - max2;
+
+			separated = separated | (valid & (
+				((gap1 > zero) & (gap1*gap1 > margin_sq)) |
+				((gap2 > zero) & (gap2*gap2 > margin_sq))));
+		}
+		else
+		{
+			separated = separated | (valid & ((max1 < min2) | (max2 < min1)));
+		}
+	}
+
+	return separated;
+}
+
+
+/**
+ * check two convex quadrilaterals for collision using separating axes
+ */
+template<class t_lanes>
+static inline typename t_lanes::t_mask collide_box_box(
+	const t_lanes* box1_x, const t_lanes* box1_y,
+	const t_lanes* box2_x, const t_lanes* box2_y,
+	t_real margin = 0)
+{
+	return !(separated_box_box(box1_x, box1_y, box2_x, box2_y, margin) |
+		separated_box_box(box2_x, box2_y, box1_x, box1_y, margin));
+}
+// ----------------------------------------------------------------------------
+
+
+#endif
@@ -0,0 +1,1138 @@
+/**
+ * compiled 2d collision scene for fast configuration space calculations
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+#include "CollisionScene2D.h"
+#include "CollisionLanes.h"
+#include "InstrumentSpace.h"
+
+
+// ----------------------------------------------------------------------------
+// loading of the primitives into simd lanes
+// ----------------------------------------------------------------------------
+static_assert(CollisionBoxes2D::NUM_VERTS == COLLISION_BOX_VERTS, "Box vertex count mismatch!");
+
+
+/**
+ * load the vertices of a box from a lane-interleaved array
+ */
+template<class t_lanes>
+static inline void load_box(const t_real* arr, std::size_t box_idx,
+	t_lanes* verts)
+{
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+
+	for(std::size_t vert=0; vert<N; ++vert)
+		verts[vert] = t_lanes::load(arr + (box_idx*N + vert)*t_lanes::NUM);
+}
+
+
+/**
+ * load the vertices of a static box into all lanes
+ */
+template<class t_lanes>
+static inline void set_box(const t_real* arr, std::size_t box_idx,
+	t_lanes* verts)
+{
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+
+	for(std::size_t vert=0; vert<N; ++vert)
+		verts[vert] = t_lanes::set(arr[box_idx*N + vert]);
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// scene compilation
+// ----------------------------------------------------------------------------
+CollisionScene2D::CollisionScene2D(const InstrumentSpace& instrspace)
+{
+	Compile(instrspace);
+}
+
+
+void CollisionScene2D::Clear()
+{
+	m_wall_circles.clear();
+	m_wall_boxes.clear();
+	m_wall_box_bounds.clear();
+	m_wall_bounds.Reset();
+
+	m_comp_circles.clear();
+	m_comp_boxes.clear();
+	m_circle_offs.fill(0);
+	m_box_offs.fill(0);
+	m_reach.fill(0);
+
+	m_instrspace = nullptr;
+}
+
+
+/**
+ * flatten a cylinder, sphere or box geometry into a circle or a quadrilateral
+ * in the frame given by the geometry's transformation matrix
+ */
+void CollisionScene2D::AddComponent(const std::shared_ptr<Geometry>& comp,
+	CollisionCircles2D& circles, CollisionBoxes2D& boxes) const
+{
+	const t_mat& mat = comp->GetTrafo();
+
+	switch(comp->GetType())
+	{
+		case GeometryType::CYLINDER:
+		case GeometryType::SPHERE:
+		{
+			t_real rad = 0;
+			if(comp->GetType() == GeometryType::CYLINDER)
+				rad = std::dynamic_pointer_cast<CylinderGeometry>(comp)->GetRadius();
+			else
+				rad = std::dynamic_pointer_cast<SphereGeometry>(comp)->GetRadius();
+
+			// position already considered in trafo matrix
+			t_vec pos = mat * tl2::create<t_vec>({0, 0, 0, 1});
+			circles.push_back(pos[0], pos[1], rad);
+			break;
+		}
+
+		case GeometryType::BOX:
+		{
+			auto box = std::dynamic_pointer_cast<BoxGeometry>(comp);
+
+			t_real lx = box->GetLength() * t_real(0.5);
+			t_real ly = box->GetDepth() * t_real(0.5);
+			t_real lz = box->GetHeight() * t_real(0.5);
+
+			const t_vec vertices[CollisionBoxes2D::NUM_VERTS] =
+			{
+				mat * tl2::create<t_vec>({ +lx, -ly, -lz, 1 }),	// vertex 0
+				mat * tl2::create<t_vec>({ -lx, -ly, -lz, 1 }),	// vertex 1
+				mat * tl2::create<t_vec>({ -lx, +ly, -lz, 1 }),	// vertex 2
+				mat * tl2::create<t_vec>({ +lx, +ly, -lz, 1 }),	// vertex 3
+			};
+
+			// only two dimensions needed
+			for(const t_vec& vec : vertices)
+			{
+				boxes.x.push_back(vec[0]);
+				boxes.y.push_back(vec[1]);
+			}
+			break;
+		}
+	}
+}
+
+
+/**
+ * create the collision scene from the current instrument space
+ */
+void CollisionScene2D::Compile(const InstrumentSpace& instrspace)
+{
+	Clear();
+
+	// method 1 is the half-plane test, which is the one the kernels use
+	m_poly_intersection_method = instrspace.GetPolyIntersectionMethod();
+	m_eps = instrspace.GetEpsilon();
+	if(m_poly_intersection_method != 1)
+		m_instrspace = std::make_shared<const InstrumentSpace>(instrspace);
+
+	const Instrument& instr = instrspace.GetInstrument();
+	const Axis* axes[NUM_AXES] =
+	{
+		&instr.GetMonochromator(),
+		&instr.GetSample(),
+		&instr.GetAnalyser(),
+	};
+
+	const AxisAngle axisangles[NUM_AXIS_GROUPS] =
+	{
+		AxisAngle::INCOMING,
+		AxisAngle::INTERNAL,
+		AxisAngle::OUTGOING,
+	};
+
+	// axis components in their local frames
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		const Axis& axis = *axes[axis_idx];
+
+		const t_vec& pos = axis.GetZeroPos();
+		m_pos_x[axis_idx] = pos.size() > 0 ? pos[0] : 0;
+		m_pos_y[axis_idx] = pos.size() > 1 ? pos[1] : 0;
+		m_angles_in[axis_idx] = axis.GetAxisAngleIn();
+
+		m_limits[axis_idx][0][0] = axis.GetAxisAngleInLowerLimit();
+		m_limits[axis_idx][0][1] = axis.GetAxisAngleInUpperLimit();
+		m_limits[axis_idx][1][0] = axis.GetAxisAngleInternalLowerLimit();
+		m_limits[axis_idx][1][1] = axis.GetAxisAngleInternalUpperLimit();
+		m_limits[axis_idx][2][0] = axis.GetAxisAngleOutLowerLimit();
+		m_limits[axis_idx][2][1] = axis.GetAxisAngleOutUpperLimit();
+
+		for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+		{
+			std::size_t group_idx = axis_idx*NUM_AXIS_GROUPS + group;
+			m_circle_offs[group_idx] = m_comp_circles.size();
+			m_box_offs[group_idx] = m_comp_boxes.size();
+
+			for(const auto& comp : axis.GetComps(axisangles[group]))
+				AddComponent(comp, m_comp_circles, m_comp_boxes);
+		}
+	}
+
+	m_circle_offs[NUM_GROUPS] = m_comp_circles.size();
+	m_box_offs[NUM_GROUPS] = m_comp_boxes.size();
+
+	// reach of the axes, independent of their rotation angles
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		t_real& reach = m_reach[axis_idx];
+
+		std::size_t circle_begin = m_circle_offs[axis_idx*NUM_AXIS_GROUPS];
+		std::size_t circle_end = m_circle_offs[(axis_idx+1)*NUM_AXIS_GROUPS];
+		for(std::size_t idx=circle_begin; idx<circle_end; ++idx)
+		{
+			reach = std::max(reach, std::hypot(m_comp_circles.x[idx],
+				m_comp_circles.y[idx]) + m_comp_circles.rad[idx]);
+		}
+
+		std::size_t box_begin = m_box_offs[axis_idx*NUM_AXIS_GROUPS] * CollisionBoxes2D::NUM_VERTS;
+		std::size_t box_end = m_box_offs[(axis_idx+1)*NUM_AXIS_GROUPS] * CollisionBoxes2D::NUM_VERTS;
+		for(std::size_t idx=box_begin; idx<box_end; ++idx)
+			reach = std::max(reach, std::hypot(m_comp_boxes.x[idx], m_comp_boxes.y[idx]));
+	}
+
+	// walls in world coordinates
+	for(const auto& wall : instrspace.GetWalls())
+		AddComponent(wall, m_wall_circles, m_wall_boxes);
+
+	// wall bounds
+	m_wall_box_bounds.resize(m_wall_boxes.size());
+	for(std::size_t box_idx=0; box_idx<m_wall_boxes.size(); ++box_idx)
+	{
+		CollisionBounds2D& bounds = m_wall_box_bounds[box_idx];
+		for(std::size_t vert=0; vert<CollisionBoxes2D::NUM_VERTS; ++vert)
+		{
+			std::size_t idx = box_idx*CollisionBoxes2D::NUM_VERTS + vert;
+			bounds.Extend(m_wall_boxes.x[idx], m_wall_boxes.y[idx]);
+		}
+
+		m_wall_bounds.Extend(bounds);
+	}
+
+	for(std::size_t circle_idx=0; circle_idx<m_wall_circles.size(); ++circle_idx)
+	{
+		m_wall_bounds.Extend(m_wall_circles.x[circle_idx],
+			m_wall_circles.y[circle_idx], m_wall_circles.rad[circle_idx]);
+	}
+}
+
+
+/**
+ * create a scratch space for the transformed components;
+ * each thread needs its own one
+ */
+CollisionScene2D::Workspace CollisionScene2D::CreateWorkspace() const
+{
+	constexpr std::size_t L = CollisionLanes::NUM;
+
+	Workspace ws;
+	ws.circle_x.resize(m_comp_circles.size() * L);
+	ws.circle_y.resize(m_comp_circles.size() * L);
+	ws.box_x.resize(m_comp_boxes.size() * CollisionBoxes2D::NUM_VERTS * L);
+	ws.box_y.resize(m_comp_boxes.size() * CollisionBoxes2D::NUM_VERTS * L);
+
+	if(m_instrspace)
+		ws.instrspace = std::make_shared<InstrumentSpace>(*m_instrspace);
+	return ws;
+}
+
+
+/**
+ * number of angle pairs that are checked in parallel
+ */
+std::size_t CollisionScene2D::GetNumLanes()
+{
+	return CollisionLanes::NUM;
+}
+
+
+/**
+ * instruction set used by the collision kernel
+ */
+const char* CollisionScene2D::GetKernelName()
+{
+	return CollisionLanes::NAME;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// scene comparison
+// ----------------------------------------------------------------------------
+/**
+ * check if the instrument axes of both scenes are identical,
+ * i.e. if they only differ by their walls or angular limits
+ */
+bool CollisionScene2D::HasSameAxes(const CollisionScene2D& scene) const
+{
+	return m_poly_intersection_method == scene.m_poly_intersection_method &&
+		m_eps == scene.m_eps &&
+		m_pos_x == scene.m_pos_x && m_pos_y == scene.m_pos_y &&
+		m_angles_in == scene.m_angles_in &&
+		m_circle_offs == scene.m_circle_offs && m_box_offs == scene.m_box_offs &&
+		m_comp_circles.x == scene.m_comp_circles.x &&
+		m_comp_circles.y == scene.m_comp_circles.y &&
+		m_comp_circles.rad == scene.m_comp_circles.rad &&
+		m_comp_boxes.x == scene.m_comp_boxes.x &&
+		m_comp_boxes.y == scene.m_comp_boxes.y;
+}
+
+
+/**
+ * get the bounds of all wall primitives that are only present in one of the scenes
+ */
+std::vector<CollisionBounds2D> CollisionScene2D::GetChangedWallRegions(
+	const CollisionScene2D& scene) const
+{
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+	using t_circle = std::array<t_real, 3>;
+	using t_box = std::array<t_real, N*2>;
+
+	auto get_circles = [](const CollisionScene2D& scene) -> std::vector<t_circle>
+	{
+		std::vector<t_circle> circles;
+		circles.reserve(scene.m_wall_circles.size());
+
+		for(std::size_t idx=0; idx<scene.m_wall_circles.size(); ++idx)
+		{
+			circles.emplace_back(t_circle{{ scene.m_wall_circles.x[idx],
+				scene.m_wall_circles.y[idx], scene.m_wall_circles.rad[idx] }});
+		}
+
+		std::sort(circles.begin(), circles.end());
+		return circles;
+	};
+
+	auto get_boxes = [](const CollisionScene2D& scene) -> std::vector<t_box>
+	{
+		std::vector<t_box> boxes;
+		boxes.reserve(scene.m_wall_boxes.size());
+
+		for(std::size_t idx=0; idx<scene.m_wall_boxes.size(); ++idx)
+		{
+			t_box box;
+			for(std::size_t vert=0; vert<N; ++vert)
+			{
+				box[vert*2 + 0] = scene.m_wall_boxes.x[idx*N + vert];
+				box[vert*2 + 1] = scene.m_wall_boxes.y[idx*N + vert];
+			}
+			boxes.emplace_back(std::move(box));
+		}
+
+		std::sort(boxes.begin(), boxes.end());
+		return boxes;
+	};
+
+	std::vector<t_circle> circles1 = get_circles(*this), circles2 = get_circles(scene);
+	std::vector<t_box> boxes1 = get_boxes(*this), boxes2 = get_boxes(scene);
+
+	std::vector<t_circle> changed_circles;
+	std::vector<t_box> changed_boxes;
+	std::set_symmetric_difference(circles1.begin(), circles1.end(),
+		circles2.begin(), circles2.end(), std::back_inserter(changed_circles));
+	std::set_symmetric_difference(boxes1.begin(), boxes1.end(),
+		boxes2.begin(), boxes2.end(), std::back_inserter(changed_boxes));
+
+	std::vector<CollisionBounds2D> regions;
+	regions.reserve(changed_circles.size() + changed_boxes.size());
+
+	for(const t_circle& circle : changed_circles)
+	{
+		CollisionBounds2D& bounds = regions.emplace_back();
+		bounds.Extend(circle[0], circle[1], circle[2]);
+	}
+
+	for(const t_box& box : changed_boxes)
+	{
+		CollisionBounds2D& bounds = regions.emplace_back();
+		for(std::size_t vert=0; vert<N; ++vert)
+			bounds.Extend(box[vert*2 + 0], box[vert*2 + 1]);
+	}
+
+	return regions;
+}
+
+
+/**
+ * check if any axis can reach any of the given regions at the given angles,
+ * the test is conservative as it considers all possible internal and
+ * outgoing rotations of an axis' components
+ */
+bool CollisionScene2D::CanReach(const t_angles& angles_out,
+	const std::vector<CollisionBounds2D>& regions) const
+{
+	if(regions.size() == 0)
+		return false;
+
+	// outgoing trafo of the previous axis
+	t_real prev_angle = 0, prev_x = 0, prev_y = 0;
+
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		// axis origin in world coordinates
+		const t_real prev_c = std::cos(prev_angle);
+		const t_real prev_s = std::sin(prev_angle);
+		const t_real pos_x = prev_c*m_pos_x[axis_idx] - prev_s*m_pos_y[axis_idx] + prev_x;
+		const t_real pos_y = prev_s*m_pos_x[axis_idx] + prev_c*m_pos_y[axis_idx] + prev_y;
+		const t_real reach = m_reach[axis_idx];
+
+		for(const CollisionBounds2D& region : regions)
+		{
+			// distance of the axis origin to the region
+			t_real dx = std::max({ region.min_x - pos_x, t_real(0), pos_x - region.max_x });
+			t_real dy = std::max({ region.min_y - pos_y, t_real(0), pos_y - region.max_y });
+
+			if(dx*dx + dy*dy <= reach*reach)
+				return true;
+		}
+
+		prev_angle += m_angles_in[axis_idx] + angles_out[axis_idx];
+		prev_x = pos_x;
+		prev_y = pos_y;
+	}
+
+	return false;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// queries
+// ----------------------------------------------------------------------------
+/**
+ * check if the given angles are within the axis limits
+ */
+bool CollisionScene2D::CheckAngularLimits(const t_angles& angles_out,
+	const t_angles& angles_internal) const
+{
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		const t_real angles[NUM_AXIS_GROUPS] =
+		{
+			m_angles_in[axis_idx],
+			angles_internal[axis_idx],
+			angles_out[axis_idx],
+		};
+
+		for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+		{
+			if(angles[group] < m_limits[axis_idx][group][0])
+				return false;
+			if(angles[group] > m_limits[axis_idx][group][1])
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * check if all given angles violate the same angular limit,
+ * in this case all angles in between violate it as well
+ */
+bool CollisionScene2D::ViolateSameAngularLimit(const t_angles* angles_out,
+	const t_angles* angles_internal, std::size_t num) const
+{
+	if(num == 0)
+		return false;
+
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+		{
+			bool below = true, above = true;
+
+			for(std::size_t idx=0; idx<num; ++idx)
+			{
+				const t_real angle =
+					group == 0 ? m_angles_in[axis_idx] :
+					group == 1 ? angles_internal[idx][axis_idx] :
+					angles_out[idx][axis_idx];
+
+				below = below && (angle < m_limits[axis_idx][group][0]);
+				above = above && (angle > m_limits[axis_idx][group][1]);
+			}
+
+			if(below || above)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * move the axis components into world coordinates for up to one lane-width
+ * of angle pairs, using the same transformation chain as Axis::UpdateTrafos();
+ * unused lanes repeat the last angle pair
+ */
+void CollisionScene2D::TransformComponents(const t_angles* angles_out,
+	const t_angles* angles_internal, std::size_t num, Workspace& ws) const
+{
+	using t_lanes = CollisionLanes;
+	constexpr std::size_t L = t_lanes::NUM;
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+
+	// group trafos per lane
+	t_real cos_angle[NUM_GROUPS][L], sin_angle[NUM_GROUPS][L];
+	t_real trans_x[NUM_GROUPS][L], trans_y[NUM_GROUPS][L];
+
+	for(std::size_t lane=0; lane<L; ++lane)
+	{
+		const std::size_t idx = std::min(lane, num - 1);
+
+		// outgoing trafo of the previous axis
+		t_real prev_angle = 0, prev_x = 0, prev_y = 0;
+
+		for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+		{
+			// axis origin in world coordinates
+			const t_real prev_c = std::cos(prev_angle);
+			const t_real prev_s = std::sin(prev_angle);
+			const t_real pos_x = prev_c*m_pos_x[axis_idx] - prev_s*m_pos_y[axis_idx] + prev_x;
+			const t_real pos_y = prev_s*m_pos_x[axis_idx] + prev_c*m_pos_y[axis_idx] + prev_y;
+
+			const t_real angle_in = prev_angle + m_angles_in[axis_idx];
+			const t_real angles[NUM_AXIS_GROUPS] =
+			{
+				angle_in,
+				angle_in + angles_internal[idx][axis_idx],
+				angle_in + angles_out[idx][axis_idx],
+			};
+
+			for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+			{
+				std::size_t group_idx = axis_idx*NUM_AXIS_GROUPS + group;
+
+				cos_angle[group_idx][lane] = std::cos(angles[group]);
+				sin_angle[group_idx][lane] = std::sin(angles[group]);
+				trans_x[group_idx][lane] = pos_x;
+				trans_y[group_idx][lane] = pos_y;
+			}
+
+			prev_angle = angles[2];
+			prev_x = pos_x;
+			prev_y = pos_y;
+		}
+	}
+
+	for(std::size_t group_idx=0; group_idx<NUM_GROUPS; ++group_idx)
+	{
+		const t_lanes c = t_lanes::load(cos_angle[group_idx]);
+		const t_lanes s = t_lanes::load(sin_angle[group_idx]);
+		const t_lanes tx = t_lanes::load(trans_x[group_idx]);
+		const t_lanes ty = t_lanes::load(trans_y[group_idx]);
+
+		// circles
+		CollisionBounds2D& circle_bounds = ws.circle_bounds[group_idx];
+		circle_bounds.Reset();
+
+		for(std::size_t idx=m_circle_offs[group_idx]; idx<m_circle_offs[group_idx+1]; ++idx)
+		{
+			const t_lanes x = t_lanes::set(m_comp_circles.x[idx]);
+			const t_lanes y = t_lanes::set(m_comp_circles.y[idx]);
+
+			t_real* out_x = ws.circle_x.data() + idx*L;
+			t_real* out_y = ws.circle_y.data() + idx*L;
+			(c*x - s*y + tx).store(out_x);
+			(s*x + c*y + ty).store(out_y);
+
+			for(std::size_t lane=0; lane<L; ++lane)
+				circle_bounds.Extend(out_x[lane], out_y[lane], m_comp_circles.rad[idx] + ws.margins[group_idx]);
+		}
+
+		// boxes
+		CollisionBounds2D& box_bounds = ws.box_bounds[group_idx];
+		box_bounds.Reset();
+
+		for(std::size_t idx=m_box_offs[group_idx]*N; idx<m_box_offs[group_idx+1]*N; ++idx)
+		{
+			const t_lanes x = t_lanes::set(m_comp_boxes.x[idx]);
+			const t_lanes y = t_lanes::set(m_comp_boxes.y[idx]);
+
+			t_real* out_x = ws.box_x.data() + idx*L;
+			t_real* out_y = ws.box_y.data() + idx*L;
+			(c*x - s*y + tx).store(out_x);
+			(s*x + c*y + ty).store(out_y);
+
+			for(std::size_t lane=0; lane<L; ++lane)
+				box_bounds.Extend(out_x[lane], out_y[lane], ws.margins[group_idx]);
+		}
+	}
+}
+
+
+/**
+ * check the circles of two axes' component groups for collision
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CollideCirclesCircles(const Workspace& ws,
+	std::size_t axis1, unsigned groups1,
+	std::size_t axis2, unsigned groups2) const
+{
+	constexpr std::size_t L = t_lanes::NUM;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	for(std::size_t group1=0; group1<NUM_AXIS_GROUPS; ++group1)
+	{
+		if(!(groups1 & (1u << group1)))
+			continue;
+		std::size_t group1_idx = axis1*NUM_AXIS_GROUPS + group1;
+
+		for(std::size_t group2=0; group2<NUM_AXIS_GROUPS; ++group2)
+		{
+			if(!(groups2 & (1u << group2)))
+				continue;
+			std::size_t group2_idx = axis2*NUM_AXIS_GROUPS + group2;
+
+			if(!ws.circle_bounds[group1_idx].Overlaps(ws.circle_bounds[group2_idx]))
+				continue;
+
+			for(std::size_t idx1=m_circle_offs[group1_idx]; idx1<m_circle_offs[group1_idx+1]; ++idx1)
+			{
+				const t_lanes x1 = t_lanes::load(ws.circle_x.data() + idx1*L);
+				const t_lanes y1 = t_lanes::load(ws.circle_y.data() + idx1*L);
+				const t_lanes rad1 = t_lanes::set(m_comp_circles.rad[idx1] + ws.margins[group1_idx]);
+
+				for(std::size_t idx2=m_circle_offs[group2_idx]; idx2<m_circle_offs[group2_idx+1]; ++idx2)
+				{
+					hit = hit | collide_circle_circle(x1, y1, rad1,
+						t_lanes::load(ws.circle_x.data() + idx2*L),
+						t_lanes::load(ws.circle_y.data() + idx2*L),
+						t_lanes::set(m_comp_circles.rad[idx2] + ws.margins[group2_idx]));
+
+					if(t_lanes::all(hit))
+						return hit;
+				}
+			}
+		}
+	}
+
+	return hit;
+}
+
+
+/**
+ * check the circles of one axis against the boxes of another
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CollideCirclesBoxes(const Workspace& ws,
+	std::size_t axis1, unsigned groups1,
+	std::size_t axis2, unsigned groups2) const
+{
+	constexpr std::size_t L = t_lanes::NUM;
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	for(std::size_t group1=0; group1<NUM_AXIS_GROUPS; ++group1)
+	{
+		if(!(groups1 & (1u << group1)))
+			continue;
+		std::size_t group1_idx = axis1*NUM_AXIS_GROUPS + group1;
+
+		for(std::size_t group2=0; group2<NUM_AXIS_GROUPS; ++group2)
+		{
+			if(!(groups2 & (1u << group2)))
+				continue;
+			std::size_t group2_idx = axis2*NUM_AXIS_GROUPS + group2;
+
+			if(!ws.circle_bounds[group1_idx].Overlaps(ws.box_bounds[group2_idx]))
+				continue;
+
+			for(std::size_t idx1=m_circle_offs[group1_idx]; idx1<m_circle_offs[group1_idx+1]; ++idx1)
+			{
+				const t_lanes x = t_lanes::load(ws.circle_x.data() + idx1*L);
+				const t_lanes y = t_lanes::load(ws.circle_y.data() + idx1*L);
+				const t_lanes rad = t_lanes::set(m_comp_circles.rad[idx1] +
+					ws.margins[group1_idx] + ws.margins[group2_idx]);
+
+				for(std::size_t idx2=m_box_offs[group2_idx]; idx2<m_box_offs[group2_idx+1]; ++idx2)
+				{
+					t_lanes box_x[N], box_y[N];
+					load_box(ws.box_x.data(), idx2, box_x);
+					load_box(ws.box_y.data(), idx2, box_y);
+
+					hit = hit | collide_circle_box(x, y, rad, box_x, box_y);
+					if(t_lanes::all(hit))
+						return hit;
+				}
+			}
+		}
+	}
+
+	return hit;
+}
+
+
+/**
+ * check the boxes of two axes' component groups for collision
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CollideBoxesBoxes(const Workspace& ws,
+	std::size_t axis1, unsigned groups1,
+	std::size_t axis2, unsigned groups2) const
+{
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	for(std::size_t group1=0; group1<NUM_AXIS_GROUPS; ++group1)
+	{
+		if(!(groups1 & (1u << group1)))
+			continue;
+		std::size_t group1_idx = axis1*NUM_AXIS_GROUPS + group1;
+
+		for(std::size_t group2=0; group2<NUM_AXIS_GROUPS; ++group2)
+		{
+			if(!(groups2 & (1u << group2)))
+				continue;
+			std::size_t group2_idx = axis2*NUM_AXIS_GROUPS + group2;
+
+			if(!ws.box_bounds[group1_idx].Overlaps(ws.box_bounds[group2_idx]))
+				continue;
+			const t_real margin = ws.margins[group1_idx] + ws.margins[group2_idx];
+
+			for(std::size_t idx1=m_box_offs[group1_idx]; idx1<m_box_offs[group1_idx+1]; ++idx1)
+			{
+				t_lanes box1_x[N], box1_y[N];
+				load_box(ws.box_x.data(), idx1, box1_x);
+				load_box(ws.box_y.data(), idx1, box1_y);
+
+				for(std::size_t idx2=m_box_offs[group2_idx]; idx2<m_box_offs[group2_idx+1]; ++idx2)
+				{
+					t_lanes box2_x[N], box2_y[N];
+					load_box(ws.box_x.data(), idx2, box2_x);
+					load_box(ws.box_y.data(), idx2, box2_y);
+
+					hit = hit | collide_box_box(box1_x, box1_y, box2_x, box2_y, margin);
+					if(t_lanes::all(hit))
+						return hit;
+				}
+			}
+		}
+	}
+
+	return hit;
+}
+
+
+/**
+ * check a wall box against the boxes and circles of an axis
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CollideWallBox(const Workspace& ws,
+	std::size_t wall_idx, std::size_t axis,
+	unsigned box_groups, unsigned circle_groups) const
+{
+	constexpr std::size_t L = t_lanes::NUM;
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	const CollisionBounds2D& wall_bounds = m_wall_box_bounds[wall_idx];
+	t_lanes wall_x[N], wall_y[N];
+	set_box(m_wall_boxes.x.data(), wall_idx, wall_x);
+	set_box(m_wall_boxes.y.data(), wall_idx, wall_y);
+
+	for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+	{
+		std::size_t group_idx = axis*NUM_AXIS_GROUPS + group;
+
+		if((box_groups & (1u << group)) && wall_bounds.Overlaps(ws.box_bounds[group_idx]))
+		{
+			for(std::size_t idx=m_box_offs[group_idx]; idx<m_box_offs[group_idx+1]; ++idx)
+			{
+				t_lanes box_x[N], box_y[N];
+				load_box(ws.box_x.data(), idx, box_x);
+				load_box(ws.box_y.data(), idx, box_y);
+
+				hit = hit | collide_box_box(wall_x, wall_y, box_x, box_y, ws.margins[group_idx]);
+				if(t_lanes::all(hit))
+					return hit;
+			}
+		}
+
+		if((circle_groups & (1u << group)) && wall_bounds.Overlaps(ws.circle_bounds[group_idx]))
+		{
+			for(std::size_t idx=m_circle_offs[group_idx]; idx<m_circle_offs[group_idx+1]; ++idx)
+			{
+				hit = hit | collide_circle_box(
+					t_lanes::load(ws.circle_x.data() + idx*L),
+					t_lanes::load(ws.circle_y.data() + idx*L),
+					t_lanes::set(m_comp_circles.rad[idx] + ws.margins[group_idx]),
+					wall_x, wall_y);
+
+				if(t_lanes::all(hit))
+					return hit;
+			}
+		}
+	}
+
+	return hit;
+}
+
+
+/**
+ * check a wall circle against the circles and boxes of an axis
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CollideWallCircle(const Workspace& ws,
+	std::size_t wall_idx, std::size_t axis,
+	unsigned circle_groups, unsigned box_groups) const
+{
+	constexpr std::size_t L = t_lanes::NUM;
+	constexpr std::size_t N = CollisionBoxes2D::NUM_VERTS;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	CollisionBounds2D wall_bounds;
+	wall_bounds.Extend(m_wall_circles.x[wall_idx],
+		m_wall_circles.y[wall_idx], m_wall_circles.rad[wall_idx]);
+
+	const t_lanes wall_x = t_lanes::set(m_wall_circles.x[wall_idx]);
+	const t_lanes wall_y = t_lanes::set(m_wall_circles.y[wall_idx]);
+	const t_lanes wall_rad = t_lanes::set(m_wall_circles.rad[wall_idx]);
+
+	for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+	{
+		std::size_t group_idx = axis*NUM_AXIS_GROUPS + group;
+
+		if((circle_groups & (1u << group)) && wall_bounds.Overlaps(ws.circle_bounds[group_idx]))
+		{
+			for(std::size_t idx=m_circle_offs[group_idx]; idx<m_circle_offs[group_idx+1]; ++idx)
+			{
+				hit = hit | collide_circle_circle(
+					t_lanes::load(ws.circle_x.data() + idx*L),
+					t_lanes::load(ws.circle_y.data() + idx*L),
+					t_lanes::set(m_comp_circles.rad[idx] + ws.margins[group_idx]),
+					wall_x, wall_y, wall_rad);
+
+				if(t_lanes::all(hit))
+					return hit;
+			}
+		}
+
+		if((box_groups & (1u << group)) && wall_bounds.Overlaps(ws.box_bounds[group_idx]))
+		{
+			for(std::size_t idx=m_box_offs[group_idx]; idx<m_box_offs[group_idx+1]; ++idx)
+			{
+				t_lanes box_x[N], box_y[N];
+				load_box(ws.box_x.data(), idx, box_x);
+				load_box(ws.box_y.data(), idx, box_y);
+
+				hit = hit | collide_circle_box(wall_x, wall_y,
+					wall_rad + t_lanes::set(ws.margins[group_idx]), box_x, box_y);
+				if(t_lanes::all(hit))
+					return hit;
+			}
+		}
+	}
+
+	return hit;
+}
+
+
+/**
+ * check all lanes of the transformed components for collisions with the walls
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CheckWallCollisionLanes(const Workspace& ws) const
+{
+	constexpr std::size_t MONO = 0, SAMPLE = 1, ANA = 2;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	// bounds of the whole instrument
+	CollisionBounds2D instr_bounds;
+	for(std::size_t group_idx=0; group_idx<NUM_GROUPS; ++group_idx)
+	{
+		instr_bounds.Extend(ws.circle_bounds[group_idx]);
+		instr_bounds.Extend(ws.box_bounds[group_idx]);
+	}
+
+	if(!instr_bounds.Overlaps(m_wall_bounds))
+		return hit;
+
+	// wall polygons
+	for(std::size_t wall_idx=0; wall_idx<m_wall_boxes.size(); ++wall_idx)
+	{
+		if(!m_wall_box_bounds[wall_idx].Overlaps(instr_bounds))
+			continue;
+
+		hit = hit | CollideWallBox<t_lanes>(ws, wall_idx, MONO,
+			GROUP_INTERNAL | GROUP_OUT, GROUP_INTERNAL | GROUP_OUT);
+		hit = hit | CollideWallBox<t_lanes>(ws, wall_idx, SAMPLE, GROUP_ALL, GROUP_ALL);
+		hit = hit | CollideWallBox<t_lanes>(ws, wall_idx, ANA, GROUP_ALL, GROUP_ALL);
+
+		if(t_lanes::all(hit))
+			return hit;
+	}
+
+	// wall circles
+	for(std::size_t wall_idx=0; wall_idx<m_wall_circles.size(); ++wall_idx)
+	{
+		hit = hit | CollideWallCircle<t_lanes>(ws, wall_idx, MONO,
+			GROUP_INTERNAL | GROUP_OUT, GROUP_ALL);
+		hit = hit | CollideWallCircle<t_lanes>(ws, wall_idx, SAMPLE, GROUP_ALL, GROUP_ALL);
+		hit = hit | CollideWallCircle<t_lanes>(ws, wall_idx, ANA, GROUP_ALL, GROUP_ALL);
+
+		if(t_lanes::all(hit))
+			return hit;
+	}
+
+	return hit;
+}
+
+
+/**
+ * check all lanes of the transformed components for instrument self-collisions
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CheckSelfCollisionLanes(const Workspace& ws) const
+{
+	constexpr std::size_t MONO = 0, SAMPLE = 1, ANA = 2;
+	typename t_lanes::t_mask hit = t_lanes::none();
+
+	// circle-circle
+	hit = hit | CollideCirclesCircles<t_lanes>(ws, MONO, GROUP_ALL, SAMPLE, GROUP_ALL);
+	hit = hit | CollideCirclesCircles<t_lanes>(ws, SAMPLE, GROUP_ALL, ANA, GROUP_ALL);
+	hit = hit | CollideCirclesCircles<t_lanes>(ws, MONO, GROUP_ALL, ANA, GROUP_ALL);
+	if(t_lanes::all(hit))
+		return hit;
+
+	// circle-polygon
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, MONO, GROUP_ALL, ANA, GROUP_ALL);
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, MONO, GROUP_ALL, SAMPLE, GROUP_ALL);
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, SAMPLE, GROUP_ALL, MONO, GROUP_IN);
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, SAMPLE, GROUP_ALL, ANA, GROUP_ALL);
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, ANA, GROUP_ALL, MONO, GROUP_ALL);
+	hit = hit | CollideCirclesBoxes<t_lanes>(ws, ANA, GROUP_ALL, SAMPLE, GROUP_IN);
+	if(t_lanes::all(hit))
+		return hit;
+
+	// polygon-polygon
+	hit = hit | CollideBoxesBoxes<t_lanes>(ws, ANA, GROUP_ALL, MONO, GROUP_ALL);
+	hit = hit | CollideBoxesBoxes<t_lanes>(ws, SAMPLE, GROUP_ALL, ANA, GROUP_OUT);
+
+	return hit;
+}
+
+
+/**
+ * check all lanes of the transformed components for collisions,
+ * performs the same checks as InstrumentSpace::CheckCollision2D()
+ */
+template<class t_lanes>
+typename t_lanes::t_mask CollisionScene2D::CheckCollisionLanes(const Workspace& ws) const
+{
+	typename t_lanes::t_mask hit = CheckWallCollisionLanes<t_lanes>(ws);
+	if(t_lanes::all(hit))
+		return hit;
+
+	return hit | CheckSelfCollisionLanes<t_lanes>(ws);
+}
+
+
+/**
+ * set the axis angles of the workspace's instrument space for the reference checks
+ */
+InstrumentSpace& CollisionScene2D::SetReferenceAngles(const t_angles& angles_out,
+	const t_angles& angles_internal, Workspace& ws) const
+{
+	Instrument& instr = ws.instrspace->GetInstrument();
+	Axis* axes[NUM_AXES] =
+	{
+		&instr.GetMonochromator(),
+		&instr.GetSample(),
+		&instr.GetAnalyser(),
+	};
+
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		axes[axis_idx]->SetAxisAngleOut(angles_out[axis_idx]);
+		axes[axis_idx]->SetAxisAngleInternal(angles_internal[axis_idx]);
+	}
+
+	return *ws.instrspace;
+}
+
+
+/**
+ * check for collisions at a batch of axis angles
+ */
+void CollisionScene2D::CheckCollision2D(const t_angles* angles_out,
+	const t_angles* angles_internal, std::size_t num,
+	bool* colliding, Workspace& ws) const
+{
+	using t_lanes = CollisionLanes;
+	constexpr std::size_t L = t_lanes::NUM;
+
+	if(m_instrspace)
+	{
+		for(std::size_t idx=0; idx<num; ++idx)
+		{
+			colliding[idx] = SetReferenceAngles(angles_out[idx],
+				angles_internal[idx], ws).CheckCollision2D();
+		}
+		return;
+	}
+
+	for(std::size_t start=0; start<num; start+=L)
+	{
+		const std::size_t num_lanes = std::min(L, num - start);
+
+		TransformComponents(angles_out + start, angles_internal + start, num_lanes, ws);
+		typename t_lanes::t_mask hit = CheckCollisionLanes<t_lanes>(ws);
+
+		for(std::size_t lane=0; lane<num_lanes; ++lane)
+			colliding[start + lane] = t_lanes::get(hit, lane);
+	}
+}
+
+
+/**
+ * check for wall collisions and instrument self-collisions separately
+ * at a batch of axis angles, either output can be null if not needed
+ */
+void CollisionScene2D::CheckCollisionPlanes2D(const t_angles* angles_out,
+	const t_angles* angles_internal, std::size_t num,
+	bool* self_colliding, bool* wall_colliding, Workspace& ws) const
+{
+	using t_lanes = CollisionLanes;
+	constexpr std::size_t L = t_lanes::NUM;
+
+	if(!self_colliding && !wall_colliding)
+		return;
+
+	if(m_instrspace)
+	{
+		for(std::size_t idx=0; idx<num; ++idx)
+		{
+			const InstrumentSpace& instrspace = SetReferenceAngles(
+				angles_out[idx], angles_internal[idx], ws);
+
+			if(self_colliding)
+				self_colliding[idx] = instrspace.CheckCollision2D(false, true);
+			if(wall_colliding)
+				wall_colliding[idx] = instrspace.CheckCollision2D(true, false);
+		}
+		return;
+	}
+
+	for(std::size_t start=0; start<num; start+=L)
+	{
+		const std::size_t num_lanes = std::min(L, num - start);
+
+		TransformComponents(angles_out + start, angles_internal + start, num_lanes, ws);
+
+		if(self_colliding)
+		{
+			typename t_lanes::t_mask hit = CheckSelfCollisionLanes<t_lanes>(ws);
+			for(std::size_t lane=0; lane<num_lanes; ++lane)
+				self_colliding[start + lane] = t_lanes::get(hit, lane);
+		}
+
+		if(wall_colliding)
+		{
+			typename t_lanes::t_mask hit = CheckWallCollisionLanes<t_lanes>(ws);
+			for(std::size_t lane=0; lane<num_lanes; ++lane)
+				wall_colliding[start + lane] = t_lanes::get(hit, lane);
+		}
+	}
+}
+
+
+/**
+ * conservative test if there are no collisions for all axis angles that deviate
+ * by at most the given deltas from the given angles; the components are
+ * enlarged by the maximum distance they can move within these deviations
+ */
+bool CollisionScene2D::IsCollisionFree(const t_angles& angles_out,
+	const t_angles& angles_internal, const t_angles& delta_out,
+	const t_angles& delta_internal, Workspace& ws) const
+{
+	using t_lanes = CollisionLanes;
+
+	// the reference checks can't use enlarged components
+	if(m_instrspace)
+		return false;
+
+	// maximum rotation and displacement of the previous axis' outgoing frame
+	t_real prev_delta_angle = 0, prev_delta_pos = 0;
+
+	for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+	{
+		const t_real delta_pos = prev_delta_pos +
+			std::hypot(m_pos_x[axis_idx], m_pos_y[axis_idx]) * prev_delta_angle;
+
+		const t_real delta_angles[NUM_AXIS_GROUPS] =
+		{
+			prev_delta_angle,
+			prev_delta_angle + std::abs(delta_internal[axis_idx]),
+			prev_delta_angle + std::abs(delta_out[axis_idx]),
+		};
+
+		for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+		{
+			ws.margins[axis_idx*NUM_AXIS_GROUPS + group] =
+				delta_pos + m_reach[axis_idx] * delta_angles[group];
+		}
+
+		prev_delta_angle = delta_angles[2];
+		prev_delta_pos = delta_pos;
+	}
+
+	TransformComponents(&angles_out, &angles_internal, 1, ws);
+	const bool colliding = t_lanes::any(CheckCollisionLanes<t_lanes>(ws));
+
+	ws.margins.fill(0);
+	return !colliding;
+}
+
+
+/**
+ * check for collisions at the given axis angles
+ */
+bool CollisionScene2D::CheckCollision2D(const t_angles& angles_out,
+	const t_angles& angles_internal, Workspace& ws) const
+{
+	bool colliding = false;
+	CheckCollision2D(&angles_out, &angles_internal, 1, &colliding, ws);
+	return colliding;
+}
+// ----------------------------------------------------------------------------
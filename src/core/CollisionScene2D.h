@@ -0,0 +1,357 @@
+/**
+ * compiled 2d collision scene for fast configuration space calculations
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#ifndef __COLLISION_SCENE_2D_H__
+#define __COLLISION_SCENE_2D_H__
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <memory>
+
+#include "types.h"
+#include "Geometry.h"
+
+
+// forward declaration
+class InstrumentSpace;
+
+
+
+// ----------------------------------------------------------------------------
+// flattened 2d primitives
+// ----------------------------------------------------------------------------
+/**
+ * axis-aligned bounding rectangle
+ */
+struct CollisionBounds2D
+{
+	t_real min_x = std::numeric_limits<t_real>::max();
+	t_real min_y = std::numeric_limits<t_real>::max();
+	t_real max_x = std::numeric_limits<t_real>::lowest();
+	t_real max_y = std::numeric_limits<t_real>::lowest();
+
+
+	void Reset()
+	{
+		min_x = min_y = std::numeric_limits<t_real>::max();
+		max_x = max_y = std::numeric_limits<t_real>::lowest();
+	}
+
+
+	void Extend(t_real x, t_real y, t_real rad = 0)
+	{
+		if(x - rad < min_x) min_x = x - rad;
+		if(y - rad < min_y) min_y = y - rad;
+		if(x + rad > max_x) max_x = x + rad;
+		if(y + rad > max_y) max_y = y + rad;
+	}
+
+
+	void Extend(const CollisionBounds2D& bounds)
+	{
+		if(bounds.min_x < min_x) min_x = bounds.min_x;
+		if(bounds.min_y < min_y) min_y = bounds.min_y;
+		if(bounds.max_x > max_x) max_x = bounds.max_x;
+		if(bounds.max_y > max_y) max_y = bounds.max_y;
+	}
+
+
+	bool Overlaps(const CollisionBounds2D& bounds) const
+	{
+		return min_x <= bounds.max_x && max_x >= bounds.min_x &&
+			min_y <= bounds.max_y && max_y >= bounds.min_y;
+	}
+};
+
+
+/**
+ * circles in structure-of-arrays layout
+ */
+struct CollisionCircles2D
+{
+	std::vector<t_real> x{}, y{}, rad{};
+
+
+	std::size_t size() const { return rad.size(); }
+
+	void clear()
+	{
+		x.clear(); y.clear(); rad.clear();
+	}
+
+	void resize(std::size_t num)
+	{
+		x.resize(num); y.resize(num); rad.resize(num);
+	}
+
+	void push_back(t_real _x, t_real _y, t_real _rad)
+	{
+		x.push_back(_x); y.push_back(_y); rad.push_back(_rad);
+	}
+};
+
+
+/**
+ * projected boxes (convex quadrilaterals) in structure-of-arrays layout,
+ * the vertices of box i are stored at the indices [4*i, 4*i + 3]
+ */
+struct CollisionBoxes2D
+{
+	static constexpr std::size_t NUM_VERTS = 4;
+
+	std::vector<t_real> x{}, y{};
+
+
+	std::size_t size() const { return x.size() / NUM_VERTS; }
+
+	void clear()
+	{
+		x.clear(); y.clear();
+	}
+
+	void resize(std::size_t num)
+	{
+		x.resize(num * NUM_VERTS); y.resize(num * NUM_VERTS);
+	}
+};
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// collision scene
+// ----------------------------------------------------------------------------
+/**
+ * immutable snapshot of an instrument space for 2d collision queries:
+ *   - the static walls are flattened into circles and boxes with bounds
+ *   - the axis components are kept in the local frames of their axes,
+ *     a query only has to apply the axis transformations
+ *   - queries are evaluated for several angle pairs at once in simd lanes
+ */
+class CollisionScene2D
+{
+public:
+	// number of instrument axes (monochromator, sample, analyser)
+	static constexpr std::size_t NUM_AXES = 3;
+	// component groups (incoming, internal, outgoing) per axis
+	static constexpr std::size_t NUM_AXIS_GROUPS = 3;
+	static constexpr std::size_t NUM_GROUPS = NUM_AXES * NUM_AXIS_GROUPS;
+
+	using t_angles = std::array<t_real, NUM_AXES>;
+
+
+	/**
+	 * per-thread scratch space holding the transformed axis components,
+	 * the coordinates of all simd lanes are stored next to each other
+	 */
+	class Workspace
+	{
+		friend class CollisionScene2D;
+
+	private:
+		std::vector<t_real> circle_x{}, circle_y{};
+		std::vector<t_real> box_x{}, box_y{};
+
+		// bounds of the groups over all lanes
+		std::array<CollisionBounds2D, NUM_GROUPS> circle_bounds{};
+		std::array<CollisionBounds2D, NUM_GROUPS> box_bounds{};
+
+		// enlargement of the groups' components, see IsCollisionFree()
+		std::array<t_real, NUM_GROUPS> margins{};
+
+		// instrument space copy for the reference checks
+		std::shared_ptr<InstrumentSpace> instrspace{};
+	};
+
+
+public:
+	CollisionScene2D() = default;
+	CollisionScene2D(const InstrumentSpace& instrspace);
+	~CollisionScene2D() = default;
+
+	void Clear();
+	void Compile(const InstrumentSpace& instrspace);
+
+	Workspace CreateWorkspace() const;
+
+	bool CheckAngularLimits(const t_angles& angles_out,
+		const t_angles& angles_internal) const;
+	bool ViolateSameAngularLimit(const t_angles* angles_out,
+		const t_angles* angles_internal, std::size_t num) const;
+
+	bool CheckCollision2D(const t_angles& angles_out,
+		const t_angles& angles_internal, Workspace& ws) const;
+	void CheckCollision2D(const t_angles* angles_out,
+		const t_angles* angles_internal, std::size_t num,
+		bool* colliding, Workspace& ws) const;
+	void CheckCollisionPlanes2D(const t_angles* angles_out,
+		const t_angles* angles_internal, std::size_t num,
+		bool* self_colliding, bool* wall_colliding, Workspace& ws) const;
+
+	bool IsCollisionFree(const t_angles& angles_out, const t_angles& angles_internal,
+		const t_angles& delta_out, const t_angles& delta_internal, Workspace& ws) const;
+
+	std::size_t GetNumWallCircles() const { return m_wall_circles.size(); }
+	std::size_t GetNumWallBoxes() const { return m_wall_boxes.size(); }
+	std::size_t GetNumAxisCircles() const { return m_comp_circles.size(); }
+	std::size_t GetNumAxisBoxes() const { return m_comp_boxes.size(); }
+
+	t_real GetAxisAngleIn(std::size_t axis) const { return m_angles_in[axis]; }
+	t_real GetAxisReach(std::size_t axis) const { return m_reach[axis]; }
+
+	// comparison with another scene for incremental updates
+	bool HasSameAxes(const CollisionScene2D& scene) const;
+	std::vector<CollisionBounds2D> GetChangedWallRegions(const CollisionScene2D& scene) const;
+
+	bool CanReach(const t_angles& angles_out, const std::vector<CollisionBounds2D>& regions) const;
+
+	// are the queries passed on to the instrument space?
+	bool UsesReferenceChecks() const { return m_instrspace != nullptr; }
+
+	/**
+	 * add all data that the queries depend on to a hash
+	 */
+	template<class t_hash>
+	void AddToHash(t_hash& hash) const
+	{
+		for(const std::vector<t_real>* vec : {
+			&m_wall_circles.x, &m_wall_circles.y, &m_wall_circles.rad,
+			&m_wall_boxes.x, &m_wall_boxes.y,
+			&m_comp_circles.x, &m_comp_circles.y, &m_comp_circles.rad,
+			&m_comp_boxes.x, &m_comp_boxes.y })
+		{
+			hash.Add(vec->size());
+			hash.Add(vec->data(), vec->size() * sizeof(t_real));
+		}
+
+		for(std::size_t group_idx=0; group_idx<=NUM_GROUPS; ++group_idx)
+		{
+			hash.Add(m_circle_offs[group_idx]);
+			hash.Add(m_box_offs[group_idx]);
+		}
+
+		for(std::size_t axis_idx=0; axis_idx<NUM_AXES; ++axis_idx)
+		{
+			hash.Add(m_pos_x[axis_idx]);
+			hash.Add(m_pos_y[axis_idx]);
+			hash.Add(m_angles_in[axis_idx]);
+
+			for(std::size_t group=0; group<NUM_AXIS_GROUPS; ++group)
+			{
+				hash.Add(m_limits[axis_idx][group][0]);
+				hash.Add(m_limits[axis_idx][group][1]);
+			}
+		}
+
+		hash.Add(m_poly_intersection_method);
+		hash.Add(m_eps);
+	}
+
+	static std::size_t GetNumLanes();
+	static const char* GetKernelName();
+
+
+protected:
+	void TransformComponents(const t_angles* angles_out,
+		const t_angles* angles_internal, std::size_t num,
+		Workspace& ws) const;
+
+	template<class t_lanes>
+	typename t_lanes::t_mask CheckCollisionLanes(const Workspace& ws) const;
+	template<class t_lanes>
+	typename t_lanes::t_mask CheckWallCollisionLanes(const Workspace& ws) const;
+	template<class t_lanes>
+	typename t_lanes::t_mask CheckSelfCollisionLanes(const Workspace& ws) const;
+
+	template<class t_lanes>
+	typename t_lanes::t_mask CollideCirclesCircles(const Workspace& ws,
+		std::size_t axis1, unsigned groups1,
+		std::size_t axis2, unsigned groups2) const;
+	template<class t_lanes>
+	typename t_lanes::t_mask CollideCirclesBoxes(const Workspace& ws,
+		std::size_t axis1, unsigned groups1,
+		std::size_t axis2, unsigned groups2) const;
+	template<class t_lanes>
+	typename t_lanes::t_mask CollideBoxesBoxes(const Workspace& ws,
+		std::size_t axis1, unsigned groups1,
+		std::size_t axis2, unsigned groups2) const;
+
+	template<class t_lanes>
+	typename t_lanes::t_mask CollideWallBox(const Workspace& ws, std::size_t wall_idx,
+		std::size_t axis, unsigned box_groups, unsigned circle_groups) const;
+	template<class t_lanes>
+	typename t_lanes::t_mask CollideWallCircle(const Workspace& ws, std::size_t wall_idx,
+		std::size_t axis, unsigned circle_groups, unsigned box_groups) const;
+
+	void AddComponent(const std::shared_ptr<Geometry>& comp,
+		CollisionCircles2D& circles, CollisionBoxes2D& boxes) const;
+
+	InstrumentSpace& SetReferenceAngles(const t_angles& angles_out,
+		const t_angles& angles_internal, Workspace& ws) const;
+
+
+public:
+	// bit masks selecting the component groups of an axis
+	static constexpr unsigned GROUP_IN = (1u << 0);
+	static constexpr unsigned GROUP_INTERNAL = (1u << 1);
+	static constexpr unsigned GROUP_OUT = (1u << 2);
+	static constexpr unsigned GROUP_ALL = GROUP_IN | GROUP_INTERNAL | GROUP_OUT;
+
+
+private:
+	// flattened wall geometry in world coordinates
+	CollisionCircles2D m_wall_circles{};
+	CollisionBoxes2D m_wall_boxes{};
+	std::vector<CollisionBounds2D> m_wall_box_bounds{};
+	CollisionBounds2D m_wall_bounds{};
+
+	// axis components in their local frames, sorted by group
+	CollisionCircles2D m_comp_circles{};
+	CollisionBoxes2D m_comp_boxes{};
+	// start indices of the groups, index = axis*NUM_AXIS_GROUPS + group
+	std::array<std::size_t, NUM_GROUPS + 1> m_circle_offs{};
+	std::array<std::size_t, NUM_GROUPS + 1> m_box_offs{};
+
+	// static axis parameters
+	t_angles m_pos_x{}, m_pos_y{};
+	t_angles m_angles_in{};
+
+	// maximum distance of an axis' components from its origin
+	t_angles m_reach{};
+
+	// angular limits [axis][in, internal, out][lower, upper]
+	t_real m_limits[NUM_AXES][NUM_AXIS_GROUPS][2]{};
+
+	// the simd kernels only implement the half-plane polygon test,
+	// the instrument space is kept to do the checks for the other methods
+	int m_poly_intersection_method = 1;
+	t_real m_eps = 0;
+	std::shared_ptr<const InstrumentSpace> m_instrspace{};
+};
+// ----------------------------------------------------------------------------
+
+
+#endif
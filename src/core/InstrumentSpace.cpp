@@ -288,9 +288,10 @@ bool InstrumentSpace::CheckAngularLimits() const
 
 
 /**
- * check for collisions, using a 2d representation of the instrument space
+ * check for collisions, using a 2d representation of the instrument space;
+ * the wall collisions and the instrument self-collisions can be checked separately
  */
-bool InstrumentSpace::CheckCollision2D() const
+bool InstrumentSpace::CheckCollision2D(bool check_walls, bool check_self) const
 {
 	// ------------------------------------------------------------------------
 	// functions to extract object geometries
@@ -700,6 +701,9 @@ bool InstrumentSpace::CheckCollision2D() const
 	// check for collisions with the walls
 	for(const auto& wall : walls)
 	{
+		if(!check_walls)
+			break;
+
 		// wall polygons
 		std::vector<t_vec> wallPoly;
 		get_comp_polys(wall, wallPoly);
@@ -762,6 +766,9 @@ bool InstrumentSpace::CheckCollision2D() const
 
 
 	// check for instrument self-collisions
+	if(!check_self)
+		return false;
+
 	// circle-circle
 	if(check_collision_circle_circle(monoCircles2d, sampleCircles2d))
 		return true;
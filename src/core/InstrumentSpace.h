@@ -68,7 +68,7 @@ public:
 	Instrument& GetInstrument() { return m_instr; }
 
 	bool CheckAngularLimits() const;
-	bool CheckCollision2D() const;
+	bool CheckCollision2D(bool check_walls = true, bool check_self = true) const;
 
 	void DragObject(bool drag_start, const std::string& obj,
 		t_real x_start, t_real y_start, t_real x, t_real y);
@@ -87,6 +87,7 @@ public:
 	t_real GetEpsilon() const { return m_eps; }
 	void SetEpsilon(t_real eps) { m_eps = eps; }
 
+	int GetPolyIntersectionMethod() const { return m_poly_intersection_method; }
 	void SetPolyIntersectionMethod(int method) { m_poly_intersection_method = method; }
 
 
@@ -43,13 +43,14 @@
 // paths builder -- path calculation part
 // ----------------------------------------------------------------------------
 /**
- * get path length, taking into account the motor speeds
+ * get the factors that scale the angles in the path length metric,
+ * these are the inverse motor speeds if they are used
  */
-t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
+t_vec2 PathsBuilder::GetPathLengthScale() const
 {
 	// directly calculate length if motor speeds are not used
 	if(!m_use_motor_speeds)
-		return tl2::norm<t_vec2>(_vec);
+		return tl2::create<t_vec2>({ 1., 1. });
 
 
 	// move analysator instead of monochromator?
@@ -70,9 +71,24 @@ t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
 	// sample 2theta angular speed
 	t_real a4_speed = instr.GetSample().GetAxisAngleOutSpeed();
 
+	return tl2::create<t_vec2>({ t_real(1) / a4_speed, t_real(1) / a2_speed });
+}
+
+
+/**
+ * get path length, taking into account the motor speeds
+ */
+t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
+{
+	// directly calculate length if motor speeds are not used
+	if(!m_use_motor_speeds)
+		return tl2::norm<t_vec2>(_vec);
+
+	const t_vec2 scale = GetPathLengthScale();
+
 	t_vec2 vec = _vec;
-	vec[0] /= a4_speed;
-	vec[1] /= a2_speed;
+	vec[0] *= scale[0];
+	vec[1] *= scale[1];
 
 	return tl2::norm<t_vec2>(vec);
 }
@@ -221,27 +237,26 @@ InstrumentPath PathsBuilder::FindPath(
 		return path;
 
 
-	std::vector<std::size_t> indices_i{};
-	std::vector<std::size_t> indices_f{};
 	std::size_t idx_i = 0;
 	std::size_t idx_f = 0;
 
 	// calculation of closest voronoi vertices using the index tree
 	if(m_voro_results.GetIndexTreeSize())
 	{
-		// check closest voronoi vertices for a possible path from the initial position to a retraction point
+		// check closest voronoi vertices and inner chain vertices for a possible
+		// path from the initial position to a retraction point
 		bool found_i = false;
-		indices_i = m_voro_results.GetClosestVoronoiVertices(
+		const auto points_i = m_voro_results.GetClosestRetractionPoints(
 			path.vec_i, m_num_closest_voronoi_vertices, true);
 
 		// first look for the voronoi vertex where the path keeps the minimum
 		// distance to the walls; second just use first non-colliding path
 		for(bool use_min_dist : {true, false})
 		{
-			for(std::size_t _idx_i : indices_i)
+			for(const auto& [point_i, _idx_i] : points_i)
 			{
 				bool collides = DoesDirectPathCollidePixel(
-					path.vec_i, voro_vertices[_idx_i], use_min_dist);
+					path.vec_i, point_i, use_min_dist);
 
 				if(!collides)
 				{
@@ -263,17 +278,18 @@ InstrumentPath PathsBuilder::FindPath(
 		}
 
 
-		// check closest voronoi vertices for a possible path from the target position to a retraction point
+		// check closest voronoi vertices and inner chain vertices for a possible
+		// path from the target position to a retraction point
 		bool found_f = false;
-		indices_f = m_voro_results.GetClosestVoronoiVertices(
+		const auto points_f = m_voro_results.GetClosestRetractionPoints(
 			path.vec_f, m_num_closest_voronoi_vertices, true);
 
 		for(bool use_min_dist : {true, false})
 		{
-			for(std::size_t _idx_f : indices_f)
+			for(const auto& [point_f, _idx_f] : points_f)
 			{
 				bool collides = DoesDirectPathCollidePixel(
-					path.vec_f, voro_vertices[_idx_f], use_min_dist);
+					path.vec_f, point_f, use_min_dist);
 
 				if(!collides)
 				{
@@ -340,8 +356,21 @@ InstrumentPath PathsBuilder::FindPath(
 
 	using t_weight = typename t_graph::t_weight;
 
+#if TASPATHS_SSSP_IMPL==4
+	const bool use_astar = m_use_astar;
+#else
+	const bool use_astar = false;
+#endif
+
+	// the wall distances of the voronoi vertices are calculated with the path mesh
+	const bool has_wall_dists = m_voro_wall_dists.size() == voro_vertices.size();
+
+	// inner vertices of the contracted voronoi edges
+	const auto& chain_vertices = m_voro_results.GetChainVertices();
+
 	// callback function with which the graph's edge weights can be modified
-	auto weight_func = [this, &voro_graph, &voro_vertices, pathstrategy](
+	auto weight_func = [this, &voro_graph, &voro_vertices, &chain_vertices,
+		has_wall_dists, pathstrategy](
 		std::size_t idx1, std::size_t idx2) -> std::optional<t_weight>
 	{
 		// get original graph edge weight
@@ -361,10 +390,23 @@ InstrumentPath PathsBuilder::FindPath(
 		const t_vec2& vertex2 = voro_vertices[idx2];
 
 		// get the distances to the wall vertices that are closest to the current voronoi vertices
-		t_real dist1 = GetDistToNearestWall(vertex1);
-		t_real dist2 = GetDistToNearestWall(vertex2);
+		t_real dist1 = has_wall_dists ? m_voro_wall_dists[idx1] : GetDistToNearestWall(vertex1);
+		t_real dist2 = has_wall_dists ? m_voro_wall_dists[idx2] : GetDistToNearestWall(vertex2);
 		t_real min_dist = std::min(dist1, dist2);
 
+		// contracted edges: also take the inner vertices of the chain into account
+		if(has_wall_dists)
+		{
+			if(auto iter = m_voro_chain_wall_dists.find(std::make_pair(idx1, idx2));
+				iter != m_voro_chain_wall_dists.end())
+				min_dist = std::min(min_dist, iter->second);
+		}
+		else if(auto iter = chain_vertices.find(std::make_pair(idx1, idx2)); iter != chain_vertices.end())
+		{
+			for(const t_vec2& inner_vertex : iter->second)
+				min_dist = std::min(min_dist, GetDistToNearestWall(inner_vertex));
+		}
+
 		// modify edge weights using the minimum distance to the next wall
 		if(pathstrategy == PathStrategy::PENALISE_WALLS)
 			return weight / min_dist;
@@ -373,11 +415,44 @@ InstrumentPath PathsBuilder::FindPath(
 	};
 
 
+	// the edge weights are at least the pixel distances between their vertices,
+	// divided by the largest wall distance when penalising paths close to walls
+	t_real heuristic_scale = 1;
+	if(pathstrategy == PathStrategy::PENALISE_WALLS)
+	{
+		heuristic_scale = has_wall_dists && m_max_voro_wall_dist > 0
+			? t_real(1) / m_max_voro_wall_dist : t_real(0);
+	}
+
+
+#if TASPATHS_SSSP_IMPL==4
+	// buffers re-used by the shortest path searches, one per thread,
+	// as paths are searched from the mesh calculation and the gui threads
+	thread_local geo::DijkWorkspace<t_weight> sssp_workspace{};
+#endif
+
 	// execute dijkstra's algorithm
-	auto find_shortest_path = [&weight_func, &voro_graph](
+	auto find_shortest_path = [&weight_func, &voro_graph, &voro_vertices,
+		&path, use_astar, heuristic_scale](
 		std::size_t idx_initial, std::size_t idx_final)
 			-> std::pair<bool, std::vector<std::size_t>>
 	{
+	#if TASPATHS_SSSP_IMPL==4
+		// lower bound of the remaining path length for the a* search
+		auto heuristic_func = [&voro_vertices, idx_final, heuristic_scale](std::size_t idx) -> t_weight
+		{
+			return heuristic_scale * tl2::norm<t_vec2>(voro_vertices[idx_final] - voro_vertices[idx]);
+		};
+
+		bool found = geo::dijk_heap(voro_graph, idx_initial, idx_final,
+			sssp_workspace, &weight_func, use_astar ? &heuristic_func : nullptr);
+		path.num_expanded_vertices += sssp_workspace.GetNumSettled();
+
+		if(!found)
+			return std::make_pair(false, std::vector<std::size_t>{});
+
+		return std::make_pair(true, sssp_workspace.GetPath(idx_final));
+	#else
 		const std::string& ident_initial = voro_graph.GetVertexIdent(idx_initial);
 
 		// find shortest path given the above weight function
@@ -423,6 +498,7 @@ InstrumentPath PathsBuilder::FindPath(
 
 		std::reverse(voro_indices.begin(), voro_indices.end());
 		return std::make_pair(ok, voro_indices);
+	#endif
 	};
 
 
@@ -431,7 +507,8 @@ InstrumentPath PathsBuilder::FindPath(
 
 
 #ifdef DEBUG
-	std::cout << "Path ok: " << std::boolalpha << path.ok << std::endl;
+	std::cout << "Path ok: " << std::boolalpha << path.ok
+		<< ", expanded vertices: " << path.num_expanded_vertices << std::endl;
 	for(std::size_t idx=0; idx<path.voronoi_indices.size(); ++idx)
 	{
 		std::size_t voro_idx = path.voronoi_indices[idx];
@@ -1064,9 +1141,9 @@ PathsBuilder::FindClosestBisector(
 	using t_bisector = std::pair<std::size_t, std::size_t>;
 
 	// check if any neighbour bisector connecting to this one is even closer
-	std::vector<std::size_t> neighbour_indices_end =
+	const auto neighbour_indices_end =
 		voro_graph.GetNeighbours(vert_idx_end);
-	std::vector<std::size_t> neighbour_indices_before_end =
+	const auto neighbour_indices_before_end =
 		voro_graph.GetNeighbours(vert_idx_before_end);
 
 	// add all bisector edges connected to the two vertices of the original bisector
@@ -1172,6 +1249,39 @@ PathsBuilder::FindClosestBisector(
  */
 t_real PathsBuilder::GetDistToNearestWall(const t_vec2& vertex) const
 {
+	// look up the closest wall pixels of the pixels around the vertex in the distance field,
+	// the one closest to the exact vertex position is the nearest wall
+	if(m_walldistfield.IsValid())
+	{
+		const t_int max_x = (t_int)m_walldistfield.GetWidth() - 1;
+		const t_int max_y = (t_int)m_walldistfield.GetHeight() - 1;
+		const t_int x0 = std::clamp<t_int>((t_int)std::floor(vertex[0]), 0, max_x);
+		const t_int y0 = std::clamp<t_int>((t_int)std::floor(vertex[1]), 0, max_y);
+		const t_int x1 = std::min<t_int>(x0 + 1, max_x);
+		const t_int y1 = std::min<t_int>(y0 + 1, max_y);
+
+		const t_vec2 angle = PixelToAngle(vertex, false, false);
+		t_real min_dist = std::numeric_limits<t_real>::max();
+
+		for(t_int y : { y0, y1 })
+		{
+			for(t_int x : { x0, x1 })
+			{
+				auto nearest_wall = m_walldistfield.GetClosest(x, y);
+				if(!nearest_wall)
+					continue;
+
+				// get angular distance to wall
+				t_vec2 nearest_wall_angle = PixelToAngle(
+					t_real((*nearest_wall)[0]), t_real((*nearest_wall)[1]), false, false);
+				min_dist = std::min(min_dist, GetPathLength(nearest_wall_angle - angle));
+			}
+		}
+
+		// max if no wall was found
+		return min_dist;
+	}
+
 	// get the wall vertices that are closest to the given vertex
 	if(auto nearest_walls = m_wallsindextree.Query(vertex, 1); nearest_walls.size() >= 1)
 	{
@@ -1391,6 +1501,10 @@ bool PathsBuilder::DoesDirectPathCollidePixel(const t_vec2& vert1, const t_vec2&
 	t_int last_x = -1;
 	t_int last_y = -1;
 
+	// current free run of pixels, [begin, end) in row run_y
+	t_int run_y = -1;
+	t_int run_begin = 0, run_end = 0;
+
 	for(t_real t=0.; t<=1.; t+=m_eps_angular)
 	{
 		t_int x = (t_int)std::lerp(vert1[0], vert2[0], t);
@@ -1404,8 +1518,17 @@ bool PathsBuilder::DoesDirectPathCollidePixel(const t_vec2& vert1, const t_vec2&
 			return true;
 
 		// TODO: test if collision happens inside epsilon-circles, not just for the pixels
-		if(m_img.GetPixel(x, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
-			return true;
+		// only look up pixels outside the current free run
+		if(y != run_y || x < run_begin || x >= run_end)
+		{
+			const auto run = m_img.GetRun(x, y);
+			if(run.value != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
+				return true;
+
+			run_y = y;
+			run_begin = (t_int)run.begin;
+			run_end = (t_int)run.end;
+		}
 
 		if(use_min_dist)
 		{
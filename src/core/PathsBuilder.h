@@ -32,6 +32,7 @@
 #define __GEO_PATHS_BUILDER_H__
 
 #include <vector>
+#include <array>
 #include <memory>
 #include <iostream>
 
@@ -50,6 +51,10 @@
 #include "PathsExporter.h"
 
 
+// forward declaration
+class CollisionScene2D;
+
+
 struct InstrumentPath
 {
 	// path mesh ok?
@@ -72,6 +77,10 @@ struct InstrumentPath
 	// position parameter along the entry and exit path
 	t_real param_i = 0;
 	t_real param_f = 1;
+
+	// number of vertices expanded by the shortest path searches
+	// (only counted by the heap-based searches)
+	std::size_t num_expanded_vertices = 0;
 };
 
 
@@ -98,6 +107,9 @@ enum class ContourBackend
 
 	// opencv
 	OCV,
+
+	// sub-pixel contour lines using marching squares
+	MARCHING_SQUARES,
 };
 
 
@@ -111,6 +123,12 @@ enum class VoronoiBackend
 
 	// cgal
 	CGAL,
+
+	// boost.polygon in overlapping tiles, calculated in parallel
+	BOOST_TILED,
+
+	// medial axis of the configuration space image, no line segments needed
+	RASTER,
 };
 
 
@@ -119,6 +137,17 @@ enum class VoronoiBackend
 #define PATHSBUILDER_PIXEL_VALUE_COLLISION        0xff
 #define PATHSBUILDER_PIXEL_VALUE_NOCOLLISION      0x00
 
+// configuration space image, the three pixel values above fit into two bits
+using t_configspace_image = geo::PackedImage<std::uint8_t, 2>;
+
+// bits of the separate configuration space planes
+#define PATHSBUILDER_PLANE_FORBIDDEN_ANGLE        (1 << 0)
+#define PATHSBUILDER_PLANE_SELF_COLLISION         (1 << 1)
+#define PATHSBUILDER_PLANE_WALL_COLLISION         (1 << 2)
+#define PATHSBUILDER_PLANE_ALL                    (PATHSBUILDER_PLANE_FORBIDDEN_ANGLE | \
+                                                   PATHSBUILDER_PLANE_SELF_COLLISION | \
+                                                   PATHSBUILDER_PLANE_WALL_COLLISION)
+
 
 class PathsBuilder
 {
@@ -126,6 +155,12 @@ public:
 	// contour point
 	using t_contourvec = t_vec2_int;
 
+	// wall contour point, with sub-pixel precision
+	using t_wallcontourvec = t_vec2;
+
+	// label of a connected region in the contour image
+	using t_regionlabel = geo::RegionLabels::t_label;
+
 	// line segment
 	using t_line = std::pair<t_vec2, t_vec2>;
 
@@ -139,14 +174,28 @@ public:
 		std::size_t, std::size_t>;
 
 	// voronoi graph
-	using t_graph = geo::AdjacencyList<t_real>;
+	using t_graph = geo::CsrGraph<t_real>;
+	//using t_graph = geo::AdjacencyList<t_real>;
 	//using t_graph = geo::AdjacencyMatrix<t_real>;
 
+	// values assigned to voronoi edges, independent of the edge direction
+	using t_voronoiedge_values =
+		std::unordered_map<std::pair<std::size_t, std::size_t>, t_real,
+		geo::t_bisector_hash<std::pair<std::size_t, std::size_t>>,
+		geo::t_bisector_equ<std::pair<std::size_t, std::size_t>>>;
+
 
 protected:
 	// get path length, taking into account the motor speeds
 	t_real GetPathLength(const t_vec2& vec) const;
 
+	// get the factors that scale the angles in the path length metric
+	t_vec2 GetPathLengthScale() const;
+
+	// get the axis angles of the collision scene corresponding to a pixel position
+	void GetSceneAngles(t_real img_x, t_real img_y, t_real a6, bool kf_fixed,
+		std::array<t_real, 3>& angles_out, std::array<t_real, 3>& angles_internal) const;
+
 	// check if a position (in angular coordinates) leads to a collision
 	bool DoesPositionCollide(const t_vec2& pos, bool deg = false) const;
 
@@ -201,8 +250,10 @@ public:
 	void Clear();
 
 	// get contour image and wall contour points
-	const geo::Image<std::uint8_t>& GetImage() const { return m_img; }
-	const std::vector<std::vector<t_contourvec>>& GetWallContours(bool full = false) const;
+	const t_configspace_image& GetImage() const { return m_img; }
+	const geo::Image<std::uint8_t>& GetImagePlanes() const { return m_img_planes; }
+	const std::vector<std::vector<t_wallcontourvec>>& GetWallContours(bool full = false) const;
+	const geo::RegionLabels& GetRegionLabels() const { return m_regionlabels; }
 
 	// get voronoi vertices, edges and graph
 	const geo::VoronoiLinesResults<t_vec2, t_line, t_graph>& GetVoronoiResults() const
@@ -217,7 +268,10 @@ public:
 	bool CalculateConfigSpace(t_real da2, t_real da4,
 		t_real starta2 = 0., t_real enda2 = tl2::pi<t_real>,
 		t_real starta4 = 0., t_real enda4 = tl2::pi<t_real>);
+	void ComposeConfigSpaceImage();
 	bool CalculateWallsIndexTree();
+	bool CalculateWallDistanceField();
+	void CalculateVoronoiWallDistances();
 	bool CalculateWallContours(bool simplify = true, bool convex_split = false,
 		ContourBackend backend = ContourBackend::INTERNAL);
 	bool CalculateLineSegments(bool use_region_function = false);
@@ -225,6 +279,13 @@ public:
 		VoronoiBackend backend = VoronoiBackend::BOOST,
 		bool use_region_function = true);
 
+	// path mesh cache
+	std::string GetPathMeshHash(t_real da2, t_real da4,
+		t_real starta2, t_real enda2, t_real starta4, t_real enda4,
+		const std::vector<int>& options = {}) const;
+	bool SavePathMesh(const std::string& filename, const std::string& hash) const;
+	bool LoadPathMesh(const std::string& filename, const std::string& hash);
+
 	// number of line segment groups -- for scripting interface
 	std::size_t GetNumberOfLineSegmentRegions() const { return m_linegroups.size(); }
 
@@ -267,6 +328,9 @@ public:
 	t_real GetVoronoiEdgeEpsilon() const { return m_voroedge_eps; }
 	void SetVoronoiEdgeEpsilon(t_real eps) { m_voroedge_eps = eps; }
 
+	t_real GetMedialAxisMinDist() const { return m_medial_axis_mindist; }
+	void SetMedialAxisMinDist(t_real dist) { m_medial_axis_mindist = dist; }
+
 	t_real GetSubdivisionLength() const { return m_subdiv_len; }
 	void SetSubdivisionLength(t_real len) { m_subdiv_len = len; }
 
@@ -276,6 +340,9 @@ public:
 	void SetRemoveBisectorsBelowMinWallDist(bool b) { m_remove_bisectors_below_min_wall_dist = b; }
 	bool GetRemoveBisectorsBelowMinWallDist() const { return m_remove_bisectors_below_min_wall_dist; }
 
+	void SetContractVoronoiChains(bool b) { m_contract_voronoi_chains = b; }
+	bool GetContractVoronoiChains() const { return m_contract_voronoi_chains; }
+
 	unsigned int GetMaxNumThreads() const { return m_maxnum_threads; }
 	void SetMaxNumThreads(unsigned int n) { m_maxnum_threads = n; }
 
@@ -292,7 +359,34 @@ public:
 	void SetVerifyPath(bool verify) { m_verifypath = verify; }
 
 	bool GetUseMotorSpeeds() const { return m_use_motor_speeds; }
-	void SetUseMotorSpeeds(bool b) { m_use_motor_speeds = b; }
+	void SetUseMotorSpeeds(bool b);
+
+	bool GetUseAStar() const { return m_use_astar; }
+	void SetUseAStar(bool b) { m_use_astar = b; }
+
+	bool GetUseAdaptiveConfigSpace() const { return m_configspace_adaptive; }
+	void SetUseAdaptiveConfigSpace(bool b) { m_configspace_adaptive = b; }
+
+	std::size_t GetConfigSpaceTileSize() const { return m_configspace_tile_size; }
+	void SetConfigSpaceTileSize(std::size_t size) { m_configspace_tile_size = size; }
+
+	std::size_t GetConfigSpaceSafetyMargin() const { return m_configspace_margin; }
+	void SetConfigSpaceSafetyMargin(std::size_t margin) { m_configspace_margin = margin; }
+
+	bool GetUseIncrementalConfigSpace() const { return m_configspace_incremental; }
+	void SetUseIncrementalConfigSpace(bool b) { m_configspace_incremental = b; }
+
+	bool GetUseWallDistanceField() const { return m_use_walldistfield; }
+	void SetUseWallDistanceField(bool b);
+
+	unsigned int GetNumContourBisections() const { return m_contour_bisections; }
+	void SetNumContourBisections(unsigned int num) { m_contour_bisections = num; }
+
+	t_real GetContourDecimation() const { return m_contour_decimation; }
+	void SetContourDecimation(t_real angle) { m_contour_decimation = angle; }
+
+	// number of pixels evaluated in the last configuration space calculation
+	std::size_t GetNumEvaluatedConfigSpacePixels() const { return m_configspace_evaluated; }
 	// ------------------------------------------------------------------------
 
 	// ------------------------------------------------------------------------
@@ -356,10 +450,19 @@ private:
 	// index tree for wall positions (in pixel coordinates)
 	geo::ClosestPixelTreeResults<t_contourvec> m_wallsindextree{};
 
+	// closest wall pixel for every pixel in the path length metric,
+	// replaces the index tree if used; the metric is fixed when the field is built
+	geo::ClosestPixelField<t_contourvec> m_walldistfield{};
+
 	// wall contours in configuration space
-	geo::Image<std::uint8_t> m_img{};
-	std::vector<std::vector<t_contourvec>> m_wallcontours = {};
-	std::vector<std::vector<t_contourvec>> m_fullwallcontours = {};
+	t_configspace_image m_img{};
+	// forbidden angle, self-collision and wall collision planes
+	geo::Image<std::uint8_t> m_img_planes{};
+	std::vector<std::vector<t_wallcontourvec>> m_wallcontours = {};
+	std::vector<std::vector<t_wallcontourvec>> m_fullwallcontours = {};
+
+	// connected obstacle and free regions of the contour image
+	geo::RegionLabels m_regionlabels{};
 
 	// line segments (in pixel coordinates) and groups from the wall contours
 	std::vector<t_line> m_lines{};
@@ -372,10 +475,16 @@ private:
 	// voronoi vertices, edges and graph from the line segments
 	geo::VoronoiLinesResults<t_vec2, t_line, t_graph> m_voro_results{};
 
+	// wall distances of the voronoi vertices and their maximum,
+	// and the minimum wall distances of the inner vertices of contracted edges
+	std::vector<t_real> m_voro_wall_dists{};
+	t_voronoiedge_values m_voro_chain_wall_dists{};
+	t_real m_max_voro_wall_dist = 0;
+
 	// general, angular and voronoi edge calculation epsilon
 	t_real m_eps = 1e-3;
 	t_real m_eps_angular = 1e-3;
-	t_real m_voroedge_eps = 1e-2;
+	t_real m_voroedge_eps = 0.1;
 
 	// minimum distance to keep from the walls (e.g. for direct path calculation)
 	t_real m_min_angular_dist_to_walls = 5. / t_real(180.) * tl2::pi<t_real>;
@@ -383,9 +492,20 @@ private:
 	// remove bisectors that are below the minimum distance given above
 	bool m_remove_bisectors_below_min_wall_dist = true;
 
+	// contract the unbranched chains of the voronoi graph into single edges
+	bool m_contract_voronoi_chains = false;
+
+	// minimum distance (in pixels) between the walls of the same obstacle
+	// for a medial axis bisector in the raster voronoi backend
+	t_real m_medial_axis_mindist = 4.;
+
 	// minimum distance to consider "staircase artefacts"
 	t_real m_simplify_mindist = 3.;
 
+	// maximum angular deviation of the decimated contours, the decimation
+	// only grows the obstacles and keeps them from touching their neighbours
+	t_real m_contour_decimation = 0.25 / t_real(180.) * tl2::pi<t_real>;
+
 	bool m_use_motor_speeds = true;
 
 	// line segment length for subdivisions
@@ -403,8 +523,39 @@ private:
 	// check the generated path for collisions
 	bool m_verifypath = true;
 
+	// direct the shortest path search towards the target vertex
+	bool m_use_astar = true;
+
 	// maximum number of threads to use in calculations
 	unsigned int m_maxnum_threads = 4;
+
+	// look up the closest walls in a distance field instead of the index tree
+	bool m_use_walldistfield = true;
+
+	// number of bisection steps to refine the sub-pixel contour points
+	unsigned int m_contour_bisections = 4;
+
+	// sample the configuration space adaptively in quadtree tiles
+	bool m_configspace_adaptive = false;
+
+	// size of the initial tiles for adaptive sampling (in pixels)
+	std::size_t m_configspace_tile_size = 32;
+
+	// additional pixels around a tile that have to agree for it to be uniform
+	std::size_t m_configspace_margin = 1;
+
+	// number of evaluated pixels in the last configuration space calculation
+	std::size_t m_configspace_evaluated = 0;
+
+	// keep the self-collision plane and only recalculate the pixels affected by
+	// changed walls if the instrument axes and the angular ranges are the same
+	// as in the last calculation
+	bool m_configspace_incremental = true;
+
+	// instrument scene and parameters of the last configuration space calculation,
+	// the self-collision plane stays valid as long as the axes are unchanged
+	std::shared_ptr<const CollisionScene2D> m_configspace_scene{};
+	std::array<t_real, 8> m_configspace_params{};
 };
 
 #endif
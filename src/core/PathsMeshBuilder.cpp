@@ -29,12 +29,18 @@
  */
 
 #include "PathsBuilder.h"
+#include "CollisionScene2D.h"
 
 #include <iostream>
+#include <sstream>
 #include <thread>
 #include <future>
+#include <functional>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <algorithm>
+#include <unordered_map>
 
 #include "mingw_hacks.h"
 #include <boost/asio.hpp>
@@ -67,14 +73,20 @@ void PathsBuilder::Clear()
 {
 	//m_img.Clear();
 	m_wallsindextree.Clear();
+	m_walldistfield.Clear();
 
 	m_wallcontours.clear();
 	m_fullwallcontours.clear();
 
+	m_regionlabels.Clear();
+
 	m_lines.clear();
 	m_linegroups.clear();
 
 	m_voro_results.Clear();
+	m_voro_wall_dists.clear();
+	m_voro_chain_wall_dists.clear();
+	m_max_voro_wall_dist = 0;
 }
 
 
@@ -202,7 +214,7 @@ t_vec2 PathsBuilder::AngleToPixel(t_real angle_x, t_real angle_y, bool deg, bool
 /**
  * returns the full or the simplified wall contours
  */
-const std::vector<std::vector<PathsBuilder::t_contourvec>>&
+const std::vector<std::vector<PathsBuilder::t_wallcontourvec>>&
 PathsBuilder::GetWallContours(bool full) const
 {
 	if(full)
@@ -249,7 +261,8 @@ bool PathsBuilder::CalculateConfigSpace(
 	m_monoScatteringRange[1] = enda2;
 
 	std::ostringstream ostrmsg;
-	ostrmsg << "Calculating configuration space in " << m_maxnum_threads << " threads...";
+	ostrmsg << "Calculating configuration space in " << m_maxnum_threads << " threads"
+		<< " (" << CollisionScene2D::GetKernelName() << " kernel)...";
 	(*m_sigProgress)(CalculationState::STEP_STARTED, 0, ostrmsg.str());
 
 	const t_real *sensesCCW = nullptr;
@@ -298,64 +311,384 @@ bool PathsBuilder::CalculateConfigSpace(
 	std::size_t img_w = (enda4-starta4) / da4;
 	std::size_t img_h = (enda2-starta2) / da2;
 	//std::cout << "Image size: " << img_w << " x " << img_h << "." << std::endl;
-	m_img.Init(img_w, img_h);
 
-	// create thread pool
-	asio::thread_pool pool(m_maxnum_threads);
+	// flatten the instrument space for the collision queries
+	std::shared_ptr<const CollisionScene2D> sceneptr =
+		std::make_shared<const CollisionScene2D>(*m_instrspace);
+	const CollisionScene2D& scene = *sceneptr;
+
+	// can the previous planes be reused, i.e. have only walls or limits changed?
+	const std::array<t_real, 8> params{{ da2, da4, starta2, enda2, starta4, enda4,
+		a6, kf_fixed ? t_real(1) : t_real(0) }};
+	const bool incremental = m_configspace_incremental && m_configspace_scene &&
+		params == m_configspace_params &&
+		m_img_planes.GetWidth() == img_w && m_img_planes.GetHeight() == img_h &&
+		scene.HasSameAxes(*m_configspace_scene);
+
+	// regions of the changed walls (old and new positions)
+	std::vector<CollisionBounds2D> changed_regions;
+	if(incremental)
+	{
+		changed_regions = scene.GetChangedWallRegions(*m_configspace_scene);
+	}
+	else
+	{
+		m_img_planes.Init(img_w, img_h);
+		m_img.Init(img_w, img_h);
+	}
 
-	std::vector<t_taskptr> tasks;
-	tasks.reserve(img_h);
+	// the planes are only valid again once the calculation has finished
+	m_configspace_scene = nullptr;
 
+	using t_pixel = std::pair<std::size_t, std::size_t>;
 
-	// set image pixels
-	std::atomic<std::size_t> num_pixels = 0;
-	for(std::size_t img_row=0; img_row<img_h; ++img_row)
+	// get the axis angles corresponding to a pixel
+	auto get_angles = [this, a6, kf_fixed](std::size_t img_col, std::size_t img_row)
+		-> std::pair<CollisionScene2D::t_angles, CollisionScene2D::t_angles>
+	{
+		CollisionScene2D::t_angles angle_out, angle_internal;
+		GetSceneAngles(img_col, img_row, a6, kf_fixed, angle_out, angle_internal);
+		return std::make_pair(angle_out, angle_internal);
+	};
+
+	// calculate the given planes of the given pixels; if the angular limits
+	// are calculated as well, the collisions of forbidden pixels are not checked
+	// and their collision planes stay empty
+	auto calc_pixels = [&scene, &get_angles](
+		const std::vector<t_pixel>& pixels,
+		std::vector<std::uint8_t>& values,
+		CollisionScene2D::Workspace& ws, std::uint8_t planes)
+	{
+		values.assign(pixels.size(), 0);
+
+		const bool calc_self = (planes & PATHSBUILDER_PLANE_SELF_COLLISION) != 0;
+		const bool calc_wall = (planes & PATHSBUILDER_PLANE_WALL_COLLISION) != 0;
+
+		// angles and indices of the pixels whose collisions have to be checked
+		std::vector<CollisionScene2D::t_angles> angles_out, angles_internal;
+		std::vector<std::size_t> indices;
+		angles_out.reserve(pixels.size());
+		angles_internal.reserve(pixels.size());
+		indices.reserve(pixels.size());
+
+		for(std::size_t idx=0; idx<pixels.size(); ++idx)
+		{
+			const auto [img_col, img_row] = pixels[idx];
+			const auto [angle_out, angle_internal] = get_angles(img_col, img_row);
+
+			if((planes & PATHSBUILDER_PLANE_FORBIDDEN_ANGLE) &&
+				!scene.CheckAngularLimits(angle_out, angle_internal))
+			{
+				values[idx] |= PATHSBUILDER_PLANE_FORBIDDEN_ANGLE;
+				continue;
+			}
+
+			if(!calc_self && !calc_wall)
+				continue;
+
+			angles_out.push_back(angle_out);
+			angles_internal.push_back(angle_internal);
+			indices.push_back(idx);
+		}
+
+		if(indices.size() == 0)
+			return;
+
+		// check the pixels in one batch
+		std::unique_ptr<bool[]> self_colliding, wall_colliding;
+		if(calc_self)
+			self_colliding = std::make_unique<bool[]>(indices.size());
+		if(calc_wall)
+			wall_colliding = std::make_unique<bool[]>(indices.size());
+
+		scene.CheckCollisionPlanes2D(angles_out.data(), angles_internal.data(),
+			indices.size(), self_colliding.get(), wall_colliding.get(), ws);
+
+		for(std::size_t idx=0; idx<indices.size(); ++idx)
+		{
+			if(calc_self && self_colliding[idx])
+				values[indices[idx]] |= PATHSBUILDER_PLANE_SELF_COLLISION;
+			if(calc_wall && wall_colliding[idx])
+				values[indices[idx]] |= PATHSBUILDER_PLANE_WALL_COLLISION;
+		}
+	};
+
+	// replace the given planes of the given pixels
+	auto set_pixels = [this](const std::vector<t_pixel>& pixels,
+		const std::vector<std::uint8_t>& values, std::uint8_t planes)
+	{
+		for(std::size_t idx=0; idx<pixels.size(); ++idx)
+		{
+			const auto [img_col, img_row] = pixels[idx];
+			std::uint8_t val = m_img_planes.GetPixel(img_col, img_row);
+			m_img_planes.SetPixel(img_col, img_row, std::uint8_t((val & ~planes) | values[idx]));
+		}
+	};
+
+
+	// calculate the pixels of an image row; in incremental mode the cached
+	// self-collision plane is kept, the cheap angular limits plane is recalculated
+	// and the wall plane only for pixels where the instrument can reach a changed wall;
+	// pixels that were forbidden before have no cached collision planes
+	auto calc_row = [this, &scene, &calc_pixels, &set_pixels, &get_angles,
+		&changed_regions, incremental, img_w](std::size_t img_row,
+		std::atomic<std::size_t>& num_pixels, std::atomic<std::size_t>& num_evaluated)
+	{
+		CollisionScene2D::Workspace ws = scene.CreateWorkspace();
+
+		std::vector<t_pixel> pixels;
+		std::vector<std::uint8_t> values;
+		pixels.reserve(img_w);
+
+		for(std::size_t img_col=0; img_col<img_w; ++img_col)
+			pixels.emplace_back(img_col, img_row);
+
+		if(incremental)
+		{
+			calc_pixels(pixels, values, ws, PATHSBUILDER_PLANE_FORBIDDEN_ANGLE);
+
+			std::vector<t_pixel> wall_pixels, new_pixels;
+			for(std::size_t idx=0; idx<pixels.size(); ++idx)
+			{
+				const std::size_t img_col = pixels[idx].first;
+				const std::uint8_t val = m_img_planes.GetPixel(img_col, img_row);
+
+				// forbidden pixels don't need any collision planes
+				if(values[idx] & PATHSBUILDER_PLANE_FORBIDDEN_ANGLE)
+				{
+					m_img_planes.SetPixel(img_col, img_row, PATHSBUILDER_PLANE_FORBIDDEN_ANGLE);
+					continue;
+				}
+
+				m_img_planes.SetPixel(img_col, img_row,
+					std::uint8_t(val & ~PATHSBUILDER_PLANE_FORBIDDEN_ANGLE));
+
+				if(val & PATHSBUILDER_PLANE_FORBIDDEN_ANGLE)
+					new_pixels.push_back(pixels[idx]);
+				else if(scene.CanReach(get_angles(img_col, img_row).first, changed_regions))
+					wall_pixels.push_back(pixels[idx]);
+			}
+
+			calc_pixels(new_pixels, values, ws,
+				PATHSBUILDER_PLANE_SELF_COLLISION | PATHSBUILDER_PLANE_WALL_COLLISION);
+			set_pixels(new_pixels, values,
+				PATHSBUILDER_PLANE_SELF_COLLISION | PATHSBUILDER_PLANE_WALL_COLLISION);
+
+			calc_pixels(wall_pixels, values, ws, PATHSBUILDER_PLANE_WALL_COLLISION);
+			set_pixels(wall_pixels, values, PATHSBUILDER_PLANE_WALL_COLLISION);
+
+			num_evaluated += new_pixels.size() + wall_pixels.size();
+		}
+		else
+		{
+			calc_pixels(pixels, values, ws, PATHSBUILDER_PLANE_ALL);
+			set_pixels(pixels, values, PATHSBUILDER_PLANE_ALL);
+
+			num_evaluated += pixels.size();
+		}
+
+		num_pixels += img_w;
+	};
+
+
+	// conservative geometric test that all pixels of a tile have the given value,
+	// the samples on the tile's border alone could miss small obstacles:
+	// a free tile has to stay free of collisions with all components enlarged by
+	// the maximum distance they can move within the tile, a forbidden tile has to
+	// violate the same angular limit in all of its corners, and tiles with
+	// collisions are always subdivided
+	auto check_tile = [&scene, &get_angles](
+		std::size_t x0, std::size_t y0, std::size_t x1, std::size_t y1,
+		std::uint8_t value, CollisionScene2D::Workspace& ws) -> bool
 	{
-		auto task = [this, img_w, img_row, a6, kf_fixed, &num_pixels]()
+		// the angles are linear in the pixel coordinates, so the corners bound them
+		CollisionScene2D::t_angles corners_out[4], corners_internal[4];
+		for(std::size_t corner=0; corner<4; ++corner)
+		{
+			std::tie(corners_out[corner], corners_internal[corner]) = get_angles(
+				corner % 2 ? x1 - 1 : x0, corner / 2 ? y1 - 1 : y0);
+		}
+
+		if(value & PATHSBUILDER_PLANE_FORBIDDEN_ANGLE)
+			return scene.ViolateSameAngularLimit(corners_out, corners_internal, 4);
+		if(value != 0)
+			return false;
+
+		// angles at the centre of the tile and their maximum deviations
+		CollisionScene2D::t_angles centre_out{}, centre_internal{};
+		CollisionScene2D::t_angles delta_out{}, delta_internal{};
+
+		for(std::size_t axis=0; axis<CollisionScene2D::NUM_AXES; ++axis)
 		{
-			InstrumentSpace instrspace_cpy = *this->m_instrspace;
+			centre_out[axis] = 0.5 * (corners_out[0][axis] + corners_out[3][axis]);
+			centre_internal[axis] = 0.5 * (corners_internal[0][axis] + corners_internal[3][axis]);
 
-			for(std::size_t img_col=0; img_col<img_w; ++img_col)
+			for(std::size_t corner=0; corner<4; ++corner)
 			{
-				t_vec2 angle = PixelToAngle(img_col, img_row, false, true);
-				t_real a4 = angle[0];
-				t_real a2 = angle[1];
-				t_real a3 = a4 * 0.5;
+				delta_out[axis] = std::max(delta_out[axis],
+					std::abs(corners_out[corner][axis] - centre_out[axis]));
+				delta_internal[axis] = std::max(delta_internal[axis],
+					std::abs(corners_internal[corner][axis] - centre_internal[axis]));
+			}
+		}
+
+		return scene.IsCollisionFree(centre_out, centre_internal, delta_out, delta_internal, ws);
+	};
+
+
+	// calculate the pixels of an image tile using adaptive quadtree sampling:
+	// the borders of a (sub-)tile and the pixels within the safety margin
+	// around it are evaluated first, uniform tiles are filled directly if
+	// the geometric test above confirms them, all others are subdivided
+	auto calc_tile = [this, &scene, &calc_pixels, &check_tile, img_w, img_h](
+		std::size_t x0, std::size_t y0, std::size_t x1, std::size_t y1,
+		std::atomic<std::size_t>& num_pixels, std::atomic<std::size_t>& num_evaluated)
+	{
+		const std::size_t margin = m_configspace_margin;
+		CollisionScene2D::Workspace ws = scene.CreateWorkspace();
+
+		// pixel values of the tile and its margin, -1: not yet evaluated
+		const std::size_t cache_x0 = x0 >= margin ? x0 - margin : 0;
+		const std::size_t cache_y0 = y0 >= margin ? y0 - margin : 0;
+		const std::size_t cache_x1 = std::min(x1 + margin, img_w);
+		const std::size_t cache_y1 = std::min(y1 + margin, img_h);
+		const std::size_t cache_w = cache_x1 - cache_x0;
+		std::vector<std::int16_t> cache(cache_w * (cache_y1 - cache_y0), -1);
+
+		auto cached = [&cache, cache_x0, cache_y0, cache_w](
+			std::size_t x, std::size_t y) -> std::int16_t&
+		{
+			return cache[(y - cache_y0)*cache_w + (x - cache_x0)];
+		};
+
+		std::vector<t_pixel> pixels;
+		std::vector<std::uint8_t> values;
+		std::vector<std::array<std::size_t, 4>> rects{{ x0, y0, x1, y1 }};
 
-				Instrument& instr = instrspace_cpy.GetInstrument();
+		while(rects.size())
+		{
+			const auto [rx0, ry0, rx1, ry1] = rects.back();
+			rects.pop_back();
 
-				// set scattering angles (a2 and a6 are flipped in case kf is not fixed)
-				instr.GetMonochromator().SetAxisAngleOut(kf_fixed ? a2 : a6);
-				instr.GetSample().SetAxisAngleOut(a4);
-				instr.GetAnalyser().SetAxisAngleOut(kf_fixed ? a6 : a2);
+			// evaluate all pixels of small tiles
+			const bool small = (rx1 - rx0 <= 2 || ry1 - ry0 <= 2);
 
-				// set crystal angles (a1 and a5 are flipped in case kf is not fixed)
-				instr.GetMonochromator().SetAxisAngleInternal(kf_fixed ? 0.5*a2 : 0.5*a6);
-				instr.GetSample().SetAxisAngleInternal(a3);
-				instr.GetAnalyser().SetAxisAngleInternal(kf_fixed ? 0.5*a6 : 0.5*a2);
+			// border and margin band of the tile
+			const std::size_t bx0 = rx0 >= margin ? rx0 - margin : 0;
+			const std::size_t by0 = ry0 >= margin ? ry0 - margin : 0;
+			const std::size_t bx1 = std::min(rx1 + margin, img_w);
+			const std::size_t by1 = std::min(ry1 + margin, img_h);
 
-				// set image value
-				bool angle_ok = instrspace_cpy.CheckAngularLimits();
+			auto is_band = [small, rx0, ry0, rx1, ry1](std::size_t x, std::size_t y) -> bool
+			{
+				return small || x <= rx0 || x + 1 >= rx1 || y <= ry0 || y + 1 >= ry1;
+			};
 
-				if(!angle_ok)
+			pixels.clear();
+			for(std::size_t y=by0; y<by1; ++y)
+			{
+				for(std::size_t x=bx0; x<bx1; ++x)
 				{
-					m_img.SetPixel(img_col, img_row, PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE);
+					if(is_band(x, y) && cached(x, y) < 0)
+						pixels.emplace_back(x, y);
 				}
-				else
+			}
+
+			calc_pixels(pixels, values, ws, PATHSBUILDER_PLANE_ALL);
+			for(std::size_t idx=0; idx<pixels.size(); ++idx)
+				cached(pixels[idx].first, pixels[idx].second) = values[idx];
+			num_evaluated += pixels.size();
+
+			if(small)
+				continue;
+
+			// do all samples agree?
+			const std::int16_t value = cached(bx0, by0);
+			bool uniform = true;
+			for(std::size_t y=by0; y<by1 && uniform; ++y)
+			{
+				for(std::size_t x=bx0; x<bx1; ++x)
 				{
-					bool colliding = instrspace_cpy.CheckCollision2D();
-					m_img.SetPixel(img_col, img_row, colliding ? PATHSBUILDER_PIXEL_VALUE_COLLISION : PATHSBUILDER_PIXEL_VALUE_NOCOLLISION);
+					if(is_band(x, y) && cached(x, y) != value)
+					{
+						uniform = false;
+						break;
+					}
 				}
+			}
 
-				++num_pixels;
+			if(uniform && check_tile(rx0, ry0, rx1, ry1, std::uint8_t(value), ws))
+			{
+				for(std::size_t y=ry0+1; y<ry1-1; ++y)
+					for(std::size_t x=rx0+1; x<rx1-1; ++x)
+						cached(x, y) = value;
+				continue;
 			}
 
-			//std::cout << a2/tl2::pi<t_real>*180. << " finished" << std::endl;
-		};
+			// subdivide the tile
+			const std::size_t xm = rx0 + (rx1 - rx0)/2;
+			const std::size_t ym = ry0 + (ry1 - ry0)/2;
+			rects.push_back({ rx0, ry0, xm, ym });
+			rects.push_back({ xm, ry0, rx1, ym });
+			rects.push_back({ rx0, ym, xm, ry1 });
+			rects.push_back({ xm, ym, rx1, ry1 });
+		}
 
-		t_taskptr taskptr = std::make_shared<t_task>(task);
-		tasks.push_back(taskptr);
-		asio::post(pool, [taskptr]() { (*taskptr)(); });
+		for(std::size_t y=y0; y<y1; ++y)
+			for(std::size_t x=x0; x<x1; ++x)
+				m_img_planes.SetPixel(x, y, std::uint8_t(cached(x, y)));
+
+		num_pixels += (x1 - x0) * (y1 - y0);
+	};
+
+
+	// create thread pool
+	asio::thread_pool pool(m_maxnum_threads);
+
+	std::vector<t_taskptr> tasks;
+
+	// set image pixels
+	std::atomic<std::size_t> num_pixels = 0;
+	std::atomic<std::size_t> num_evaluated = 0;
+
+	if(m_configspace_adaptive && !incremental)
+	{
+		const std::size_t tile_size = std::max<std::size_t>(m_configspace_tile_size, 4);
+		tasks.reserve((img_w/tile_size + 1) * (img_h/tile_size + 1));
+
+		for(std::size_t y0=0; y0<img_h; y0+=tile_size)
+		{
+			for(std::size_t x0=0; x0<img_w; x0+=tile_size)
+			{
+				std::size_t x1 = std::min(x0 + tile_size, img_w);
+				std::size_t y1 = std::min(y0 + tile_size, img_h);
+
+				auto task = [&calc_tile, x0, y0, x1, y1, &num_pixels, &num_evaluated]()
+				{
+					calc_tile(x0, y0, x1, y1, num_pixels, num_evaluated);
+				};
+
+				t_taskptr taskptr = std::make_shared<t_task>(task);
+				tasks.push_back(taskptr);
+				asio::post(pool, [taskptr]() { (*taskptr)(); });
+			}
+		}
+	}
+	else
+	{
+		tasks.reserve(img_h);
+
+		for(std::size_t img_row=0; img_row<img_h; ++img_row)
+		{
+			auto task = [&calc_row, img_row, &num_pixels, &num_evaluated]()
+			{
+				calc_row(img_row, num_pixels, num_evaluated);
+			};
+
+			t_taskptr taskptr = std::make_shared<t_task>(task);
+			tasks.push_back(taskptr);
+			asio::post(pool, [taskptr]() { (*taskptr)(); });
+		}
 	}
 
 
@@ -381,23 +714,282 @@ bool PathsBuilder::CalculateConfigSpace(
 	}
 
 	pool.join();
+
+	// keep the scene for further incremental updates
+	const bool ok = (num_pixels == img_h*img_w);
+	if(ok)
+	{
+		m_configspace_scene = sceneptr;
+		m_configspace_params = params;
+
+		ComposeConfigSpaceImage();
+	}
+
+	// report the number of pixels for which collisions were actually checked
+	m_configspace_evaluated = num_evaluated;
+	if(incremental)
+		ostrmsg << " Updated " << changed_regions.size() << " changed wall regions.";
+	ostrmsg << " Evaluated " << num_evaluated << " of " << img_h*img_w << " pixels.";
 	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, ostrmsg.str());
 
 	//std::cout << "pixels total: " << img_h*img_w << ", calculated: " << num_pixels << std::endl;
-	return num_pixels == img_h*img_w;
+	return ok;
 }
 
 
 /**
- * save all wall position in an index tree for more efficient position lookup
+ * get the axis angles of the collision scene corresponding to a pixel position
+ */
+void PathsBuilder::GetSceneAngles(t_real img_x, t_real img_y, t_real a6, bool kf_fixed,
+	std::array<t_real, 3>& angles_out, std::array<t_real, 3>& angles_internal) const
+{
+	t_vec2 angle = PixelToAngle(img_x, img_y, false, true);
+	t_real a4 = angle[0];
+	t_real a2 = angle[1];
+	t_real a3 = a4 * 0.5;
+
+	// scattering angles (a2 and a6 are flipped in case kf is not fixed)
+	angles_out = CollisionScene2D::t_angles
+	{
+		kf_fixed ? a2 : a6,
+		a4,
+		kf_fixed ? a6 : a2,
+	};
+
+	// crystal angles (a1 and a5 are flipped in case kf is not fixed)
+	angles_internal = CollisionScene2D::t_angles
+	{
+		kf_fixed ? 0.5*a2 : 0.5*a6,
+		a3,
+		kf_fixed ? 0.5*a6 : 0.5*a2,
+	};
+}
+
+
+/**
+ * compose the configuration space image from its planes
+ */
+void PathsBuilder::ComposeConfigSpaceImage()
+{
+	const std::size_t img_w = m_img_planes.GetWidth();
+	const std::size_t img_h = m_img_planes.GetHeight();
+
+	if(m_img.GetWidth() != img_w || m_img.GetHeight() != img_h)
+		m_img.Init(img_w, img_h);
+
+	for(std::size_t y=0; y<img_h; ++y)
+	{
+		for(std::size_t x=0; x<img_w; ++x)
+		{
+			std::uint8_t planes = m_img_planes.GetPixel(x, y);
+			std::uint8_t val = PATHSBUILDER_PIXEL_VALUE_NOCOLLISION;
+
+			if(planes & PATHSBUILDER_PLANE_FORBIDDEN_ANGLE)
+				val = PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE;
+			else if(planes & (PATHSBUILDER_PLANE_SELF_COLLISION | PATHSBUILDER_PLANE_WALL_COLLISION))
+				val = PATHSBUILDER_PIXEL_VALUE_COLLISION;
+
+			m_img.SetPixel(x, y, val);
+		}
+	}
+
+	// run-length encode the rows for span-wise lookups
+	m_img.CreateRuns();
+}
+
+
+/**
+ * save all wall position in an index tree for more efficient position lookup,
+ * or calculate the distance field to the walls if it is used instead
  */
 bool PathsBuilder::CalculateWallsIndexTree()
 {
-	m_wallsindextree = geo::build_closest_pixel_tree<t_contourvec, decltype(m_img)>(m_img);
+	if(m_use_walldistfield)
+	{
+		m_wallsindextree.Clear();
+		if(!CalculateWallDistanceField())
+			return false;
+	}
+	else
+	{
+		m_walldistfield.Clear();
+		m_wallsindextree = geo::build_closest_pixel_tree<t_contourvec, decltype(m_img)>(m_img);
+	}
+
+	// the wall distances of an existing path mesh have to be updated
+	CalculateVoronoiWallDistances();
 	return true;
 }
 
 
+/**
+ * calculate the closest wall pixel for every pixel of the configuration space
+ */
+bool PathsBuilder::CalculateWallDistanceField()
+{
+	std::string message{"Calculating wall distance field..."};
+	(*m_sigProgress)(CalculationState::STEP_STARTED, 0, message);
+
+	const std::size_t img_w = m_img.GetWidth();
+	const std::size_t img_h = m_img.GetHeight();
+	m_walldistfield.Init(img_w, img_h);
+
+	// measure the distances to the walls in the same metric as the path lengths,
+	// i.e. in units of motor time if the motor speeds are used
+	if(img_w && img_h)
+	{
+		const t_vec2 scale = GetPathLengthScale();
+		const t_real angle_per_pixel_x = std::abs(
+			m_sampleScatteringRange[1] - m_sampleScatteringRange[0]) / t_real(img_w);
+		const t_real angle_per_pixel_y = std::abs(
+			m_monoScatteringRange[1] - m_monoScatteringRange[0]) / t_real(img_h);
+
+		m_walldistfield.SetScale(angle_per_pixel_x * scale[0], angle_per_pixel_y * scale[1]);
+	}
+
+	// same wall pixels as in the index tree: those next to an obstacle pixel
+	auto is_wall = [this](std::size_t x, std::size_t y) -> bool
+	{
+		return x > 0 && m_img.GetPixel(x - 1, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION;
+	};
+
+	// number of columns or rows per task
+	constexpr std::size_t block_size = 64;
+
+	asio::thread_pool pool(m_maxnum_threads);
+	std::vector<t_taskptr> tasks;
+	tasks.reserve(img_w/block_size + img_h/block_size + 2);
+
+	// runs the tasks and waits for them
+	auto run_tasks = [this, &pool, &tasks, &message](t_real progress_start, t_real progress_end) -> bool
+	{
+		const std::size_t num_tasks = tasks.size();
+
+		for(std::size_t taskidx=0; taskidx<num_tasks; ++taskidx)
+		{
+			t_real progress = std::lerp(progress_start, progress_end,
+				t_real(taskidx) / t_real(num_tasks));
+			if(!(*m_sigProgress)(CalculationState::RUNNING, progress, message))
+			{
+				pool.stop();
+				return false;
+			}
+
+			tasks[taskidx]->get_future().get();
+		}
+
+		tasks.clear();
+		return true;
+	};
+
+	// first pass: closest wall pixel in the same column
+	for(std::size_t x0=0; x0<img_w; x0+=block_size)
+	{
+		auto task = [this, x0, &is_wall]()
+		{
+			m_walldistfield.CalcColumns(x0, x0 + block_size, is_wall);
+		};
+
+		t_taskptr taskptr = std::make_shared<t_task>(task);
+		tasks.push_back(taskptr);
+		asio::post(pool, [taskptr]() { (*taskptr)(); });
+	}
+
+	bool ok = run_tasks(0., 0.5);
+
+	// second pass: closest wall pixel in the whole image
+	for(std::size_t y0=0; ok && y0<img_h; y0+=block_size)
+	{
+		auto task = [this, y0, img_h]()
+		{
+			for(std::size_t y=y0; y<std::min(y0 + block_size, img_h); ++y)
+				m_walldistfield.CalcRow(y);
+		};
+
+		t_taskptr taskptr = std::make_shared<t_task>(task);
+		tasks.push_back(taskptr);
+		asio::post(pool, [taskptr]() { (*taskptr)(); });
+	}
+
+	if(ok)
+		ok = run_tasks(0.5, 1.);
+	pool.join();
+
+	if(!ok)
+	{
+		m_walldistfield.Clear();
+		(*m_sigProgress)(CalculationState::FAILED, 1, message);
+		return false;
+	}
+
+	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, message);
+	return true;
+}
+
+
+/**
+ * get the wall distances of the voronoi vertices and of the contracted edges,
+ * they are needed for every path search that penalises paths close to walls
+ */
+void PathsBuilder::CalculateVoronoiWallDistances()
+{
+	m_voro_wall_dists.clear();
+	m_voro_chain_wall_dists.clear();
+	m_max_voro_wall_dist = 0;
+
+	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+	m_voro_wall_dists.reserve(voro_vertices.size());
+
+	for(const t_vec2& vertex : voro_vertices)
+	{
+		m_voro_wall_dists.push_back(GetDistToNearestWall(vertex));
+		m_max_voro_wall_dist = std::max(m_max_voro_wall_dist, m_voro_wall_dists.back());
+	}
+
+	for(const auto& [indices, inner_vertices] : m_voro_results.GetChainVertices())
+	{
+		t_real min_dist = std::numeric_limits<t_real>::max();
+		for(const t_vec2& inner_vertex : inner_vertices)
+			min_dist = std::min(min_dist, GetDistToNearestWall(inner_vertex));
+
+		m_voro_chain_wall_dists.emplace(std::make_pair(indices, min_dist));
+	}
+}
+
+
+/**
+ * switch the path length metric between angles and motor times,
+ * the wall distance field of an existing mesh is rebuilt in the new metric
+ */
+void PathsBuilder::SetUseMotorSpeeds(bool b)
+{
+	if(m_use_motor_speeds == b)
+		return;
+
+	m_use_motor_speeds = b;
+	if(m_use_walldistfield && m_img.GetWidth() && m_img.GetHeight())
+		CalculateWallDistanceField();
+
+	// the wall distances are given in the path length metric
+	CalculateVoronoiWallDistances();
+}
+
+
+/**
+ * switch between the wall distance field and the index tree,
+ * the wall lookup structure of an existing mesh is rebuilt
+ */
+void PathsBuilder::SetUseWallDistanceField(bool b)
+{
+	if(m_use_walldistfield == b)
+		return;
+
+	m_use_walldistfield = b;
+	if(m_img.GetWidth() && m_img.GetHeight())
+		CalculateWallsIndexTree();
+}
+
+
 /**
  * calculate the contour lines of the obstacle regions
  */
@@ -406,16 +998,65 @@ bool PathsBuilder::CalculateWallContours(bool simplify, bool convex_split, Conto
 	std::string message{"Calculating obstacle contours..."};
 	(*m_sigProgress)(CalculationState::STEP_STARTED, 0, message);
 
+	const auto time_start = std::chrono::steady_clock::now();
+
+	// convert pixel contours
+	auto set_pixel_contours = [this](const std::vector<std::vector<t_contourvec>>& contours)
+	{
+		m_wallcontours.clear();
+		m_wallcontours.reserve(contours.size());
+
+		for(const auto& contour : contours)
+		{
+			std::vector<t_wallcontourvec> wallcontour;
+			wallcontour.reserve(contour.size());
+
+			for(const t_contourvec& vec : contour)
+				wallcontour.emplace_back(tl2::create<t_wallcontourvec>({ t_real(vec[0]), t_real(vec[1]) }));
+			m_wallcontours.emplace_back(std::move(wallcontour));
+		}
+	};
+
 	if(backend == ContourBackend::INTERNAL)
 	{
-		m_wallcontours = geo::trace_contour<t_contourvec, decltype(m_img)>(m_img);
+		set_pixel_contours(geo::trace_contour_parallel<t_contourvec, decltype(m_img)>(
+			m_img, m_maxnum_threads));
 	}
 #ifdef USE_OCV
 	else if(backend == ContourBackend::OCV)
 	{
-		m_wallcontours = geo::trace_contour_ocv<t_contourvec, decltype(m_img)>(m_img);
+		set_pixel_contours(geo::trace_contour_ocv<t_contourvec, decltype(m_img)>(m_img));
 	}
 #endif
+	else if(backend == ContourBackend::MARCHING_SQUARES)
+	{
+		if(m_configspace_scene && m_contour_bisections > 0)
+		{
+			// refine the contour points between the pixels using the collision scene
+			// from the configuration space calculation
+			const CollisionScene2D& scene = *m_configspace_scene;
+			CollisionScene2D::Workspace ws = scene.CreateWorkspace();
+			const t_real a6 = m_configspace_params[6];
+			const bool kf_fixed = m_configspace_params[7] != 0;
+
+			auto is_colliding = [this, &scene, &ws, a6, kf_fixed](const t_wallcontourvec& pix) -> bool
+			{
+				CollisionScene2D::t_angles angles_out, angles_internal;
+				GetSceneAngles(pix[0], pix[1], a6, kf_fixed, angles_out, angles_internal);
+
+				return !scene.CheckAngularLimits(angles_out, angles_internal) ||
+					scene.CheckCollision2D(angles_out, angles_internal, ws);
+			};
+
+			m_wallcontours = geo::trace_isolines<t_wallcontourvec, decltype(m_img)>(
+				m_img, is_colliding, m_contour_bisections);
+		}
+		else
+		{
+			// crossing points at the midpoints between the pixels
+			m_wallcontours = geo::trace_isolines<t_wallcontourvec, decltype(m_img)>(m_img);
+		}
+	}
 	else
 	{
 		// invalid backend selected
@@ -426,11 +1067,58 @@ bool PathsBuilder::CalculateWallContours(bool simplify, bool convex_split, Conto
 	m_fullwallcontours = m_wallcontours;
 	(*m_sigProgress)(CalculationState::RUNNING, 0.33, message);
 
+	auto time_traced = std::chrono::steady_clock::now();
+	auto time_simplified = time_traced;
+	auto time_decimated = time_traced;
+	auto time_split = time_traced;
+
+	// the contours are independent, run a function for each of them in the thread pool,
+	// the results are written to the contours' indices to keep them in order
+	auto for_each_contour = [this, &message](const std::function<void(std::size_t)>& func,
+		t_real progress_start, t_real progress_end) -> bool
+	{
+		const std::size_t num_contours = m_wallcontours.size();
+
+		asio::thread_pool pool(m_maxnum_threads);
+		std::vector<t_taskptr> tasks;
+		tasks.reserve(num_contours);
+
+		for(std::size_t contouridx=0; contouridx<num_contours; ++contouridx)
+		{
+			t_taskptr taskptr = std::make_shared<t_task>([&func, contouridx]()
+			{
+				func(contouridx);
+			});
+
+			tasks.push_back(taskptr);
+			asio::post(pool, [taskptr]() { (*taskptr)(); });
+		}
+
+		for(std::size_t taskidx=0; taskidx<num_contours; ++taskidx)
+		{
+			t_real progress = std::lerp(progress_start, progress_end,
+				t_real(taskidx) / t_real(num_contours));
+			if(!(*m_sigProgress)(CalculationState::RUNNING, progress, message))
+			{
+				pool.stop();
+				pool.join();
+				return false;
+			}
+
+			tasks[taskidx]->get_future().get();
+		}
+
+		pool.join();
+		return true;
+	};
+
 	if(simplify)
 	{
 		// iterate and simplify contour groups
-		for(auto& contour : m_wallcontours)
+		bool ok = for_each_contour([this](std::size_t contouridx)
 		{
+			auto& contour = m_wallcontours[contouridx];
+
 			// replace contour with its convex hull
 			//std::vector<t_vec2> contour_real = tl2::convert<t_vec2, t_contourvec, std::vector>(contour);
 			//auto [hull_verts, hull_lines, hull_indices]
@@ -438,8 +1126,61 @@ bool PathsBuilder::CalculateWallContours(bool simplify, bool convex_split, Conto
 			//contour = tl2::convert<t_contourvec, t_vec2, std::vector>(hull_verts);
 
 			// simplify hull contour
-			geo::simplify_contour<t_contourvec, t_real>(contour, m_simplify_mindist, m_eps_angular, m_eps);
+			geo::simplify_contour<t_wallcontourvec, t_real>(contour, m_simplify_mindist, m_eps_angular, m_eps);
+		}, 0.33, 0.5);
+
+		if(!ok)
+		{
+			(*m_sigProgress)(CalculationState::FAILED, 0.5, message);
+			return false;
 		}
+
+		time_simplified = time_decimated = time_split = std::chrono::steady_clock::now();
+	}
+
+	(*m_sigProgress)(CalculationState::RUNNING, 0.5, message);
+
+	// number of contour vertices (and line segments) before and after the decimation
+	std::size_t num_verts = 0, num_removed_verts = 0;
+	for(const auto& contour : m_wallcontours)
+		num_verts += contour.size();
+
+	// the opencv contours don't necessarily have the obstacles on their left side
+	if(m_contour_decimation > 0. && backend != ContourBackend::OCV &&
+		m_img.GetWidth() && m_img.GetHeight())
+	{
+		// measure the deviations of the decimated contours in angular units
+		const t_real angle_per_pixel_x = std::abs(
+			m_sampleScatteringRange[1] - m_sampleScatteringRange[0]) / t_real(m_img.GetWidth());
+		const t_real angle_per_pixel_y = std::abs(
+			m_monoScatteringRange[1] - m_monoScatteringRange[0]) / t_real(m_img.GetHeight());
+
+		// segments of the original contours, the decimated contours
+		// are kept apart from the neighbouring ones
+		const geo::ContourSegmentGrid<t_wallcontourvec, t_real> segment_grid(
+			m_wallcontours, angle_per_pixel_x, angle_per_pixel_y);
+
+		// the obstacles are on the left side of the contours, only let them grow
+		std::vector<std::size_t> removed_verts(m_wallcontours.size(), 0);
+
+		bool ok = for_each_contour([this, &removed_verts, &segment_grid,
+			angle_per_pixel_x, angle_per_pixel_y](std::size_t contouridx)
+		{
+			removed_verts[contouridx] = geo::decimate_contour<t_wallcontourvec, t_real>(
+				m_wallcontours[contouridx], m_contour_decimation, true,
+				angle_per_pixel_x, angle_per_pixel_y, m_eps, &segment_grid, contouridx);
+		}, 0.5, 0.66);
+
+		if(!ok)
+		{
+			(*m_sigProgress)(CalculationState::FAILED, 0.66, message);
+			return false;
+		}
+
+		for(std::size_t removed : removed_verts)
+			num_removed_verts += removed;
+
+		time_decimated = time_split = std::chrono::steady_clock::now();
 	}
 
 	(*m_sigProgress)(CalculationState::RUNNING, 0.66, message);
@@ -447,32 +1188,65 @@ bool PathsBuilder::CalculateWallContours(bool simplify, bool convex_split, Conto
 	if(convex_split)
 	{
 		// convex split
-		std::vector<std::vector<t_contourvec>> splitcontours;
-		splitcontours.reserve(m_wallcontours.size()*2);
+		std::vector<std::vector<std::vector<t_wallcontourvec>>> splitcontours(m_wallcontours.size());
 
-		for(auto& contour : m_wallcontours)
+		bool ok = for_each_contour([this, &splitcontours](std::size_t contouridx)
 		{
+			const auto& contour = m_wallcontours[contouridx];
+
 			//std::reverse(contour.begin(), contour.end());
-			auto splitcontour = geo::convex_split<t_contourvec, t_real>(contour, m_eps);
+			splitcontours[contouridx] = geo::convex_split<t_wallcontourvec, t_real>(contour, m_eps);
+		}, 0.66, 1.);
+
+		if(!ok)
+		{
+			(*m_sigProgress)(CalculationState::FAILED, 1, message);
+			return false;
+		}
+
+		std::vector<std::vector<t_wallcontourvec>> allsplitcontours;
+		allsplitcontours.reserve(m_wallcontours.size()*2);
+
+		for(std::size_t contouridx=0; contouridx<m_wallcontours.size(); ++contouridx)
+		{
+			auto& splitcontour = splitcontours[contouridx];
 			if(splitcontour.size())
 			{
 				for(auto&& poly : splitcontour)
 				{
 					//std::reverse(poly.begin(), poly.end());
-					splitcontours.emplace_back(std::move(poly));
+					allsplitcontours.emplace_back(std::move(poly));
 				}
 			}
 			else
 			{
 				// no split, use original contour
-				splitcontours.push_back(contour);
+				allsplitcontours.emplace_back(std::move(m_wallcontours[contouridx]));
 			}
 		}
 
-		m_wallcontours = std::move(splitcontours);
+		m_wallcontours = std::move(allsplitcontours);
+		time_split = std::chrono::steady_clock::now();
 	}
 
-	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, message);
+	// report the timings of the stages
+	using t_ms = std::chrono::duration<t_real, std::milli>;
+	std::ostringstream ostrmsg;
+	ostrmsg << message << " Found " << m_wallcontours.size() << " contours in "
+		<< m_maxnum_threads << " threads, tracing: "
+		<< t_ms(time_traced - time_start).count() << " ms, simplification: "
+		<< t_ms(time_simplified - time_traced).count() << " ms, decimation: "
+		<< t_ms(time_decimated - time_simplified).count() << " ms, convex split: "
+		<< t_ms(time_split - time_decimated).count() << " ms.";
+
+	if(num_verts)
+	{
+		ostrmsg << " Decimation removed " << num_removed_verts << " of " << num_verts
+			<< " line segments (" << t_real(100) * t_real(num_removed_verts) / t_real(num_verts)
+			<< " %).";
+	}
+
+	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, ostrmsg.str());
 	return true;
 }
 
@@ -523,91 +1297,198 @@ bool PathsBuilder::CalculateLineSegments(bool use_region_function)
 		return point_outside_regions;
 	};
 
-	std::size_t totalverts = 0;
-	for(const auto& contour : m_wallcontours)
-		totalverts += contour.size();
+	const auto time_start = std::chrono::steady_clock::now();
+	const std::size_t num_contours = m_wallcontours.size();
+
+	// each contour vertex starts a line segment, get the line indices of the contours
+	std::vector<std::size_t> contour_offs(num_contours + 1, 0);
+	for(std::size_t contouridx = 0; contouridx < num_contours; ++contouridx)
+		contour_offs[contouridx + 1] = contour_offs[contouridx] + m_wallcontours[contouridx].size();
+
+	m_lines.resize(contour_offs[num_contours]);
+	m_linegroups.reserve(num_contours);
 
-	m_lines.reserve(totalverts/2 + 1);
-	m_linegroups.reserve(m_wallcontours.size());
+	// points outside the contours, signed contour areas and enclosed obstacle regions
+	std::vector<t_vec2> points_outside(num_contours);
+	std::vector<t_real> contour_areas(num_contours, 0);
+	std::vector<t_regionlabel> contour_labels(num_contours, geo::RegionLabels::NO_LABEL);
 
 	if(!use_region_function)
 	{
-		m_points_outside_regions.reserve(m_wallcontours.size());
-		m_inverted_regions.reserve(m_wallcontours.size());
+		m_points_outside_regions.reserve(num_contours);
+		m_inverted_regions.reserve(num_contours);
+
+		// label the connected obstacle and free regions
+		m_regionlabels.Calculate(m_img, m_maxnum_threads);
+	}
+	else
+	{
+		m_regionlabels.Clear();
 	}
 
+	// get the label of the obstacle region a contour vertex belongs to,
+	// sub-pixel vertices lie between an obstacle pixel and a free one
+	auto get_obstacle_label = [this](const t_wallcontourvec& vec) -> t_regionlabel
+	{
+		const t_real x_floor = std::floor(vec[0] + m_eps);
+		const t_real y_floor = std::floor(vec[1] + m_eps);
+		const t_real x_ceil = std::ceil(vec[0] - m_eps);
+		const t_real y_ceil = std::ceil(vec[1] - m_eps);
+
+		for(t_real y : { y_floor, y_ceil })
+		for(t_real x : { x_floor, x_ceil })
+		{
+			if(x < 0 || y < 0)
+				continue;
+
+			t_regionlabel label = m_regionlabels.GetLabel(std::size_t(x), std::size_t(y));
+			if(label != geo::RegionLabels::NO_LABEL && m_regionlabels.IsSet(label))
+				return label;
+		}
+
+		return geo::RegionLabels::NO_LABEL;
+	};
+
 	// contour vertices
-	std::size_t linectr = 0;
-	for(std::size_t contouridx = 0; contouridx < m_wallcontours.size(); ++contouridx)
+	auto calc_contour_lines = [this, use_region_function, &contour_offs,
+		&points_outside, &contour_areas, &contour_labels,
+		&find_point_outside_regions, &get_obstacle_label](std::size_t contouridx)
 	{
 		const auto& contour = m_wallcontours[contouridx];
-		std::size_t groupstart = linectr;
-		t_contourvec contour_mean = tl2::zero<t_vec2>(2);
+		std::size_t linectr = contour_offs[contouridx];
+		t_real area = 0;
 
 		for(std::size_t vert1 = 0; vert1 < contour.size(); ++vert1)
 		{
 			std::size_t vert2 = (vert1 + 1) % contour.size();
 
-			const t_contourvec& vec1 = contour[vert1];
-			const t_contourvec& vec2 = contour[vert2];
-			contour_mean += vec1;
+			const t_wallcontourvec& vec1 = contour[vert1];
+			const t_wallcontourvec& vec2 = contour[vert2];
+			area += vec1[0]*vec2[1] - vec2[0]*vec1[1];
+
+			m_lines[linectr++] = std::make_pair(vec1, vec2);
+		}
+
+		if(use_region_function)
+			return;
 
-			t_vec2 linevec1 = vec1;
-			t_vec2 linevec2 = vec2;
+		if(!contour.size())
+		{
+			points_outside[contouridx] = find_point_outside_regions(0, 0, true);
+			return;
+		}
 
-			m_lines.emplace_back(
-				std::make_pair(std::move(linevec1), std::move(linevec2)));
+		points_outside[contouridx] = find_point_outside_regions(
+			std::size_t(std::max<t_real>(contour[0][0], 0)),
+			std::size_t(std::max<t_real>(contour[0][1], 0)), true);
 
-			++linectr;
+		contour_areas[contouridx] = area * 0.5;
+		for(const t_wallcontourvec& vec : contour)
+		{
+			contour_labels[contouridx] = get_obstacle_label(vec);
+			if(contour_labels[contouridx] != geo::RegionLabels::NO_LABEL)
+				break;
 		}
+	};
 
-		contour_mean /= contour.size();
+	// number of contours per task
+	constexpr std::size_t block_size = 16;
 
-		// move a point on the contour in the direction of the contour mean
-		// to get a point inside the contour
-		//t_contourvec inside_contour = contour[0] + (contour_mean-contour[0]) / 8;
+	asio::thread_pool pool(m_maxnum_threads);
+	std::vector<t_taskptr> tasks;
+	tasks.reserve(num_contours/block_size + 1);
 
-		// find a point outside the contour by moving a pixel away from the minimum vertex
-		auto [contour_min, contour_max] = tl2::minmax(contour);
-		t_contourvec outside_contour = contour_min;
-		for(int i = 0; i < 2; ++i)
-			outside_contour[i] -= 1;
+	for(std::size_t contour0 = 0; contour0 < num_contours; contour0 += block_size)
+	{
+		auto task = [contour0, num_contours, &calc_contour_lines]()
+		{
+			for(std::size_t contouridx = contour0;
+				contouridx < std::min(contour0 + block_size, num_contours);
+				++contouridx)
+				calc_contour_lines(contouridx);
+		};
 
-		// mark line group start and end index
-		std::size_t groupend = linectr;
+		t_taskptr taskptr = std::make_shared<t_task>(task);
+		tasks.push_back(taskptr);
+		asio::post(pool, [taskptr]() { (*taskptr)(); });
+	}
+
+	for(std::size_t taskidx = 0; taskidx < tasks.size(); ++taskidx)
+	{
+		t_real progress = t_real(taskidx) / t_real(tasks.size());
+		if(!(*m_sigProgress)(CalculationState::RUNNING, progress, message))
+		{
+			pool.stop();
+			pool.join();
 
+			(*m_sigProgress)(CalculationState::FAILED, progress, message);
+			return false;
+		}
+
+		tasks[taskidx]->get_future().get();
+	}
+
+	pool.join();
+
+	// normal regions encircle forbidden coordinate points,
+	// inverted regions encircle allowed coordinate points:
+	// the outer contour of an obstacle region has the largest area,
+	// the contours around its holes have the opposite orientation
+	std::vector<std::uint8_t> inverted(num_contours, 0);
+	if(!use_region_function)
+	{
+		std::unordered_map<t_regionlabel, std::size_t> outer_contours;
+		outer_contours.reserve(num_contours);
+
+		for(std::size_t contouridx = 0; contouridx < num_contours; ++contouridx)
+		{
+			t_regionlabel label = contour_labels[contouridx];
+			if(label == geo::RegionLabels::NO_LABEL)
+				continue;
+
+			auto [iter, inserted] = outer_contours.emplace(label, contouridx);
+			if(!inserted && std::abs(contour_areas[contouridx]) > std::abs(contour_areas[iter->second]))
+				iter->second = contouridx;
+		}
+
+		for(std::size_t contouridx = 0; contouridx < num_contours; ++contouridx)
+		{
+			auto iter = outer_contours.find(contour_labels[contouridx]);
+			if(iter == outer_contours.end())
+				continue;
+
+			inverted[contouridx] = std::signbit(contour_areas[contouridx])
+				!= std::signbit(contour_areas[iter->second]);
+		}
+	}
+
+	// line groups in contour order
+	for(std::size_t contouridx = 0; contouridx < num_contours; ++contouridx)
+	{
 		// don't include outer bounding region
 		// TODO: test if such a region is there
-		if(contouridx > 0)
-		{
-			m_linegroups.emplace_back(std::make_pair(groupstart, groupend));
+		if(contouridx == 0)
+			continue;
 
-			if(!use_region_function)
-			{
-				t_vec2 point_outside_regions =
-					find_point_outside_regions(contour[0][0], contour[0][1], true);
-				m_points_outside_regions.emplace_back(
-					std::move(point_outside_regions));
-
-				//auto pix_incontour = m_img.GetPixel(inside_contour[0], inside_contour[1]);
-				auto pix_outcontour = m_img.GetPixel(outside_contour[0], outside_contour[1]);
-
-#ifdef DEBUG
-				std::cout << "contour " << std::dec << contouridx
-					<< ", pixel inside " << inside_contour[0] << ", " << inside_contour[1]
-					<< ": " << std::hex << int(pix_incontour) << std::dec
-					<< "; pixel outside " << outside_contour[0] << ", " << outside_contour[1]
-					<< ": " << std::hex << int(pix_outcontour) << std::endl;
-#endif
+		// mark line group start and end index
+		m_linegroups.emplace_back(std::make_pair(
+			contour_offs[contouridx], contour_offs[contouridx + 1]));
 
-				// normal regions encircle forbidden coordinate points
-				// inverted regions encircle allowed coordinate points
-				//m_inverted_regions.push_back(pix_incontour == PATHSBUILDER_PIXEL_VALUE_NOCOLLISION);
-				m_inverted_regions.push_back(pix_outcontour != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION);
-			}
+		if(!use_region_function)
+		{
+			m_points_outside_regions.emplace_back(std::move(points_outside[contouridx]));
+			m_inverted_regions.push_back(inverted[contouridx] != 0);
 		}
 	}
 
+	// report the timing
+	using t_ms = std::chrono::duration<t_real, std::milli>;
+	std::ostringstream ostrmsg;
+	ostrmsg << message << " Created " << m_lines.size() << " line segments in "
+		<< m_maxnum_threads << " threads, "
+		<< t_ms(std::chrono::steady_clock::now() - time_start).count() << " ms.";
+	message = ostrmsg.str();
+
 	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, message);
 	return true;
 }
@@ -641,6 +1522,45 @@ bool PathsBuilder::CalculateVoronoi(bool group_lines, VoronoiBackend backend,
 		return false;
 	};
 
+	// the raster backend doesn't use the contours, but needs the labelled regions
+	if(backend == VoronoiBackend::RASTER && !m_regionlabels.IsValid())
+		m_regionlabels.Calculate(m_img, m_maxnum_threads);
+
+	bool has_inverted_regions = std::find(m_inverted_regions.begin(),
+		m_inverted_regions.end(), true) != m_inverted_regions.end();
+
+	// without contours, the inverted regions are the enclosed free regions
+	if(backend == VoronoiBackend::RASTER)
+	{
+		has_inverted_regions = false;
+		for(t_regionlabel label=0; label<m_regionlabels.GetNumRegions(); ++label)
+		{
+			if(!m_regionlabels.IsSet(label) && m_regionlabels.IsEnclosed(label))
+			{
+				has_inverted_regions = true;
+				break;
+			}
+		}
+	}
+
+	// is the vertex in a forbidden region? use the labelled regions instead of the contour polygons
+	std::function<bool(const t_vec2&)> label_region_func = [this, has_inverted_regions]
+	(const t_vec2& vec) -> bool
+	{
+		if(vec[0] < 0 || vec[1] < 0)
+			return true;
+
+		t_regionlabel label = m_regionlabels.GetLabel(std::size_t(vec[0]), std::size_t(vec[1]));
+		if(label == geo::RegionLabels::NO_LABEL || m_regionlabels.IsSet(label))
+			return true;
+
+		// with inverted regions, only the free regions enclosed by obstacles are allowed
+		if(has_inverted_regions && !m_regionlabels.IsEnclosed(label))
+			return true;
+
+		return false;
+	};
+
 	// validation function that checks if (voronoi) vertices are far enough from any wall
 	std::function<bool(const t_vec2&)> validation_func = [this](const t_vec2& vec) -> bool
 	{
@@ -654,14 +1574,37 @@ bool PathsBuilder::CalculateVoronoi(bool group_lines, VoronoiBackend backend,
 	regions.SetLineGroups(&m_linegroups);
 	regions.SetPointsOutsideRegions(&m_points_outside_regions);
 	regions.SetInvertedRegions(&m_inverted_regions);
-	regions.SetRegionFunc(use_region_function ? &region_func : nullptr);
+	if(use_region_function)
+		regions.SetRegionFunc(&region_func);
+	else if(m_regionlabels.IsValid())
+		regions.SetRegionFunc(&label_region_func);
+	else
+		regions.SetRegionFunc(nullptr);
 	regions.SetValidateFunc(m_remove_bisectors_below_min_wall_dist ? &validation_func : nullptr);
 
 	if(backend == VoronoiBackend::BOOST)
 	{
 		m_voro_results
 			= geo::calc_voro<t_vec2, t_line, t_graph>(
-				m_lines, m_eps, m_voroedge_eps, &regions);
+				m_lines, m_eps, m_voroedge_eps, &regions, m_maxnum_threads);
+	}
+	else if(backend == VoronoiBackend::BOOST_TILED)
+	{
+		// about one tile per thread
+		const unsigned int tiles_per_axis = std::max<unsigned int>(2,
+			(unsigned int)std::ceil(std::sqrt(t_real(m_maxnum_threads))));
+
+		m_voro_results
+			= geo::calc_voro_tiled<t_vec2, t_line, t_graph>(
+				m_lines, m_eps, m_voroedge_eps, &regions,
+				tiles_per_axis, 0.1, m_maxnum_threads);
+	}
+	else if(backend == VoronoiBackend::RASTER)
+	{
+		m_voro_results
+			= geo::calc_voro_raster<t_vec2, t_line, t_graph>(
+				m_img, &m_regionlabels, &regions,
+				m_medial_axis_mindist, m_maxnum_threads);
 	}
 #ifdef USE_CGAL
 	else if(backend == VoronoiBackend::CGAL)
@@ -678,6 +1621,14 @@ bool PathsBuilder::CalculateVoronoi(bool group_lines, VoronoiBackend backend,
 		return false;
 	}
 
+	// contract the unbranched chains of the voronoi graph, the linear bisectors
+	// in the contracted edges are subdivided into pieces of at most two pixels
+	// so that the closest points on them can still be found
+	if(m_contract_voronoi_chains)
+		m_voro_results.ContractChains(2.);
+
+	CalculateVoronoiWallDistances();
+
 	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, message);
 	return true;
 }
@@ -786,7 +1737,7 @@ bool PathsBuilder::SaveToLinesTool(std::ostream& ostr)
 
 		for(std::size_t vertidx=0; vertidx<contour.size(); ++vertidx)
 		{
-			const t_contourvec& vec = contour[vertidx];
+			const t_wallcontourvec& vec = contour[vertidx];
 
 			ostr << "\t\t<" << vertidx;
 			ostr << " x=\"" << vec[0] << "\"";
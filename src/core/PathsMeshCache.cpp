@@ -0,0 +1,806 @@
+/**
+ * on-disk cache of calculated path meshes
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "PathsBuilder.h"
+#include "CollisionScene2D.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+// file identifier and format version of the cache files
+#define PATHSCACHE_MAGIC     "TASPMESH"
+#define PATHSCACHE_MAGIC_END "TASPEND."
+#define PATHSCACHE_VERSION   4
+
+
+// ----------------------------------------------------------------------------
+// hashing
+// ----------------------------------------------------------------------------
+/**
+ * 64 bit fnv-1a hash, stable across program runs and platforms
+ * @see https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+ */
+class PathMeshHash
+{
+public:
+	void Add(const void* data, std::size_t len)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+		for(std::size_t i=0; i<len; ++i)
+		{
+			m_hash ^= bytes[i];
+			m_hash *= 0x100000001b3ull;
+		}
+	}
+
+
+	template<class T> requires std::is_arithmetic_v<T>
+	void Add(T val)
+	{
+		Add(&val, sizeof(val));
+	}
+
+
+	void Add(const std::string& str)
+	{
+		Add(str.size());
+		Add(str.data(), str.size());
+	}
+
+
+	std::string GetHex() const
+	{
+		std::ostringstream ostr;
+		ostr << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+		return ostr.str();
+	}
+
+
+private:
+	std::uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// binary serialisation helpers
+// ----------------------------------------------------------------------------
+/**
+ * writes plain values and containers to a binary stream
+ */
+class PathMeshWriter
+{
+public:
+	PathMeshWriter(std::ostream& ostr) : m_ostr{ostr}
+	{}
+
+
+	template<class T> requires std::is_arithmetic_v<T>
+	void Write(T val)
+	{
+		m_ostr.write(reinterpret_cast<const char*>(&val), sizeof(val));
+	}
+
+
+	void WriteSize(std::size_t size)
+	{
+		Write<std::uint64_t>(size);
+	}
+
+
+	void WriteIndex(const std::optional<std::size_t>& idx)
+	{
+		Write<std::uint64_t>(idx ? *idx : std::numeric_limits<std::uint64_t>::max());
+	}
+
+
+	void Write(const std::string& str)
+	{
+		WriteSize(str.size());
+		m_ostr.write(str.data(), str.size());
+	}
+
+
+	template<class t_vec> requires tl2::is_basic_vec<t_vec>
+	void Write(const t_vec& vec)
+	{
+		Write(vec[0]);
+		Write(vec[1]);
+	}
+
+
+	template<class t_vec> requires tl2::is_basic_vec<t_vec>
+	void Write(const std::pair<t_vec, t_vec>& line)
+	{
+		Write(line.first);
+		Write(line.second);
+	}
+
+
+	template<class T>
+	void Write(const std::vector<T>& vec)
+	{
+		WriteSize(vec.size());
+		for(const T& elem : vec)
+			Write(elem);
+	}
+
+
+	void Write(const std::vector<bool>& vec)
+	{
+		WriteSize(vec.size());
+		for(bool elem : vec)
+			Write<std::uint8_t>(elem ? 1 : 0);
+	}
+
+
+	void Write(const geo::Image<std::uint8_t>& img)
+	{
+		WriteSize(img.GetWidth());
+		WriteSize(img.GetHeight());
+
+		for(std::size_t y=0; y<img.GetHeight(); ++y)
+			for(std::size_t x=0; x<img.GetWidth(); ++x)
+				Write<std::uint8_t>(img.GetPixel(x, y));
+	}
+
+
+	bool IsOk() const
+	{
+		return m_ostr.good();
+	}
+
+
+private:
+	std::ostream& m_ostr;
+};
+
+
+/**
+ * reads plain values and containers from a memory-mapped buffer,
+ * all reads are bounds-checked so that truncated files are detected
+ */
+class PathMeshReader
+{
+public:
+	PathMeshReader(const char* begin, const char* end) : m_cur{begin}, m_end{end}
+	{}
+
+
+	template<class T> requires std::is_arithmetic_v<T>
+	T Read()
+	{
+		T val{};
+		if(!Check(sizeof(T)))
+			return val;
+
+		std::memcpy(&val, m_cur, sizeof(T));
+		m_cur += sizeof(T);
+		return val;
+	}
+
+
+	/**
+	 * read an element count and check it against the remaining data size
+	 */
+	std::size_t ReadSize(std::size_t min_elem_size = 1)
+	{
+		std::uint64_t size = Read<std::uint64_t>();
+		if(!m_ok || size > std::uint64_t(m_end - m_cur) / std::max<std::size_t>(min_elem_size, 1))
+		{
+			m_ok = false;
+			return 0;
+		}
+
+		return std::size_t(size);
+	}
+
+
+	/**
+	 * read an optional index and check it against the number of elements
+	 */
+	std::optional<std::size_t> ReadIndex(std::size_t num)
+	{
+		std::uint64_t idx = Read<std::uint64_t>();
+		if(!m_ok)
+			return std::nullopt;
+		if(idx == std::numeric_limits<std::uint64_t>::max())
+			return std::nullopt;
+
+		if(idx >= num)
+		{
+			m_ok = false;
+			return std::nullopt;
+		}
+
+		return std::size_t(idx);
+	}
+
+
+	/**
+	 * read a mandatory index and check it against the number of elements
+	 */
+	std::size_t ReadValidIndex(std::size_t num)
+	{
+		std::optional<std::size_t> idx = ReadIndex(num);
+		if(!idx)
+		{
+			m_ok = false;
+			return 0;
+		}
+
+		return *idx;
+	}
+
+
+	std::string ReadString()
+	{
+		std::size_t len = ReadSize();
+		if(!Check(len))
+			return "";
+
+		std::string str(m_cur, len);
+		m_cur += len;
+		return str;
+	}
+
+
+	template<class t_vec> requires tl2::is_basic_vec<t_vec>
+	t_vec ReadVec()
+	{
+		using t_scalar = typename t_vec::value_type;
+
+		t_scalar x = Read<t_scalar>();
+		t_scalar y = Read<t_scalar>();
+		return tl2::create<t_vec>({ x, y });
+	}
+
+
+	template<class t_vec> requires tl2::is_basic_vec<t_vec>
+	std::pair<t_vec, t_vec> ReadLine()
+	{
+		t_vec vec1 = ReadVec<t_vec>();
+		t_vec vec2 = ReadVec<t_vec>();
+		return std::make_pair(vec1, vec2);
+	}
+
+
+	template<class t_vec> requires tl2::is_basic_vec<t_vec>
+	std::vector<t_vec> ReadVecs()
+	{
+		std::vector<t_vec> vecs;
+		std::size_t num = ReadSize(2 * sizeof(typename t_vec::value_type));
+		vecs.reserve(num);
+
+		for(std::size_t i=0; i<num && m_ok; ++i)
+			vecs.emplace_back(ReadVec<t_vec>());
+		return vecs;
+	}
+
+
+	bool ReadImage(geo::Image<std::uint8_t>& img)
+	{
+		std::size_t w = ReadSize();
+		std::size_t h = ReadSize();
+		if(!m_ok || (w && h > std::size_t(m_end - m_cur) / w))
+		{
+			m_ok = false;
+			return false;
+		}
+
+		img.Init(w, h);
+		for(std::size_t y=0; y<h; ++y)
+			for(std::size_t x=0; x<w; ++x)
+				img.SetPixel(x, y, Read<std::uint8_t>());
+		return m_ok;
+	}
+
+
+	bool ReadMagic(const char* magic)
+	{
+		const std::size_t len = std::strlen(magic);
+		if(!Check(len) || std::memcmp(m_cur, magic, len) != 0)
+		{
+			m_ok = false;
+			return false;
+		}
+
+		m_cur += len;
+		return true;
+	}
+
+
+	bool IsOk() const
+	{
+		return m_ok;
+	}
+
+
+protected:
+	bool Check(std::size_t len)
+	{
+		if(!m_ok || std::size_t(m_end - m_cur) < len)
+			m_ok = false;
+		return m_ok;
+	}
+
+
+private:
+	const char* m_cur = nullptr;
+	const char* m_end = nullptr;
+	bool m_ok = true;
+};
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// path mesh cache
+// ----------------------------------------------------------------------------
+/**
+ * get a hash over all inputs of the path mesh workflow, i.e. the collision
+ * geometry and the settings of the configuration space and mesh calculations;
+ * options contains further workflow settings like the chosen backends
+ */
+std::string PathsBuilder::GetPathMeshHash(
+	t_real da2, t_real da4,
+	t_real starta2, t_real enda2,
+	t_real starta4, t_real enda4,
+	const std::vector<int>& options) const
+{
+	PathMeshHash hash;
+	hash.Add(PATHSCACHE_VERSION);
+
+	// scattering senses and fixed k
+	bool kf_fixed = true;
+	if(m_tascalc)
+	{
+		const t_real *sensesCCW = m_tascalc->GetScatteringSenses();
+		for(int i=0; i<3; ++i)
+			hash.Add(sensesCCW ? sensesCCW[i] : t_real(1));
+
+		kf_fixed = std::get<1>(m_tascalc->GetKfix());
+	}
+	hash.Add(kf_fixed);
+
+	// instrument and walls as seen by the collision checks,
+	// the current scattering angles are not relevant except for the fixed axis
+	if(m_instrspace)
+	{
+		CollisionScene2D scene{*m_instrspace};
+		scene.AddToHash(hash);
+
+		const Instrument& instr = m_instrspace->GetInstrument();
+		hash.Add(kf_fixed
+			? instr.GetAnalyser().GetAxisAngleOut()
+			: instr.GetMonochromator().GetAxisAngleOut());
+
+		// the wall distances depend on the motor speeds
+		hash.Add(m_use_motor_speeds);
+		const t_vec2 scale = GetPathLengthScale();
+		hash.Add(scale[0]);
+		hash.Add(scale[1]);
+	}
+
+	// angular deltas and ranges
+	for(t_real val : { da2, da4, starta2, enda2, starta4, enda4 })
+		hash.Add(val);
+
+	// epsilons and mesh options
+	for(t_real val : { m_eps, m_eps_angular, m_voroedge_eps,
+		m_simplify_mindist, m_contour_decimation, m_min_angular_dist_to_walls,
+		m_medial_axis_mindist })
+		hash.Add(val);
+	hash.Add(m_remove_bisectors_below_min_wall_dist);
+	hash.Add(m_contract_voronoi_chains);
+	hash.Add(m_contour_bisections);
+	hash.Add(m_use_walldistfield);
+
+	// configuration space sampling
+	hash.Add(m_configspace_adaptive);
+	if(m_configspace_adaptive)
+	{
+		hash.Add(m_configspace_tile_size);
+		hash.Add(m_configspace_margin);
+	}
+
+	for(int option : options)
+		hash.Add(option);
+
+	return hash.GetHex();
+}
+
+
+/**
+ * save the current path mesh to a binary cache file
+ */
+bool PathsBuilder::SavePathMesh(const std::string& filename, const std::string& hash) const
+{
+	// write to a temporary file first, so that no partial file is left on errors
+	const std::string tmpfilename = filename + ".tmp";
+
+	{
+		std::ofstream ofstr(tmpfilename, std::ios_base::binary);
+		if(!ofstr)
+			return false;
+
+		PathMeshWriter writer{ofstr};
+		ofstr.write(PATHSCACHE_MAGIC, std::strlen(PATHSCACHE_MAGIC));
+		writer.Write<std::uint32_t>(PATHSCACHE_VERSION);
+		writer.Write(hash);
+
+		// configuration space
+		for(t_real val : { m_monoScatteringRange[0], m_monoScatteringRange[1],
+			m_sampleScatteringRange[0], m_sampleScatteringRange[1] })
+			writer.Write(val);
+		writer.Write(m_img_planes);
+
+		// contours and line segments
+		writer.WriteSize(m_wallcontours.size());
+		for(const auto& contour : m_wallcontours)
+			writer.Write(contour);
+		writer.WriteSize(m_fullwallcontours.size());
+		for(const auto& contour : m_fullwallcontours)
+			writer.Write(contour);
+
+		writer.Write(m_lines);
+		writer.WriteSize(m_linegroups.size());
+		for(const auto& [begin, end] : m_linegroups)
+		{
+			writer.WriteSize(begin);
+			writer.WriteSize(end);
+		}
+		writer.Write(m_points_outside_regions);
+		writer.Write(m_inverted_regions);
+
+		// voronoi vertices and edges
+		writer.Write(m_voro_results.GetVoronoiVertices());
+
+		const auto& lin_edges_vec = m_voro_results.GetLinearEdgesVec();
+		writer.WriteSize(lin_edges_vec.size());
+		for(const auto& [line, idx1, idx2] : lin_edges_vec)
+		{
+			writer.Write(line);
+			writer.WriteIndex(idx1);
+			writer.WriteIndex(idx2);
+		}
+
+		const auto& para_edges_vec = m_voro_results.GetParabolicEdgesVec();
+		writer.WriteSize(para_edges_vec.size());
+		for(const auto& [points, idx1, idx2] : para_edges_vec)
+		{
+			writer.Write(points);
+			writer.WriteIndex(idx1);
+			writer.WriteIndex(idx2);
+		}
+
+		const auto& lin_edges = m_voro_results.GetLinearEdges();
+		writer.WriteSize(lin_edges.size());
+		for(const auto& [indices, line] : lin_edges)
+		{
+			writer.WriteIndex(indices.first);
+			writer.WriteIndex(indices.second);
+			writer.Write(line);
+		}
+
+		const auto& para_edges = m_voro_results.GetParabolicEdges();
+		writer.WriteSize(para_edges.size());
+		for(const auto& [indices, points] : para_edges)
+		{
+			writer.WriteIndex(indices.first);
+			writer.WriteIndex(indices.second);
+			writer.Write(points);
+		}
+
+		// parameters of the quadratic bisectors
+		const auto& parabolas = m_voro_results.GetParabolas();
+		writer.WriteSize(parabolas.size());
+		for(const auto& [indices, parabola] : parabolas)
+		{
+			writer.WriteIndex(indices.first);
+			writer.WriteIndex(indices.second);
+			writer.Write(parabola.focus);
+			writer.Write(parabola.directrix);
+		}
+
+		// inner vertices of the contracted chains
+		const auto& chain_verts = m_voro_results.GetChainVertices();
+		writer.WriteSize(chain_verts.size());
+		for(const auto& [indices, points] : chain_verts)
+		{
+			writer.WriteIndex(indices.first);
+			writer.WriteIndex(indices.second);
+			writer.Write(points);
+		}
+
+		// voronoi graph, the neighbours are stored in reverse
+		// order so that re-adding them restores the original order
+		const t_graph& graph = m_voro_results.GetVoronoiGraph();
+		const std::size_t num_verts = graph.GetNumVertices();
+		writer.WriteSize(num_verts);
+		for(std::size_t vert=0; vert<num_verts; ++vert)
+			writer.Write(graph.GetVertexIdent(vert));
+
+		for(std::size_t vert=0; vert<num_verts; ++vert)
+		{
+			const auto neighbours = graph.GetNeighbours(vert, true);
+			writer.WriteSize(neighbours.size());
+
+			for(auto iter = neighbours.rbegin(); iter != neighbours.rend(); ++iter)
+			{
+				writer.WriteSize(*iter);
+				writer.Write(graph.GetWeight(vert, *iter).value_or(0));
+			}
+		}
+
+		ofstr.write(PATHSCACHE_MAGIC_END, std::strlen(PATHSCACHE_MAGIC_END));
+		if(!writer.IsOk())
+		{
+			ofstr.close();
+			std::remove(tmpfilename.c_str());
+			return false;
+		}
+	}
+
+	if(std::rename(tmpfilename.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(tmpfilename.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * load a path mesh from a binary cache file if its hash matches
+ */
+bool PathsBuilder::LoadPathMesh(const std::string& filename, const std::string& hash)
+{
+	namespace ipc = boost::interprocess;
+
+	std::ifstream ifstr(filename, std::ios_base::binary);
+	if(!ifstr)
+		return false;
+	ifstr.close();
+
+	// map the file into memory
+	ipc::file_mapping file;
+	ipc::mapped_region region;
+	try
+	{
+		file = ipc::file_mapping(filename.c_str(), ipc::read_only);
+		region = ipc::mapped_region(file, ipc::read_only);
+	}
+	catch(const ipc::interprocess_exception&)
+	{
+		return false;
+	}
+
+	const char* data = static_cast<const char*>(region.get_address());
+	PathMeshReader reader{data, data + region.get_size()};
+
+	// header
+	if(!reader.ReadMagic(PATHSCACHE_MAGIC) ||
+		reader.Read<std::uint32_t>() != PATHSCACHE_VERSION ||
+		reader.ReadString() != hash)
+		return false;
+
+	// configuration space
+	t_real mono_range[2], sample_range[2];
+	mono_range[0] = reader.Read<t_real>();
+	mono_range[1] = reader.Read<t_real>();
+	sample_range[0] = reader.Read<t_real>();
+	sample_range[1] = reader.Read<t_real>();
+
+	geo::Image<std::uint8_t> img_planes;
+	reader.ReadImage(img_planes);
+
+	// contours and line segments
+	auto read_contours = [&reader]() -> std::vector<std::vector<t_wallcontourvec>>
+	{
+		std::vector<std::vector<t_wallcontourvec>> contours;
+		std::size_t num = reader.ReadSize(sizeof(std::uint64_t));
+		contours.reserve(num);
+
+		for(std::size_t i=0; i<num && reader.IsOk(); ++i)
+			contours.emplace_back(reader.ReadVecs<t_wallcontourvec>());
+		return contours;
+	};
+
+	std::vector<std::vector<t_wallcontourvec>> wallcontours = read_contours();
+	std::vector<std::vector<t_wallcontourvec>> fullwallcontours = read_contours();
+
+	std::vector<t_line> lines;
+	std::size_t num_lines = reader.ReadSize(4 * sizeof(t_real));
+	lines.reserve(num_lines);
+	for(std::size_t i=0; i<num_lines && reader.IsOk(); ++i)
+		lines.emplace_back(reader.ReadLine<t_vec2>());
+
+	std::vector<std::pair<std::size_t, std::size_t>> linegroups;
+	std::size_t num_groups = reader.ReadSize(2 * sizeof(std::uint64_t));
+	linegroups.reserve(num_groups);
+	for(std::size_t i=0; i<num_groups && reader.IsOk(); ++i)
+	{
+		// the group ranges are half-open, so the end may equal the number of lines
+		std::size_t begin = reader.ReadValidIndex(lines.size() + 1);
+		std::size_t end = reader.ReadValidIndex(lines.size() + 1);
+		if(begin > end)
+			return false;
+		linegroups.emplace_back(std::make_pair(begin, end));
+	}
+
+	std::vector<t_vec2> points_outside_regions = reader.ReadVecs<t_vec2>();
+
+	std::vector<bool> inverted_regions;
+	std::size_t num_inverted = reader.ReadSize(sizeof(std::uint8_t));
+	inverted_regions.reserve(num_inverted);
+	for(std::size_t i=0; i<num_inverted && reader.IsOk(); ++i)
+		inverted_regions.push_back(reader.Read<std::uint8_t>() != 0);
+
+	// voronoi vertices and edges
+	geo::VoronoiLinesResults<t_vec2, t_line, t_graph> voro_results;
+	voro_results.GetVoronoiVertices() = reader.ReadVecs<t_vec2>();
+	const std::size_t num_voro_verts = voro_results.GetVoronoiVertices().size();
+
+	auto& lin_edges_vec = voro_results.GetLinearEdgesVec();
+	std::size_t num_lin_edges_vec = reader.ReadSize(4*sizeof(t_real) + 2*sizeof(std::uint64_t));
+	lin_edges_vec.reserve(num_lin_edges_vec);
+	for(std::size_t i=0; i<num_lin_edges_vec && reader.IsOk(); ++i)
+	{
+		t_line line = reader.ReadLine<t_vec2>();
+		auto idx1 = reader.ReadIndex(num_voro_verts);
+		auto idx2 = reader.ReadIndex(num_voro_verts);
+		lin_edges_vec.emplace_back(std::make_tuple(line, idx1, idx2));
+	}
+
+	auto& para_edges_vec = voro_results.GetParabolicEdgesVec();
+	std::size_t num_para_edges_vec = reader.ReadSize(3*sizeof(std::uint64_t));
+	para_edges_vec.reserve(num_para_edges_vec);
+	for(std::size_t i=0; i<num_para_edges_vec && reader.IsOk(); ++i)
+	{
+		std::vector<t_vec2> points = reader.ReadVecs<t_vec2>();
+		std::size_t idx1 = reader.ReadValidIndex(num_voro_verts);
+		std::size_t idx2 = reader.ReadValidIndex(num_voro_verts);
+		para_edges_vec.emplace_back(std::make_tuple(std::move(points), idx1, idx2));
+	}
+
+	auto& lin_edges = voro_results.GetLinearEdges();
+	std::size_t num_lin_edges = reader.ReadSize(4*sizeof(t_real) + 2*sizeof(std::uint64_t));
+	for(std::size_t i=0; i<num_lin_edges && reader.IsOk(); ++i)
+	{
+		auto idx1 = reader.ReadIndex(num_voro_verts);
+		auto idx2 = reader.ReadIndex(num_voro_verts);
+		t_line line = reader.ReadLine<t_vec2>();
+		lin_edges.emplace(std::make_pair(std::make_pair(idx1, idx2), line));
+	}
+
+	auto& para_edges = voro_results.GetParabolicEdges();
+	std::size_t num_para_edges = reader.ReadSize(3*sizeof(std::uint64_t));
+	for(std::size_t i=0; i<num_para_edges && reader.IsOk(); ++i)
+	{
+		std::size_t idx1 = reader.ReadValidIndex(num_voro_verts);
+		std::size_t idx2 = reader.ReadValidIndex(num_voro_verts);
+		std::vector<t_vec2> points = reader.ReadVecs<t_vec2>();
+		para_edges.emplace(std::make_pair(std::make_pair(idx1, idx2), std::move(points)));
+	}
+
+	auto& parabolas = voro_results.GetParabolas();
+	std::size_t num_parabolas = reader.ReadSize(2*sizeof(std::uint64_t) + 6*sizeof(t_real));
+	for(std::size_t i=0; i<num_parabolas && reader.IsOk(); ++i)
+	{
+		std::size_t idx1 = reader.ReadValidIndex(num_voro_verts);
+		std::size_t idx2 = reader.ReadValidIndex(num_voro_verts);
+		t_vec2 focus = reader.ReadVec<t_vec2>();
+		t_line directrix = reader.ReadLine<t_vec2>();
+
+		parabolas.emplace(std::make_pair(std::make_pair(idx1, idx2),
+			geo::VoronoiParabola<t_vec2, t_line>{ .focus = focus, .directrix = directrix }));
+	}
+
+	auto& chain_verts = voro_results.GetChainVertices();
+	std::size_t num_chains = reader.ReadSize(3*sizeof(std::uint64_t));
+	for(std::size_t i=0; i<num_chains && reader.IsOk(); ++i)
+	{
+		std::size_t idx1 = reader.ReadValidIndex(num_voro_verts);
+		std::size_t idx2 = reader.ReadValidIndex(num_voro_verts);
+		std::vector<t_vec2> points = reader.ReadVecs<t_vec2>();
+		chain_verts.emplace(std::make_pair(std::make_pair(idx1, idx2), std::move(points)));
+	}
+
+	// voronoi graph
+	t_graph& graph = voro_results.GetVoronoiGraph();
+	std::size_t num_verts = reader.ReadSize(sizeof(std::uint64_t));
+
+	// the graph vertices have to correspond to the voronoi vertices
+	if(!reader.IsOk() || num_verts != num_voro_verts)
+		return false;
+
+	for(std::size_t vert=0; vert<num_verts && reader.IsOk(); ++vert)
+		graph.AddVertex(reader.ReadString());
+
+	for(std::size_t vert=0; vert<num_verts && reader.IsOk(); ++vert)
+	{
+		std::size_t num_neighbours = reader.ReadSize(sizeof(std::uint64_t) + sizeof(t_real));
+		for(std::size_t i=0; i<num_neighbours && reader.IsOk(); ++i)
+		{
+			std::size_t neighbour = reader.ReadValidIndex(num_verts);
+			t_real weight = reader.Read<t_real>();
+			if(!reader.IsOk())
+				break;
+			graph.AddEdge(vert, neighbour, weight);
+		}
+	}
+
+	// truncated or corrupted file?
+	if(!reader.ReadMagic(PATHSCACHE_MAGIC_END) || !reader.IsOk())
+		return false;
+
+	// everything was read successfully, take over the data
+	m_monoScatteringRange[0] = mono_range[0];
+	m_monoScatteringRange[1] = mono_range[1];
+	m_sampleScatteringRange[0] = sample_range[0];
+	m_sampleScatteringRange[1] = sample_range[1];
+
+	m_img_planes = std::move(img_planes);
+	ComposeConfigSpaceImage();
+
+	// the loaded planes can't be updated incrementally
+	m_configspace_scene = nullptr;
+
+	m_wallcontours = std::move(wallcontours);
+	m_fullwallcontours = std::move(fullwallcontours);
+	m_lines = std::move(lines);
+	m_linegroups = std::move(linegroups);
+	m_points_outside_regions = std::move(points_outside_regions);
+	m_inverted_regions = std::move(inverted_regions);
+
+	// the region labels are not stored, but rebuilt from the image
+	if(m_inverted_regions.size())
+		m_regionlabels.Calculate(m_img, m_maxnum_threads);
+	else
+		m_regionlabels.Clear();
+
+	voro_results.CreateIndexTree();
+	m_voro_results = std::move(voro_results);
+
+	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, "Loaded cached path mesh.");
+
+	// the wall index tree is not stored, but quickly rebuilt from the image
+	return CalculateWallsIndexTree();
+}
+// ----------------------------------------------------------------------------
@@ -48,8 +48,9 @@
  *  1: standard dijkstra (no negative weights)
  *  2: general dijkstra (which works with negative weights)
  *  3: bellman (very slow!)
+ *  4: dijkstra with an indexed heap, stopping at the target vertex (no negative weights)
  */
-#define TASPATHS_SSSP_IMPL 2
+#define TASPATHS_SSSP_IMPL 4
 
 
 /**
@@ -28,6 +28,7 @@
 
 #include <QtCore/QMetaObject>
 #include <QtCore/QThread>
+#include <QtCore/QDir>
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QFileDialog>
@@ -2244,8 +2245,17 @@ void PathsTool::InitSettings()
 	m_pathsbuilder.SetMaxDirectPathRadius(g_directpath_search_radius);
 	m_pathsbuilder.SetNumClosestVoronoiVertices(g_num_closest_voronoi_vertices);
 	m_pathsbuilder.SetVerifyPath(g_verifypath != 0);
+	m_pathsbuilder.SetUseAStar(g_use_astar != 0);
 	m_pathsbuilder.SetMinDistToWalls(g_min_dist_to_walls);
 	m_pathsbuilder.SetRemoveBisectorsBelowMinWallDist(g_remove_bisectors_below_min_wall_dist != 0);
+	m_pathsbuilder.SetContractVoronoiChains(g_contract_voronoi_chains != 0);
+	m_pathsbuilder.SetUseAdaptiveConfigSpace(g_adaptive_configspace != 0);
+	m_pathsbuilder.SetConfigSpaceTileSize(g_configspace_tile_size);
+	m_pathsbuilder.SetConfigSpaceSafetyMargin(g_configspace_margin);
+	m_pathsbuilder.SetUseIncrementalConfigSpace(g_incremental_configspace != 0);
+	m_pathsbuilder.SetUseWallDistanceField(g_use_wall_distance_field != 0);
+	m_pathsbuilder.SetNumContourBisections(g_contour_bisections);
+	m_pathsbuilder.SetContourDecimation(g_contour_decimation);
 	//m_pathsbuilder.SetUseRegionFunction(g_use_region_function != 0);
 
 	QMainWindow::DockOptions dockoptions{};
@@ -2663,6 +2673,32 @@ bool PathsTool::CalculatePathMesh()
 		starta4 -= padding * g_a4_delta;
 		enda4 += padding * g_a4_delta;
 
+		// try to load a previously calculated path mesh for the same inputs
+		std::string cache_hash, cache_file;
+		if(g_use_pathmesh_cache)
+		{
+			const std::vector<int> options{{ g_contour_backend,
+				g_voronoi_backend, g_use_region_function }};
+			cache_hash = m_pathsbuilder.GetPathMeshHash(
+				g_a2_delta, g_a4_delta, starta2, enda2, starta4, enda4, options);
+			cache_file = (fs::path(g_cachepath) / fs::path(cache_hash + ".taspaths-mesh")).string();
+
+			if(m_pathsbuilder.LoadPathMesh(cache_file, cache_hash))
+			{
+				ValidatePathMesh(true);
+				m_pathsbuilder.FinishPathMeshWorkflow(true);
+
+				SetTmpStatus("Path mesh loaded from cache.");
+
+				bool ok = true;
+				if(m_autocalcpath)
+					ok = CalculatePath();
+				return ok;
+			}
+		}
+
+		CHECK_STOP
+
 		SetTmpStatus("Clearing old paths.", 0);
 		m_pathsbuilder.Clear();
 
@@ -2690,40 +2726,50 @@ bool PathsTool::CalculatePathMesh()
 
 		CHECK_STOP
 
-		// contour backend
-		ContourBackend contour_backend{ContourBackend::INTERNAL};
+		// voronoi backend
+		VoronoiBackend voro_backend{VoronoiBackend::BOOST};
+		if(g_voronoi_backend == 1)
+			voro_backend = VoronoiBackend::CGAL;
+		else if(g_voronoi_backend == 2)
+			voro_backend = VoronoiBackend::BOOST_TILED;
+		else if(g_voronoi_backend == 3)
+			voro_backend = VoronoiBackend::RASTER;
+
+		// the raster backend works directly on the configuration space image
+		if(voro_backend != VoronoiBackend::RASTER)
+		{
+			// contour backend
+			ContourBackend contour_backend{ContourBackend::INTERNAL};
 #ifdef USE_OCV
-		if(g_contour_backend == 1)
-			contour_backend = ContourBackend::OCV;
+			if(g_contour_backend == 1)
+				contour_backend = ContourBackend::OCV;
 #endif
+			if(g_contour_backend == 2)
+				contour_backend = ContourBackend::MARCHING_SQUARES;
 
-		SetTmpStatus("Calculating obstacle contour lines.", 0);
-		if(!m_pathsbuilder.CalculateWallContours(true, false, contour_backend))
-		{
-			m_pathsbuilder.FinishPathMeshWorkflow(false);
-			SetTmpStatus("Error: Obstacle contour lines calculation failed.");
-			return false;
-		}
+			SetTmpStatus("Calculating obstacle contour lines.", 0);
+			if(!m_pathsbuilder.CalculateWallContours(true, false, contour_backend))
+			{
+				m_pathsbuilder.FinishPathMeshWorkflow(false);
+				SetTmpStatus("Error: Obstacle contour lines calculation failed.");
+				return false;
+			}
 
-		CHECK_STOP
+			CHECK_STOP
 
-		SetTmpStatus("Calculating line segments.", 0);
-		if(!m_pathsbuilder.CalculateLineSegments(g_use_region_function!=0))
-		{
-			m_pathsbuilder.FinishPathMeshWorkflow(false);
-			SetTmpStatus("Error: Line segment calculation failed.");
-			return false;
-		}
+			SetTmpStatus("Calculating line segments.", 0);
+			if(!m_pathsbuilder.CalculateLineSegments(g_use_region_function!=0))
+			{
+				m_pathsbuilder.FinishPathMeshWorkflow(false);
+				SetTmpStatus("Error: Line segment calculation failed.");
+				return false;
+			}
 
-		CHECK_STOP
+			CHECK_STOP
+		}
 
 		SetTmpStatus("Calculating Voronoi regions.", 0);
 
-		// voronoi backend
-		VoronoiBackend voro_backend{VoronoiBackend::BOOST};
-		if(g_voronoi_backend == 1)
-			voro_backend = VoronoiBackend::CGAL;
-
 		if(!m_pathsbuilder.CalculateVoronoi(false, voro_backend, g_use_region_function!=0))
 		{
 			m_pathsbuilder.FinishPathMeshWorkflow(false);
@@ -2737,6 +2783,14 @@ bool PathsTool::CalculatePathMesh()
 		ValidatePathMesh(true);
 		m_pathsbuilder.FinishPathMeshWorkflow(true);
 
+		// store the path mesh for later re-use
+		if(g_use_pathmesh_cache && QDir().mkpath(g_cachepath.c_str()))
+		{
+			if(!m_pathsbuilder.SavePathMesh(cache_file, cache_hash))
+				std::cerr << "Error: Could not write path mesh cache file \""
+					<< cache_file << "\"." << std::endl;
+		}
+
 		SetTmpStatus("Path mesh calculated.");
 
 		// also directly calculate a path if possible
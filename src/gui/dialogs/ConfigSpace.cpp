@@ -83,6 +83,9 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 			m_contourbackend = ContourBackend::OCV;
 			break;
 #endif
+		case 2:
+			m_contourbackend = ContourBackend::MARCHING_SQUARES;
+			break;
 	}
 
 	// set voronoi calculation backend
@@ -95,6 +98,12 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 		case 1:
 			m_voronoibackend = VoronoiBackend::CGAL;
 			break;
+		case 2:
+			m_voronoibackend = VoronoiBackend::BOOST_TILED;
+			break;
+		case 3:
+			m_voronoibackend = VoronoiBackend::RASTER;
+			break;
 	}
 
 	// get global path finding strategy
@@ -326,12 +335,24 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 	acBackendCgal->setCheckable(true);
 	acBackendCgal->setChecked(m_voronoibackend == VoronoiBackend::CGAL);
 
+	QAction *acBackendBoostTiled = new QAction("Boost.Polygon, Tiled", menuVoroBackend);
+	acBackendBoostTiled->setCheckable(true);
+	acBackendBoostTiled->setChecked(m_voronoibackend == VoronoiBackend::BOOST_TILED);
+
+	QAction *acBackendRaster = new QAction("Raster, Medial Axis", menuVoroBackend);
+	acBackendRaster->setCheckable(true);
+	acBackendRaster->setChecked(m_voronoibackend == VoronoiBackend::RASTER);
+
 	QActionGroup *groupVoroBackend = new QActionGroup{this};
 	groupVoroBackend->addAction(acBackendBoost);
 	groupVoroBackend->addAction(acBackendCgal);
+	groupVoroBackend->addAction(acBackendBoostTiled);
+	groupVoroBackend->addAction(acBackendRaster);
 
 	menuVoroBackend->addAction(acBackendBoost);
 	menuVoroBackend->addAction(acBackendCgal);
+	menuVoroBackend->addAction(acBackendBoostTiled);
+	menuVoroBackend->addAction(acBackendRaster);
 	menuMeshOptions->addMenu(menuVoroBackend);
 	// ------------------------------------------------------------------------
 
@@ -609,6 +630,18 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 			m_voronoibackend = VoronoiBackend::CGAL;
 	});
 
+	connect(acBackendBoostTiled, &QAction::toggled, [this](bool checked)
+	{
+		if(checked)
+			m_voronoibackend = VoronoiBackend::BOOST_TILED;
+	});
+
+	connect(acBackendRaster, &QAction::toggled, [this](bool checked)
+	{
+		if(checked)
+			m_voronoibackend = VoronoiBackend::RASTER;
+	});
+
 
 
 	// path options
@@ -1225,7 +1258,7 @@ void ConfigSpaceDlg::RedrawVoronoiPlot()
 
 	for(const auto& contour : contours)
 		for(const auto& vec : contour)
-			m_colourMap->data()->setCell(vec[0], vec[1], 0.5);
+			m_colourMap->data()->setCell(int(std::round(vec[0])), int(std::round(vec[1])), 0.5);
 
 
 	// draw linear voronoi edges
@@ -1259,10 +1292,13 @@ void ConfigSpaceDlg::RedrawVoronoiPlot()
 	}
 
 
-	// draw parabolic voronoi edges
-	for(const auto& edge : m_pathsbuilder->GetVoronoiResults().GetParabolicEdges())
+	// draw parabolic voronoi edges, sampled with a chord distance of a quarter pixel
+	const auto& voro_results = m_pathsbuilder->GetVoronoiResults();
+	for(const auto& edge : voro_results.GetParabolicEdges())
 	{
-		const auto& points = std::get<1>(edge);
+		const auto& indices = std::get<0>(edge);
+		const std::vector<t_vec2> points = voro_results.GetParabolicEdge(
+			indices.first, indices.second, 0.25);
 
 		QVector<t_real> vecx, vecy;
 		vecx.reserve(points.size());
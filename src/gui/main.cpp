@@ -119,6 +119,12 @@ public:
 		else
 			g_imgpath = g_docpath;
 
+		if(QString cachedir = QStandardPaths::writableLocation(
+			QStandardPaths::CacheLocation); cachedir.size())
+			g_cachepath = cachedir.toStdString();
+		else
+			g_cachepath = g_homepath;
+
 		// override standard paths with own subdir
 		if(g_use_taspaths_subdir)
 		{
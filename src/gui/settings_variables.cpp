@@ -43,6 +43,7 @@ std::string g_homepath = "~/";
 std::string g_desktoppath = g_homepath;
 std::string g_docpath = g_homepath;
 std::string g_imgpath = g_homepath;
+std::string g_cachepath = g_homepath;
 
 #if BOOST_OS_MACOS
 	int g_use_taspaths_subdir = 1;
@@ -64,7 +65,7 @@ int g_prec_gui = 3;
 t_real g_eps = 1e-6;
 t_real g_eps_angular = 0.01 / 180. * tl2::pi<t_real>;
 t_real g_eps_gui = 1e-4;
-t_real g_eps_voronoiedge = 2e-2;
+t_real g_eps_voronoiedge = 0.1;
 
 t_real g_line_subdiv_len = 0.025;
 
@@ -79,11 +80,18 @@ t_real g_a4_delta = 1. / 180. * tl2::pi<t_real>;
 int g_poly_intersection_method = 1;
 
 // which backend to use for contour calculation?
-// 0: internal, 1: opencv
+// 0: internal, 1: opencv, 2: marching squares
 int g_contour_backend = 0;
 
+// number of bisection steps to refine the marching squares contours
+unsigned int g_contour_bisections = 4;
+
+// maximum angular deviation of the decimated contours
+t_real g_contour_decimation = 0.25 / t_real(180.) * tl2::pi<t_real>;
+
 // which backend to use for voronoi diagram calculation?
-// 0: boost.polygon, 1: cgal
+// 0: boost.polygon, 1: cgal, 2: boost.polygon in parallel tiles,
+// 3: medial axis of the configuration space image
 int g_voronoi_backend = 0;
 
 // use region calculation function
@@ -92,11 +100,31 @@ int g_use_region_function = 1;
 // use bisector verification function
 int g_remove_bisectors_below_min_wall_dist = 0;
 
+// contract the unbranched chains of the voronoi graph
+int g_contract_voronoi_chains = 0;
+
+// sample the configuration space adaptively
+int g_adaptive_configspace = 0;
+
+// initial tile size and safety margin (in pixels) for adaptive sampling
+unsigned int g_configspace_tile_size = 32;
+unsigned int g_configspace_margin = 1;
+
+// only recalculate the configuration space planes affected by wall or limit changes
+int g_incremental_configspace = 1;
+
+// store calculated path meshes on disk and re-use them
+int g_use_pathmesh_cache = 1;
+
+// look up wall distances in a distance field instead of an index tree
+int g_use_wall_distance_field = 1;
+
 
 // path-finding options
 int g_pathstrategy = 0;
 int g_try_direct_path = 1;
 int g_verifypath = 1;
+int g_use_astar = 1;
 
 // number of closest voronoi vertices to consider for retraction point search
 unsigned int g_num_closest_voronoi_vertices = 64;
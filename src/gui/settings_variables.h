@@ -60,6 +60,9 @@ extern std::string g_desktoppath;
 extern std::string g_docpath;
 extern std::string g_imgpath;
 
+// directory for cached path meshes
+extern std::string g_cachepath;
+
 // create a subdirectory under the home directory for taspaths files
 extern int g_use_taspaths_subdir;
 
@@ -94,11 +97,18 @@ extern t_real g_a4_delta;
 extern int g_poly_intersection_method;
 
 // which backend to use for contour calculation?
-// 0: internal, 1: opencv
+// 0: internal, 1: opencv, 2: marching squares
 extern int g_contour_backend;
 
+// number of bisection steps to refine the marching squares contours
+extern unsigned int g_contour_bisections;
+
+// maximum angular deviation of the decimated contours
+extern t_real g_contour_decimation;
+
 // which backend to use for voronoi diagram calculation?
-// 0: boost.polygon, 1: cgal
+// 0: boost.polygon, 1: cgal, 2: boost.polygon in parallel tiles,
+// 3: medial axis of the configuration space image
 extern int g_voronoi_backend;
 
 // use region calculation function
@@ -107,6 +117,25 @@ extern int g_use_region_function;
 // use bisector verification function
 extern int g_remove_bisectors_below_min_wall_dist;
 
+// contract the unbranched chains of the voronoi graph
+extern int g_contract_voronoi_chains;
+
+// sample the configuration space adaptively
+extern int g_adaptive_configspace;
+
+// initial tile size and safety margin (in pixels) for adaptive sampling
+extern unsigned int g_configspace_tile_size;
+extern unsigned int g_configspace_margin;
+
+// only recalculate the configuration space planes affected by wall or limit changes
+extern int g_incremental_configspace;
+
+// store calculated path meshes on disk and re-use them
+extern int g_use_pathmesh_cache;
+
+// look up wall distances in a distance field instead of an index tree
+extern int g_use_wall_distance_field;
+
 
 // which path finding strategy to use?
 // 0: shortest path, 1: avoid walls
@@ -121,6 +150,9 @@ extern t_real g_directpath_search_radius;
 // verify the generated path?
 extern int g_verifypath;
 
+// use an a* search instead of dijkstra's algorithm?
+extern int g_use_astar;
+
 // number of closest voronoi vertices to consider for retraction point search
 extern unsigned int g_num_closest_voronoi_vertices;
 
@@ -187,7 +219,7 @@ extern int g_nested_docks;
 // ----------------------------------------------------------------------------
 // variables register
 // ----------------------------------------------------------------------------
-constexpr std::array<SettingsVariable, 31> g_settingsvariables
+constexpr std::array<SettingsVariable, 41> g_settingsvariables
 {{
 	// epsilons and precisions
 	{
@@ -275,14 +307,25 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.key = "settings/contour_backend",
 		.value = &g_contour_backend,
 		.editor = SettingsVariableEditor::COMBOBOX,
-		.editor_config = "Internal;;OpenCV",
+		.editor_config = "Internal;;OpenCV;;Marching Squares",
+	},
+	{
+		.description = "Bisection steps for marching squares contours.",
+		.key = "settings/contour_bisections",
+		.value = &g_contour_bisections,
+	},
+	{
+		.description = "Maximum angular deviation for contour decimation.",
+		.key = "settings/contour_decimation",
+		.value = &g_contour_decimation,
+		.is_angle = true,
 	},
 	{
 		.description = "Voronoi calculation backend.",
 		.key = "settings/voronoi_backend",
 		.value = &g_voronoi_backend,
 		.editor = SettingsVariableEditor::COMBOBOX,
-		.editor_config = "BOOST/Polygon;;CGAL/S.D.Graph",
+		.editor_config = "BOOST/Polygon;;CGAL/S.D.Graph;;BOOST/Polygon (tiled);;Raster/Medial Axis",
 	},
 	{
 		.description = "Use region function.",
@@ -296,6 +339,46 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.value = &g_remove_bisectors_below_min_wall_dist,
 		.editor = SettingsVariableEditor::YESNO,
 	},
+	{
+		.description = "Contract unbranched Voronoi edge chains.",
+		.key = "settings/contract_voronoi_chains",
+		.value = &g_contract_voronoi_chains,
+		.editor = SettingsVariableEditor::YESNO,
+	},
+	{
+		.description = "Adaptive configuration space sampling.",
+		.key = "settings/adaptive_configspace",
+		.value = &g_adaptive_configspace,
+		.editor = SettingsVariableEditor::YESNO,
+	},
+	{
+		.description = "Tile size for adaptive sampling (pixels).",
+		.key = "settings/configspace_tile_size",
+		.value = &g_configspace_tile_size,
+	},
+	{
+		.description = "Safety margin for adaptive sampling (pixels).",
+		.key = "settings/configspace_margin",
+		.value = &g_configspace_margin,
+	},
+	{
+		.description = "Incremental configuration space updates.",
+		.key = "settings/incremental_configspace",
+		.value = &g_incremental_configspace,
+		.editor = SettingsVariableEditor::YESNO,
+	},
+	{
+		.description = "Cache path meshes on disk.",
+		.key = "settings/use_pathmesh_cache",
+		.value = &g_use_pathmesh_cache,
+		.editor = SettingsVariableEditor::YESNO,
+	},
+	{
+		.description = "Use a distance field for wall distances.",
+		.key = "settings/use_wall_distance_field",
+		.value = &g_use_wall_distance_field,
+		.editor = SettingsVariableEditor::YESNO,
+	},
 
 	// path options
 	{
@@ -323,6 +406,12 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.value = &g_verifypath,
 		.editor = SettingsVariableEditor::YESNO,
 	},
+	{
+		.description = "Use A* search for path finding.",
+		.key = "settings/use_astar",
+		.value = &g_use_astar,
+		.editor = SettingsVariableEditor::YESNO,
+	},
 	{
 		.description = "Number of closest voronoi vertices for retraction point search.",
 		.key = "settings/num_closest_voronoi_vertices",
@@ -44,6 +44,10 @@
 #include <type_traits>
 #include <concepts>
 #include <vector>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
 #include <limits>
 #include <stack>
 #include <set>
@@ -51,6 +55,7 @@
 #include <algorithm>
 #include <optional>
 #include <iostream>
+#include <cassert>
 
 #ifdef USE_BOOST_GRAPH
 	#include <boost/graph/adjacency_list.hpp>
@@ -700,6 +705,321 @@ private:
 	std::vector<std::string> m_vertexidents{};
 	std::vector<std::shared_ptr<AdjNode>> m_nodes{};
 };
+
+
+
+/**
+ * compressed sparse row graph
+ *
+ * the outgoing edges of all vertices are stored in contiguous offset, target and weight arrays.
+ * new edges are collected per vertex and have to be merged into the arrays with Compact()
+ * once the graph is built, the read accesses require a compacted graph and never modify it.
+ * the neighbours are ordered like in the adjacency list, the most recently added edge first.
+ *
+ * @see https://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_(CSR,_CRS_or_Yale_format)
+ */
+template<class _t_weight = unsigned int>
+class CsrGraph
+{
+public:
+	using t_weight = _t_weight;
+	using t_neighbours = std::span<const std::size_t>;
+
+
+public:
+	CsrGraph() = default;
+	~CsrGraph() = default;
+
+
+	void Clear()
+	{
+		m_vertexidents.clear();
+		m_vertexindices.clear();
+
+		m_offsets.clear();
+		m_targets.clear();
+		m_weights.clear();
+		m_in_offsets.clear();
+		m_in_sources.clear();
+
+		m_pending.clear();
+		m_num_pending = 0;
+	}
+
+
+	std::size_t GetNumVertices() const
+	{
+		return m_vertexidents.size();
+	}
+
+
+	std::size_t GetNumEdges() const
+	{
+		assert(IsCompact());
+		return m_targets.size();
+	}
+
+
+	const std::string& GetVertexIdent(std::size_t i) const
+	{
+		return m_vertexidents[i];
+	}
+
+
+	std::optional<std::size_t> GetVertexIndex(const std::string& vert) const
+	{
+		auto iter = m_vertexindices.find(vert);
+		if(iter == m_vertexindices.end())
+			return std::nullopt;
+
+		return iter->second;
+	}
+
+
+	void AddVertex(const std::string& id)
+	{
+		// like in the other containers, the first vertex with a given identifier is found
+		m_vertexindices.emplace(id, m_vertexidents.size());
+		m_vertexidents.push_back(id);
+		m_pending.emplace_back();
+	}
+
+
+	void SetWeight(std::size_t idx1, std::size_t idx2, t_weight w)
+	{
+		if(idx1 >= GetNumVertices())
+			return;
+
+		// newest edges first
+		auto& pending = m_pending[idx1];
+		for(auto iter = pending.rbegin(); iter != pending.rend(); ++iter)
+		{
+			if(iter->first == idx2)
+			{
+				iter->second = w;
+				return;
+			}
+		}
+
+		if(idx1 + 1 >= m_offsets.size())
+			return;
+
+		for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+		{
+			if(m_targets[edge] == idx2)
+			{
+				m_weights[edge] = w;
+				return;
+			}
+		}
+	}
+
+
+	void SetWeight(const std::string& vert1, const std::string& vert2, t_weight w)
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(idx1 && idx2)
+			SetWeight(*idx1, *idx2, w);
+	}
+
+
+	std::optional<t_weight> GetWeight(std::size_t idx1, std::size_t idx2) const
+	{
+		assert(IsCompact());
+		if(idx1 + 1 >= m_offsets.size())
+			return std::nullopt;
+
+		for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+		{
+			if(m_targets[edge] == idx2)
+				return m_weights[edge];
+		}
+
+		return std::nullopt;
+	}
+
+
+	std::optional<t_weight> GetWeight(const std::string& vert1, const std::string& vert2) const
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(idx1 && idx2)
+			return GetWeight(*idx1, *idx2);
+
+		return std::nullopt;
+	}
+
+
+	void AddEdge(std::size_t idx1, std::size_t idx2, t_weight w=0)
+	{
+		if(idx1 >= GetNumVertices() || idx2 >= GetNumVertices())
+			return;
+
+		m_pending[idx1].emplace_back(std::make_pair(idx2, w));
+		++m_num_pending;
+	}
+
+
+	void AddEdge(const std::string& vert1, const std::string& vert2, t_weight w=0)
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(!idx1 || !idx2)
+			return;
+
+		AddEdge(*idx1, *idx2, w);
+	}
+
+
+	bool IsAdjacent(std::size_t idx1, std::size_t idx2) const
+	{
+		return GetWeight(idx1, idx2).operator bool();
+	}
+
+
+	bool IsAdjacent(const std::string& vert1, const std::string& vert2) const
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(!idx1 || !idx2)
+			return false;
+
+		return IsAdjacent(*idx1, *idx2);
+	}
+
+
+	/**
+	 * get the neighbours of a vertex as a view into the graph arrays
+	 */
+	t_neighbours GetNeighbours(std::size_t idx, bool outgoing_edges=true) const
+	{
+		assert(IsCompact());
+
+		const std::vector<std::size_t>& offsets = outgoing_edges ? m_offsets : m_in_offsets;
+		const std::vector<std::size_t>& indices = outgoing_edges ? m_targets : m_in_sources;
+		if(idx + 1 >= offsets.size())
+			return {};
+
+		return t_neighbours(indices.data() + offsets[idx], offsets[idx + 1] - offsets[idx]);
+	}
+
+
+	std::vector<std::string> GetNeighbours(const std::string& vert, bool outgoing_edges=true) const
+	{
+		auto idx = GetVertexIndex(vert);
+		if(!idx)
+			return {};
+
+		std::vector<std::string> neighbours;
+		for(std::size_t neighbour_index : GetNeighbours(*idx, outgoing_edges))
+			neighbours.push_back(GetVertexIdent(neighbour_index));
+
+		return neighbours;
+	}
+
+
+	/**
+	 * are all edges merged into the arrays?
+	 */
+	bool IsCompact() const
+	{
+		return !m_num_pending && (m_offsets.size() == GetNumVertices() + 1 || !GetNumVertices());
+	}
+
+
+	/**
+	 * merge the pending edges into the arrays
+	 */
+	void Compact()
+	{
+		if(IsCompact())
+			return;
+
+		const std::size_t num_verts = GetNumVertices();
+
+		auto old_row_size = [this](std::size_t idx) -> std::size_t
+		{
+			if(idx + 1 >= m_offsets.size())
+				return 0;
+			return m_offsets[idx + 1] - m_offsets[idx];
+		};
+
+		// outgoing edges
+		std::vector<std::size_t> offsets(num_verts + 1, 0);
+		for(std::size_t idx=0; idx<num_verts; ++idx)
+			offsets[idx + 1] = offsets[idx] + m_pending[idx].size() + old_row_size(idx);
+
+		std::vector<std::size_t> targets(offsets[num_verts]);
+		std::vector<t_weight> weights(offsets[num_verts]);
+
+		for(std::size_t idx=0; idx<num_verts; ++idx)
+		{
+			std::size_t edge = offsets[idx];
+
+			// newest edges first
+			const auto& pending = m_pending[idx];
+			for(auto iter = pending.rbegin(); iter != pending.rend(); ++iter, ++edge)
+			{
+				targets[edge] = iter->first;
+				weights[edge] = iter->second;
+			}
+
+			if(std::size_t old_size = old_row_size(idx); old_size)
+			{
+				std::copy_n(m_targets.begin() + m_offsets[idx], old_size, targets.begin() + edge);
+				std::copy_n(m_weights.begin() + m_offsets[idx], old_size, weights.begin() + edge);
+			}
+		}
+
+		// incoming edges
+		std::vector<std::size_t> in_offsets(num_verts + 1, 0);
+		for(std::size_t target : targets)
+			++in_offsets[target + 1];
+		for(std::size_t idx=0; idx<num_verts; ++idx)
+			in_offsets[idx + 1] += in_offsets[idx];
+
+		std::vector<std::size_t> in_sources(targets.size());
+		std::vector<std::size_t> in_fill(in_offsets.begin(), in_offsets.end() - 1);
+		for(std::size_t idx=0; idx<num_verts; ++idx)
+		{
+			for(std::size_t edge=offsets[idx]; edge<offsets[idx + 1]; ++edge)
+				in_sources[in_fill[targets[edge]]++] = idx;
+		}
+
+		m_offsets = std::move(offsets);
+		m_targets = std::move(targets);
+		m_weights = std::move(weights);
+		m_in_offsets = std::move(in_offsets);
+		m_in_sources = std::move(in_sources);
+
+		for(auto& pending : m_pending)
+			std::vector<std::pair<std::size_t, t_weight>>{}.swap(pending);
+		m_num_pending = 0;
+	}
+
+
+private:
+	std::vector<std::string> m_vertexidents{};
+	std::unordered_map<std::string, std::size_t> m_vertexindices{};
+
+	// outgoing edges of vertex i: [offsets[i], offsets[i+1])
+	std::vector<std::size_t> m_offsets{};
+	std::vector<std::size_t> m_targets{};
+	std::vector<t_weight> m_weights{};
+
+	// incoming edges
+	std::vector<std::size_t> m_in_offsets{};
+	std::vector<std::size_t> m_in_sources{};
+
+	// edges which have not yet been merged into the arrays
+	std::vector<std::vector<std::pair<std::size_t, t_weight>>> m_pending{};
+	std::size_t m_num_pending = 0;
+};
 // ----------------------------------------------------------------------------
 
 
@@ -818,7 +1138,7 @@ dijk(const t_graph& graph, const std::string& startvert,
 		std::pop_heap(distheap.begin(), distheap.end(), vert_cmp);
 		distheap.pop_back();
 
-		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx);
+		const auto neighbours = graph.GetNeighbours(vertidx);
 		for(std::size_t neighbouridx : neighbours)
 		{
 			// edge weight
@@ -949,7 +1269,7 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 		std::pop_heap(distheap.begin(), distheap.end(), vert_cmp);
 		distheap.pop_back();
 
-		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx);
+		const auto neighbours = graph.GetNeighbours(vertidx);
 		for(std::size_t neighbouridx : neighbours)
 		{
 			// edge weight
@@ -1014,6 +1334,334 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 }
 
 
+/**
+ * reusable buffers for dijkstra's algorithm with an indexed d-ary heap
+ *
+ * the vertex states are only valid if their stamp matches the current query's generation,
+ * so the buffers don't have to be re-initialised for every query.
+ */
+template<class _t_weight, std::size_t ARITY = 4>
+class DijkWorkspace
+{
+public:
+	using t_weight = _t_weight;
+	static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+
+public:
+	DijkWorkspace() = default;
+	~DijkWorkspace() = default;
+
+
+	/**
+	 * start a new query on a graph with num_verts vertices
+	 */
+	void Reset(std::size_t num_verts)
+	{
+		if(m_stamps.size() < num_verts)
+		{
+			m_dists.resize(num_verts);
+			m_keys.resize(num_verts);
+			m_predecessors.resize(num_verts);
+			m_heappos.resize(num_verts);
+			m_stamps.resize(num_verts, 0);
+		}
+
+		m_heap.clear();
+		m_num_settled = 0;
+
+		// all stamps are outdated after an overflow of the generation counter
+		if(++m_generation == 0)
+		{
+			std::fill(m_stamps.begin(), m_stamps.end(), 0);
+			m_generation = 1;
+		}
+	}
+
+
+	bool IsReached(std::size_t idx) const
+	{
+		return idx < m_stamps.size() && m_stamps[idx] == m_generation;
+	}
+
+
+	bool IsSettled(std::size_t idx) const
+	{
+		return IsReached(idx) && m_heappos[idx] == settled;
+	}
+
+
+	std::optional<t_weight> GetDistance(std::size_t idx) const
+	{
+		if(!IsReached(idx))
+			return std::nullopt;
+		return m_dists[idx];
+	}
+
+
+	std::optional<std::size_t> GetPredecessor(std::size_t idx) const
+	{
+		if(!IsReached(idx) || m_predecessors[idx] == npos)
+			return std::nullopt;
+		return m_predecessors[idx];
+	}
+
+
+	/**
+	 * number of vertices taken from the heap in the last query
+	 */
+	std::size_t GetNumSettled() const
+	{
+		return m_num_settled;
+	}
+
+
+	/**
+	 * get the vertex indices from the start vertex to the given one
+	 */
+	std::vector<std::size_t> GetPath(std::size_t idx) const
+	{
+		std::vector<std::size_t> path;
+		if(!IsReached(idx))
+			return path;
+
+		for(std::size_t cur = idx; cur != npos; cur = m_predecessors[cur])
+			path.push_back(cur);
+
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+
+
+	bool IsHeapEmpty() const
+	{
+		return m_heap.empty();
+	}
+
+
+	/**
+	 * insert a vertex or decrease its key if the new distance is shorter,
+	 * the heap is ordered by the key, which is the distance plus an optional heuristic
+	 * @returns true if the vertex has been updated
+	 */
+	bool Relax(std::size_t idx, t_weight dist, std::size_t predecessor, t_weight key)
+	{
+		if(!IsReached(idx))
+		{
+			m_stamps[idx] = m_generation;
+			m_dists[idx] = dist;
+			m_keys[idx] = key;
+			m_predecessors[idx] = predecessor;
+			m_heappos[idx] = m_heap.size();
+			m_heap.push_back(idx);
+			SiftUp(m_heap.size() - 1);
+			return true;
+		}
+
+		if(m_heappos[idx] == settled || !(dist < m_dists[idx]))
+			return false;
+
+		m_dists[idx] = dist;
+		m_keys[idx] = key;
+		m_predecessors[idx] = predecessor;
+		SiftUp(m_heappos[idx]);
+		return true;
+	}
+
+
+	bool Relax(std::size_t idx, t_weight dist, std::size_t predecessor)
+	{
+		return Relax(idx, dist, predecessor, dist);
+	}
+
+
+	/**
+	 * remove the vertex with the smallest key from the heap and mark it as settled
+	 */
+	std::size_t PopMin()
+	{
+		const std::size_t idx = m_heap.front();
+		const std::size_t last = m_heap.back();
+		m_heap.pop_back();
+
+		if(m_heap.size())
+		{
+			m_heap.front() = last;
+			m_heappos[last] = 0;
+			SiftDown(0);
+		}
+
+		m_heappos[idx] = settled;
+		++m_num_settled;
+		return idx;
+	}
+
+
+private:
+	void SiftUp(std::size_t pos)
+	{
+		const std::size_t idx = m_heap[pos];
+
+		while(pos > 0)
+		{
+			const std::size_t parent = (pos - 1) / ARITY;
+			if(!(m_keys[idx] < m_keys[m_heap[parent]]))
+				break;
+
+			m_heap[pos] = m_heap[parent];
+			m_heappos[m_heap[pos]] = pos;
+			pos = parent;
+		}
+
+		m_heap[pos] = idx;
+		m_heappos[idx] = pos;
+	}
+
+
+	void SiftDown(std::size_t pos)
+	{
+		const std::size_t idx = m_heap[pos];
+		const std::size_t size = m_heap.size();
+
+		while(true)
+		{
+			// find the child with the smallest key
+			const std::size_t first_child = pos*ARITY + 1;
+			if(first_child >= size)
+				break;
+
+			std::size_t min_child = first_child;
+			const std::size_t end_child = std::min(first_child + ARITY, size);
+			for(std::size_t child = first_child + 1; child < end_child; ++child)
+			{
+				if(m_keys[m_heap[child]] < m_keys[m_heap[min_child]])
+					min_child = child;
+			}
+
+			if(!(m_keys[m_heap[min_child]] < m_keys[idx]))
+				break;
+
+			m_heap[pos] = m_heap[min_child];
+			m_heappos[m_heap[pos]] = pos;
+			pos = min_child;
+		}
+
+		m_heap[pos] = idx;
+		m_heappos[idx] = pos;
+	}
+
+
+private:
+	// heap position marking a vertex whose distance is final
+	static constexpr std::size_t settled = npos;
+
+	std::vector<t_weight> m_dists{};
+	std::vector<t_weight> m_keys{};
+	std::vector<std::size_t> m_predecessors{};
+	std::vector<std::size_t> m_heappos{};
+	std::vector<std::uint32_t> m_stamps{};
+
+	// vertex indices in heap order
+	std::vector<std::size_t> m_heap{};
+
+	std::uint32_t m_generation = 0;
+	std::size_t m_num_settled = 0;
+};
+
+
+/**
+ * dijkstra algorithm using an indexed d-ary heap with decrease-key (no negative weights)
+ * stops as soon as the target vertex is settled, the results are kept in the workspace.
+ * with a heuristic function giving a consistent lower bound of the distance to the target,
+ * this becomes the a* algorithm.
+ * @returns true if the target has been reached, or if no target is given
+ * @see (Erickson 2019), p. 288
+ * @see https://en.wikipedia.org/wiki/D-ary_heap
+ * @see https://en.wikipedia.org/wiki/A*_search_algorithm
+ */
+template<class t_graph,
+	class t_weight_func =
+		std::optional<typename t_graph::t_weight>(std::size_t, std::size_t),
+	class t_heuristic_func =
+		typename t_graph::t_weight(std::size_t)>
+requires is_graph<t_graph>
+bool dijk_heap(const t_graph& graph, std::size_t startidx,
+	std::optional<std::size_t> targetidx,
+	DijkWorkspace<typename t_graph::t_weight>& workspace,
+	t_weight_func *weight_func = nullptr,
+	t_heuristic_func *heuristic_func = nullptr)
+{
+	using t_weight = typename t_graph::t_weight;
+	using t_workspace = DijkWorkspace<t_weight>;
+
+	const std::size_t N = graph.GetNumVertices();
+	workspace.Reset(N);
+	if(startidx >= N)
+		return false;
+
+	workspace.Relax(startidx, t_weight{}, t_workspace::npos);
+
+	while(!workspace.IsHeapEmpty())
+	{
+		const std::size_t vertidx = workspace.PopMin();
+		if(targetidx && vertidx == *targetidx)
+			return true;
+
+		const t_weight dist = *workspace.GetDistance(vertidx);
+		for(std::size_t neighbouridx : graph.GetNeighbours(vertidx))
+		{
+			// edge weight
+			std::optional<t_weight> w;
+
+			// directly get edge weight, or use user-supplied weight function
+			if(!weight_func)
+				w = graph.GetWeight(vertidx, neighbouridx);
+			else
+				w = (*weight_func)(vertidx, neighbouridx);
+
+			if(!w)
+				continue;
+
+			const t_weight new_dist = dist + *w;
+			if(heuristic_func)
+				workspace.Relax(neighbouridx, new_dist, vertidx, new_dist + (*heuristic_func)(neighbouridx));
+			else
+				workspace.Relax(neighbouridx, new_dist, vertidx);
+		}
+	}
+
+	return !targetidx;
+}
+
+
+/**
+ * dijkstra algorithm using an indexed d-ary heap, returning all predecessors like dijk()
+ */
+template<class t_graph,
+	class t_weight_func =
+		std::optional<typename t_graph::t_weight>(std::size_t, std::size_t)>
+requires is_graph<t_graph>
+std::vector<std::optional<std::size_t>>
+dijk_heap(const t_graph& graph, const std::string& startvert,
+	t_weight_func *weight_func = nullptr)
+{
+	// start index
+	auto startidx = graph.GetVertexIndex(startvert);
+	if(!startidx)
+		return {};
+
+	DijkWorkspace<typename t_graph::t_weight> workspace;
+	dijk_heap<t_graph, t_weight_func>(graph, *startidx, std::nullopt, workspace, weight_func);
+
+	const std::size_t N = graph.GetNumVertices();
+	std::vector<std::optional<std::size_t>> predecessors(N);
+	for(std::size_t vertidx=0; vertidx<N; ++vertidx)
+		predecessors[vertidx] = workspace.GetPredecessor(vertidx);
+
+	return predecessors;
+}
+
+
 /**
  * bellman-ford algorithm
  * @see (FUH 2021), Kurseinheit 4, p. 13
@@ -1058,7 +1706,7 @@ bellman(const t_graph& graph, const std::string& startvert,
 		{
 			dists(i, vertidx) = dists(i-1, vertidx);
 
-			std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx, false);
+			const auto neighbours = graph.GetNeighbours(vertidx, false);
 			for(std::size_t neighbouridx : neighbours)
 			{
 				// edge weight
@@ -1107,7 +1755,7 @@ t_mat floyd(const t_graph& graph)
 	// initial weights
 	for(std::size_t vertidx1=0; vertidx1<N; ++vertidx1)
 	{
-		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx1);
+		const auto neighbours = graph.GetNeighbours(vertidx1);
 
 		for(std::size_t vertidx2=0; vertidx2<N; ++vertidx2)
 		{
@@ -44,6 +44,8 @@
 #include <tuple>
 #include <algorithm>
 #include <limits>
+#include <optional>
+#include <cmath>
 #include <iostream>
 
 #include <boost/intrusive/bstree.hpp>
@@ -708,6 +710,342 @@ requires tl2::is_vec<t_vec>
 		}
 	}
 }
+
+
+/**
+ * uniform grid of the line segments of several closed contours,
+ * used to check the distance of new line segments to the other contours.
+ * the coordinates are scaled by (scale_x, scale_y).
+ */
+template<class t_vec, class t_real = typename t_vec::value_type>
+requires tl2::is_vec<t_vec>
+class ContourSegmentGrid
+{
+protected:
+	struct Segment
+	{
+		t_real x1{}, y1{}, x2{}, y2{};
+		std::size_t contouridx{};
+	};
+
+
+public:
+	/**
+	 * index the segments of the contours, for cell_size <= 0
+	 * the cell size is chosen from the number of segments
+	 */
+	ContourSegmentGrid(const std::vector<std::vector<t_vec>>& contours,
+		t_real scale_x = 1, t_real scale_y = 1, t_real cell_size = 0)
+		: m_scale_x{scale_x}, m_scale_y{scale_y}
+	{
+		t_real min_x = std::numeric_limits<t_real>::max(), min_y = min_x;
+		t_real max_x = std::numeric_limits<t_real>::lowest(), max_y = max_x;
+
+		for(std::size_t contouridx=0; contouridx<contours.size(); ++contouridx)
+		{
+			const auto& contour = contours[contouridx];
+			for(std::size_t idx1=0; idx1<contour.size(); ++idx1)
+			{
+				const t_vec& vert1 = contour[idx1];
+				const t_vec& vert2 = contour[(idx1 + 1) % contour.size()];
+
+				Segment seg{
+					.x1 = scale_x * t_real(vert1[0]), .y1 = scale_y * t_real(vert1[1]),
+					.x2 = scale_x * t_real(vert2[0]), .y2 = scale_y * t_real(vert2[1]),
+					.contouridx = contouridx };
+
+				min_x = std::min({ min_x, seg.x1, seg.x2 });
+				min_y = std::min({ min_y, seg.y1, seg.y2 });
+				max_x = std::max({ max_x, seg.x1, seg.x2 });
+				max_y = std::max({ max_y, seg.y1, seg.y2 });
+
+				m_segments.emplace_back(std::move(seg));
+			}
+		}
+
+		if(m_segments.empty())
+			return;
+
+		// about one segment per cell
+		if(cell_size <= 0)
+			cell_size = std::sqrt((max_x - min_x) * (max_y - min_y) / t_real(m_segments.size()));
+		if(cell_size <= std::numeric_limits<t_real>::epsilon())
+			cell_size = 1;
+
+		m_cell_size = cell_size;
+		m_min_x = min_x;
+		m_min_y = min_y;
+		m_cells_x = std::size_t((max_x - min_x) / cell_size) + 1;
+		m_cells_y = std::size_t((max_y - min_y) / cell_size) + 1;
+		m_cells.resize(m_cells_x * m_cells_y);
+
+		for(std::size_t segidx=0; segidx<m_segments.size(); ++segidx)
+		{
+			const Segment& seg = m_segments[segidx];
+			auto [x_begin, x_end, y_begin, y_end] = get_cell_range(
+				std::min(seg.x1, seg.x2), std::max(seg.x1, seg.x2),
+				std::min(seg.y1, seg.y2), std::max(seg.y1, seg.y2));
+
+			for(std::size_t y=y_begin; y<y_end; ++y)
+				for(std::size_t x=x_begin; x<x_end; ++x)
+					m_cells[y*m_cells_x + x].push_back(segidx);
+		}
+	}
+
+
+	/**
+	 * is the line segment (vert1, vert2) closer than dist to
+	 * a segment of a contour other than the given one?
+	 */
+	bool IsClose(std::size_t contouridx, const t_vec& vert1, const t_vec& vert2, t_real dist) const
+	{
+		if(m_cells.empty())
+			return false;
+
+		const t_real x1 = m_scale_x * t_real(vert1[0]), y1 = m_scale_y * t_real(vert1[1]);
+		const t_real x2 = m_scale_x * t_real(vert2[0]), y2 = m_scale_y * t_real(vert2[1]);
+
+		auto [x_begin, x_end, y_begin, y_end] = get_cell_range(
+			std::min(x1, x2) - dist, std::max(x1, x2) + dist,
+			std::min(y1, y2) - dist, std::max(y1, y2) + dist);
+
+		for(std::size_t y=y_begin; y<y_end; ++y)
+		{
+			for(std::size_t x=x_begin; x<x_end; ++x)
+			{
+				for(std::size_t segidx : m_cells[y*m_cells_x + x])
+				{
+					const Segment& seg = m_segments[segidx];
+					if(seg.contouridx == contouridx)
+						continue;
+
+					if(get_dist(x1, y1, x2, y2, seg) < dist)
+						return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+
+protected:
+	/**
+	 * get the cell ranges [begin, end) covering a bounding box
+	 */
+	std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>
+	get_cell_range(t_real min_x, t_real max_x, t_real min_y, t_real max_y) const
+	{
+		auto get_cell = [this](t_real coord, t_real min, std::size_t num) -> std::size_t
+		{
+			t_real cell = std::floor((coord - min) / m_cell_size);
+			if(cell < 0)
+				return 0;
+			return std::min(std::size_t(cell), num - 1);
+		};
+
+		return std::make_tuple(
+			get_cell(min_x, m_min_x, m_cells_x), get_cell(max_x, m_min_x, m_cells_x) + 1,
+			get_cell(min_y, m_min_y, m_cells_y), get_cell(max_y, m_min_y, m_cells_y) + 1);
+	}
+
+
+	/**
+	 * distance between two line segments
+	 */
+	static t_real get_dist(t_real x1, t_real y1, t_real x2, t_real y2, const Segment& seg)
+	{
+		auto side = [](t_real ax, t_real ay, t_real bx, t_real by, t_real px, t_real py) -> t_real
+		{
+			return (bx - ax)*(py - ay) - (by - ay)*(px - ax);
+		};
+
+		auto dist_pt_seg = [](t_real ax, t_real ay, t_real bx, t_real by, t_real px, t_real py) -> t_real
+		{
+			const t_real dir_x = bx - ax, dir_y = by - ay;
+			const t_real len_sq = dir_x*dir_x + dir_y*dir_y;
+
+			t_real param = len_sq > 0 ? ((px - ax)*dir_x + (py - ay)*dir_y) / len_sq : 0;
+			param = std::clamp<t_real>(param, 0, 1);
+
+			const t_real dx = ax + param*dir_x - px;
+			const t_real dy = ay + param*dir_y - py;
+			return std::sqrt(dx*dx + dy*dy);
+		};
+
+		// proper intersection
+		if(side(x1, y1, x2, y2, seg.x1, seg.y1) * side(x1, y1, x2, y2, seg.x2, seg.y2) < 0 &&
+			side(seg.x1, seg.y1, seg.x2, seg.y2, x1, y1) * side(seg.x1, seg.y1, seg.x2, seg.y2, x2, y2) < 0)
+			return 0;
+
+		return std::min({
+			dist_pt_seg(x1, y1, x2, y2, seg.x1, seg.y1),
+			dist_pt_seg(x1, y1, x2, y2, seg.x2, seg.y2),
+			dist_pt_seg(seg.x1, seg.y1, seg.x2, seg.y2, x1, y1),
+			dist_pt_seg(seg.x1, seg.y1, seg.x2, seg.y2, x2, y2) });
+	}
+
+
+private:
+	t_real m_scale_x{1}, m_scale_y{1};
+	t_real m_cell_size{1};
+	t_real m_min_x{0}, m_min_y{0};
+	std::size_t m_cells_x{0}, m_cells_y{0};
+
+	std::vector<Segment> m_segments{};
+	std::vector<std::vector<std::size_t>> m_cells{};
+};
+
+
+/**
+ * decimate a closed contour line using the douglas-peucker algorithm
+ * @see https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
+ *
+ * the removed vertices are at most max_dist away from the new line segments,
+ * the distances are measured with the coordinates scaled by (scale_x, scale_y).
+ * if conservative is set, the vertices are only removed if they are on the
+ * left side of the new line segments, i.e. the region on the left of the
+ * contour can only grow and never shrinks.
+ *
+ * if a segment grid of the original contours is given, new line segments
+ * closer than max_dist to any other contour are split further. as the
+ * new line segments also stay within max_dist of their original contour,
+ * contours decimated against the same grid cannot intersect each other.
+ * returns the number of removed vertices.
+ */
+template<class t_vec, class t_real = typename t_vec::value_type>
+std::size_t decimate_contour(
+	std::vector<t_vec>& contour, t_real max_dist,
+	bool conservative = true,
+	t_real scale_x = 1, t_real scale_y = 1,
+	t_real eps = 1e-6,
+	const ContourSegmentGrid<t_vec, t_real>* grid = nullptr,
+	std::size_t contouridx = 0)
+requires tl2::is_vec<t_vec>
+{
+	const std::size_t N = contour.size();
+	if(N <= 3)
+		return 0;
+
+	// signed distance of a vertex from a line, positive on the left side
+	auto get_dist = [&contour, N, scale_x, scale_y](
+		std::size_t idx1, std::size_t idx2, std::size_t idx) -> t_real
+	{
+		const t_vec& vert1 = contour[idx1 % N];
+		const t_vec& vert2 = contour[idx2 % N];
+		const t_vec& vert = contour[idx % N];
+
+		t_real dir_x = scale_x * t_real(vert2[0] - vert1[0]);
+		t_real dir_y = scale_y * t_real(vert2[1] - vert1[1]);
+		t_real pos_x = scale_x * t_real(vert[0] - vert1[0]);
+		t_real pos_y = scale_y * t_real(vert[1] - vert1[1]);
+
+		t_real len = std::sqrt(dir_x*dir_x + dir_y*dir_y);
+		if(len <= std::numeric_limits<t_real>::epsilon())
+			return std::sqrt(pos_x*pos_x + pos_y*pos_y);
+
+		return (dir_x*pos_y - dir_y*pos_x) / len;
+	};
+
+	// the first vertex and the one farthest away from it are always kept
+	std::size_t idx_far = 0;
+	t_real dist_far = -1;
+	for(std::size_t idx=1; idx<N; ++idx)
+	{
+		t_real dx = scale_x * t_real(contour[idx][0] - contour[0][0]);
+		t_real dy = scale_y * t_real(contour[idx][1] - contour[0][1]);
+		t_real dist = dx*dx + dy*dy;
+
+		if(dist > dist_far)
+		{
+			dist_far = dist;
+			idx_far = idx;
+		}
+	}
+
+	std::vector<bool> keep(N, false);
+	keep[0] = keep[idx_far] = true;
+
+	// vertex ranges to check, the end index can wrap around
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	ranges.reserve(N);
+	ranges.emplace_back(std::make_pair(0, idx_far));
+	ranges.emplace_back(std::make_pair(idx_far, N));
+
+	while(ranges.size())
+	{
+		auto [idx1, idx2] = ranges.back();
+		ranges.pop_back();
+
+		if(idx2 <= idx1 + 1)
+			continue;
+
+		// find the vertex violating the bounds the most
+		std::optional<std::size_t> idx_split;
+		t_real dist_split = 0;
+		bool split_right = false;
+
+		// vertex farthest away from the new line
+		std::size_t idx_maxdev = idx1 + 1;
+		t_real dist_maxdev = -1;
+
+		for(std::size_t idx=idx1+1; idx<idx2; ++idx)
+		{
+			t_real dist = get_dist(idx1, idx2, idx);
+			if(std::abs(dist) > dist_maxdev)
+			{
+				idx_maxdev = idx;
+				dist_maxdev = std::abs(dist);
+			}
+
+			// vertices on the right side of the new line always need to be kept
+			bool right = conservative && dist < -eps;
+
+			if(right && (!split_right || -dist > dist_split))
+			{
+				idx_split = idx;
+				dist_split = -dist;
+				split_right = true;
+			}
+			else if(!split_right && std::abs(dist) > max_dist && std::abs(dist) > dist_split)
+			{
+				idx_split = idx;
+				dist_split = std::abs(dist);
+			}
+		}
+
+		// the new line must not come close to the other contours
+		if(!idx_split && grid && grid->IsClose(contouridx,
+			contour[idx1 % N], contour[idx2 % N], max_dist + eps))
+			idx_split = idx_maxdev;
+
+		if(!idx_split)
+			continue;
+
+		keep[*idx_split % N] = true;
+		ranges.emplace_back(std::make_pair(idx1, *idx_split));
+		ranges.emplace_back(std::make_pair(*idx_split, idx2));
+	}
+
+	// keep at least a triangle
+	if(std::count(keep.begin(), keep.end(), true) < 3)
+		return 0;
+
+	// remove the vertices not kept
+	std::size_t num_kept = 0;
+	for(std::size_t idx=0; idx<N; ++idx)
+	{
+		if(!keep[idx])
+			continue;
+
+		if(num_kept != idx)
+			contour[num_kept] = std::move(contour[idx]);
+		++num_kept;
+	}
+
+	contour.resize(num_kept);
+	return N - num_kept;
+}
 // ----------------------------------------------------------------------------
 
 }
@@ -46,7 +46,17 @@
 
 #include <concepts>
 #include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <sstream>
+#include <stdexcept>
 
 #ifdef USE_GIL
 	#include <boost/gil/image.hpp>
@@ -136,13 +146,21 @@ public:
 
 	Image<t_pixel>& operator=(const Image<t_pixel>& img)
 	{
-		Init(img.GetWidth(), img.GetHeight());
+		if(this == &img)
+			return *this;
+
+		if(GetWidth() != img.GetWidth() || GetHeight() != img.GetHeight())
+			Init(img.GetWidth(), img.GetHeight());
 		SetImage(img.m_img.get());
 
 		return *this;
 	}
 
 
+	Image(Image<t_pixel>&& img) = default;
+	Image<t_pixel>& operator=(Image<t_pixel>&& img) = default;
+
+
 	void Init(std::size_t w, std::size_t h)
 	{
 		m_width = w;
@@ -188,9 +206,8 @@ public:
 
 	void SetImage(const t_pixel* img)
 	{
-		for(std::size_t y = 0; y < GetHeight(); ++y)
-			for(std::size_t x = 0; x < GetWidth(); ++x)
-				SetPixel(x, y, img[y*GetWidth() + x]);
+		if(img)
+			std::copy(img, img + GetWidth()*GetHeight(), m_img.get());
 	}
 
 
@@ -198,6 +215,331 @@ private:
 	std::size_t m_width{}, m_height{};
 	std::unique_ptr<t_pixel[]> m_img{};
 };
+
+
+/**
+ * image class storing every pixel in only a few bits:
+ *   - the pixel values are mapped to 2^bits codes using a small palette,
+ *     which is filled in the order in which new values are set
+ *   - the rows are padded to whole words, so row spans of equal pixels
+ *     can be skipped word by word
+ *   - optionally, a run-length encoded representation of the rows
+ *     can be created for a read-only image
+ * @note setting pixels is not thread-safe, even for different pixels
+ */
+template<class t_pixel = std::uint8_t, unsigned BITS = 2>
+requires (BITS == 1 || BITS == 2 || BITS == 4)
+class PackedImage
+{
+public:
+	using value_type = t_pixel;
+	using t_word = std::uint64_t;
+
+	static constexpr unsigned NUM_CODES = (1u << BITS);
+	static constexpr std::size_t PIXELS_PER_WORD = sizeof(t_word)*8 / BITS;
+	static constexpr t_word CODE_MASK = t_word(NUM_CODES - 1);
+
+	/**
+	 * run of equal pixels in a row, [begin, end)
+	 */
+	struct Run
+	{
+		std::size_t begin{}, end{};
+		t_pixel value{};
+	};
+
+
+public:
+	PackedImage() = default;
+	~PackedImage() = default;
+
+	PackedImage(std::size_t w, std::size_t h)
+	{
+		Init(w, h);
+	}
+
+	PackedImage(const PackedImage<t_pixel, BITS>& img) = default;
+	PackedImage(PackedImage<t_pixel, BITS>&& img) = default;
+	PackedImage<t_pixel, BITS>& operator=(const PackedImage<t_pixel, BITS>& img) = default;
+	PackedImage<t_pixel, BITS>& operator=(PackedImage<t_pixel, BITS>&& img) = default;
+
+
+	void Init(std::size_t w, std::size_t h)
+	{
+		m_width = w;
+		m_height = h;
+		m_words_per_row = (w + PIXELS_PER_WORD - 1) / PIXELS_PER_WORD;
+
+		m_words.assign(m_words_per_row * h, t_word{0});
+		ResetPalette();
+		ClearRuns();
+	}
+
+
+	void Clear()
+	{
+		m_width = 0;
+		m_height = 0;
+		m_words_per_row = 0;
+
+		m_words.clear();
+		m_words.shrink_to_fit();
+		ResetPalette();
+		ClearRuns();
+	}
+
+
+	std::size_t GetWidth() const
+	{
+		return m_width;
+	}
+
+
+	std::size_t GetHeight() const
+	{
+		return m_height;
+	}
+
+
+	t_pixel GetPixel(std::size_t x, std::size_t y) const
+	{
+		if(x < GetWidth() && y < GetHeight())
+			return m_palette[GetCode(x, y)];
+		return t_pixel{};
+	}
+
+
+	void SetPixel(std::size_t x, std::size_t y, t_pixel pix)
+	{
+		if(x >= GetWidth() || y >= GetHeight())
+			return;
+
+		t_word& word = m_words[y*m_words_per_row + x/PIXELS_PER_WORD];
+		const unsigned shift = (x % PIXELS_PER_WORD) * BITS;
+
+		word &= ~(CODE_MASK << shift);
+		word |= (t_word(GetPaletteCode(pix)) << shift);
+
+		m_has_runs = false;
+	}
+
+
+	/**
+	 * get the number of bytes used by the pixel data
+	 */
+	std::size_t GetMemorySize() const
+	{
+		return m_words.size()*sizeof(t_word) + m_runs.size()*sizeof(Run)
+			+ m_row_runs.size()*sizeof(std::size_t);
+	}
+
+
+	/**
+	 * create the run-length encoded rows,
+	 * they stay valid until the next pixel is set
+	 */
+	void CreateRuns()
+	{
+		m_runs.clear();
+		m_row_runs.clear();
+		m_row_runs.reserve(GetHeight() + 1);
+		m_row_runs.push_back(0);
+
+		for(std::size_t y=0; y<GetHeight(); ++y)
+		{
+			ScanRuns(y, [this](std::size_t begin, std::size_t end, t_pixel pix) -> bool
+			{
+				m_runs.emplace_back(Run{begin, end, pix});
+				return true;
+			});
+
+			m_row_runs.push_back(m_runs.size());
+		}
+
+		m_runs.shrink_to_fit();
+		m_has_runs = true;
+	}
+
+
+	void ClearRuns()
+	{
+		m_runs.clear();
+		m_runs.shrink_to_fit();
+		m_row_runs.clear();
+		m_row_runs.shrink_to_fit();
+		m_has_runs = false;
+	}
+
+
+	bool HasRuns() const
+	{
+		return m_has_runs;
+	}
+
+
+	/**
+	 * iterate the runs of equal pixels in a row,
+	 * func(begin, end, pixel) returns false to stop the iteration
+	 */
+	template<class t_func>
+	void ForEachRun(std::size_t y, t_func&& func) const
+	{
+		if(y >= GetHeight())
+			return;
+
+		if(HasRuns())
+		{
+			for(std::size_t idx=m_row_runs[y]; idx<m_row_runs[y + 1]; ++idx)
+			{
+				const Run& run = m_runs[idx];
+				if(!func(run.begin, run.end, run.value))
+					break;
+			}
+		}
+		else
+		{
+			ScanRuns(y, std::forward<t_func>(func));
+		}
+	}
+
+
+	/**
+	 * get the run of equal pixels containing the given pixel
+	 */
+	Run GetRun(std::size_t x, std::size_t y) const
+	{
+		if(x >= GetWidth() || y >= GetHeight())
+			return Run{x, x + 1, t_pixel{}};
+
+		if(HasRuns())
+		{
+			// find the first run ending after x
+			auto iter = std::upper_bound(
+				m_runs.begin() + m_row_runs[y], m_runs.begin() + m_row_runs[y + 1], x,
+				[](std::size_t pos, const Run& run) -> bool
+				{
+					return pos < run.end;
+				});
+
+			return *iter;
+		}
+
+		// scan to the left and to the right
+		const unsigned code = GetCode(x, y);
+		std::size_t begin = x, end = x + 1;
+
+		while(begin > 0 && GetCode(begin - 1, y) == code)
+			--begin;
+		end = SkipEqual(y, end, code);
+
+		return Run{begin, end, m_palette[code]};
+	}
+
+
+protected:
+	unsigned GetCode(std::size_t x, std::size_t y) const
+	{
+		const t_word word = m_words[y*m_words_per_row + x/PIXELS_PER_WORD];
+		const unsigned shift = (x % PIXELS_PER_WORD) * BITS;
+
+		return unsigned((word >> shift) & CODE_MASK);
+	}
+
+
+	/**
+	 * get the code of a pixel value, adding it to the palette if needed,
+	 * values that don't fit into the full palette are rejected
+	 */
+	unsigned GetPaletteCode(t_pixel pix)
+	{
+		for(unsigned code=0; code<m_num_codes; ++code)
+		{
+			if(m_palette[code] == pix)
+				return code;
+		}
+
+		if(m_num_codes >= NUM_CODES)
+		{
+			std::ostringstream ostrErr;
+			ostrErr << "Pixel value does not fit into the palette of "
+				<< NUM_CODES << " values.";
+			throw std::out_of_range(ostrErr.str());
+		}
+
+		m_palette[m_num_codes] = pix;
+		return m_num_codes++;
+	}
+
+
+	void ResetPalette()
+	{
+		// code 0 is always the empty pixel
+		m_palette.fill(t_pixel{});
+		m_num_codes = 1;
+	}
+
+
+	/**
+	 * get the end of the run of pixels with the given code starting at x
+	 */
+	std::size_t SkipEqual(std::size_t y, std::size_t x, unsigned code) const
+	{
+		// code repeated over a whole word
+		const t_word full_word = (~t_word{0} / CODE_MASK) * t_word(code);
+		const t_word* row = m_words.data() + y*m_words_per_row;
+
+		while(x < GetWidth())
+		{
+			// skip whole words of equal pixels
+			if(x % PIXELS_PER_WORD == 0 && x + PIXELS_PER_WORD <= GetWidth()
+				&& row[x / PIXELS_PER_WORD] == full_word)
+			{
+				x += PIXELS_PER_WORD;
+				continue;
+			}
+
+			if(GetCode(x, y) != code)
+				break;
+			++x;
+		}
+
+		return x;
+	}
+
+
+	/**
+	 * iterate the runs of equal pixels in a row using the packed words
+	 */
+	template<class t_func>
+	void ScanRuns(std::size_t y, t_func&& func) const
+	{
+		for(std::size_t x=0; x<GetWidth();)
+		{
+			const unsigned code = GetCode(x, y);
+			const std::size_t end = SkipEqual(y, x + 1, code);
+
+			if(!func(x, end, m_palette[code]))
+				break;
+			x = end;
+		}
+	}
+
+
+private:
+	std::size_t m_width{}, m_height{};
+	std::size_t m_words_per_row{};
+	std::vector<t_word> m_words{};
+
+	// pixel values of the codes
+	std::array<t_pixel, NUM_CODES> m_palette{};
+	unsigned m_num_codes{1};
+
+	// run-length encoded rows, the runs of row y are
+	// stored at the indices [m_row_runs[y], m_row_runs[y + 1])
+	std::vector<Run> m_runs{};
+	std::vector<std::size_t> m_row_runs{};
+	bool m_has_runs{false};
+};
 // ----------------------------------------------------------------------------
 
 
@@ -285,6 +627,40 @@ std::pair<std::size_t, std::size_t> get_image_dims(const t_imageview& img)
 {
 	return std::make_pair(img.width(), img.height());
 }
+
+
+/**
+ * iterate the runs of equal pixels [begin, end) in an image row,
+ * func(begin, end, pixel) returns false to stop the iteration;
+ * uses the image's own run iteration if it has one
+ */
+template<class t_imageview, class t_func>
+void for_each_run(const t_imageview& img, std::size_t y, t_func&& func)
+{
+	if constexpr(requires { img.ForEachRun(y, func); })
+	{
+		img.ForEachRun(y, std::forward<t_func>(func));
+	}
+	else
+	{
+		auto [width, height] = get_image_dims(img);
+		if(y >= height)
+			return;
+
+		for(std::size_t x=0; x<width;)
+		{
+			auto pix = get_pixel(img, x, y);
+
+			std::size_t end = x + 1;
+			while(end < width && get_pixel(img, end, y) == pix)
+				++end;
+
+			if(!func(x, end, pix))
+				break;
+			x = end;
+		}
+	}
+}
 // ----------------------------------------------------------------------------
 
 
@@ -293,30 +669,25 @@ std::pair<std::size_t, std::size_t> get_image_dims(const t_imageview& img)
 // algorithms
 // ----------------------------------------------------------------------------
 /**
- * contour tracing
+ * trace the contours starting in the rows [y_begin, y_end)
  * @see http://www.imageprocessingplace.com/downloads_V3/root_downloads/tutorials/contour_tracing_Abeer_George_Ghuneim/ray.html
+ *
+ * the start pixels are the beginnings of the set pixel spans, the visited
+ * contour pixels are marked in a bitmap to skip the contours already found.
+ * if a contour reaches a possible start pixel before y_begin it is dropped,
+ * because it has already been found when tracing the preceding rows.
  */
 template<class t_vec,
 	class t_imageview, class t_boundaryview = t_imageview>
 requires tl2::is_vec<t_vec>
-std::vector<std::vector<t_vec>> trace_contour(
-	const t_imageview& img, t_boundaryview* boundary = nullptr)
+std::vector<std::vector<t_vec>> trace_contour_rows(
+	const t_imageview& img, int y_begin, int y_end,
+	std::vector<bool>& visited, t_boundaryview* boundary = nullptr,
+	std::vector<t_vec>* starts = nullptr)
 {
 	// contour polygons
 	std::vector<std::vector<t_vec>> contours;
-
-
-	// contour already seen?
-	auto already_seen = [&contours](const t_vec& vec) -> bool
-	{
-		for(const auto& contour : contours)
-		{
-			if(std::find(contour.begin(), contour.end(), vec) != contour.end())
-				return true;
-		}
-
-		return false;
-	};
+	auto [width, height] = get_image_dims(img);
 
 
 	// next possible position depending on direction
@@ -356,8 +727,19 @@ std::vector<std::vector<t_vec>> trace_contour(
 	};
 
 
-	// find multiple contours
-	t_vec start = tl2::create<t_vec>({0, 0});
+	auto is_visited = [&visited, width](int x, int y) -> bool
+	{
+		return visited[std::size_t(y)*std::size_t(width) + std::size_t(x)];
+	};
+
+	auto set_visited = [&visited, width](int x, int y)
+	{
+		visited[std::size_t(y)*std::size_t(width) + std::size_t(x)] = true;
+	};
+
+
+	// find multiple contours, resuming the start pixel search at the last start pixel
+	t_vec start = tl2::create<t_vec>({0, y_begin});
 
 	while(true)
 	{
@@ -365,27 +747,29 @@ std::vector<std::vector<t_vec>> trace_contour(
 
 		// find start pixel
 		bool start_found = false;
-		auto [width, height] = get_image_dims(img);
+		const int resume_x = start[0];
+		const int resume_y = start[1];
 
-		for(int y=start[1]; y<(int)height; ++y)
+		for(int y=resume_y; y<y_end; ++y)
 		{
-			for(int x=0; x<(int)width; ++x)
+			// only the beginnings of the set spans are possible start pixels,
+			// for multiple contours: skip positions inside a contour
+			bool prev_set = false;
+
+			for_each_run(img, y, [&](std::size_t begin, std::size_t, auto pix) -> bool
 			{
-				if(get_pixel(img, x, y))
+				const bool set = bool(pix);
+				if(set && !prev_set && (y != resume_y || int(begin) >= resume_x)
+					&& !is_visited(int(begin), y))
 				{
-					// for multiple contours: inside a contour
-					if(get_pixel(img, x-1, y))
-						continue;
-
-					t_vec vec = tl2::create<t_vec>({x, y});
-					if(already_seen(vec))
-						continue;
-
-					start = vec;
+					start = tl2::create<t_vec>({int(begin), y});
 					start_found = true;
-					break;
+					return false;
 				}
-			}
+
+				prev_set = set;
+				return true;
+			});
 
 			if(start_found)
 				break;
@@ -394,6 +778,7 @@ std::vector<std::vector<t_vec>> trace_contour(
 		if(!start_found)
 			return contours;
 
+		set_visited(start[0], start[1]);
 		//contour.push_back(start);
 		if(boundary)
 			set_pixel<t_boundaryview>(*boundary, start[0], start[1], 0xff);
@@ -403,6 +788,7 @@ std::vector<std::vector<t_vec>> trace_contour(
 		t_vec pos = start;
 		t_vec dir = tl2::create<t_vec>({1, 0});
 		t_vec next_dir = tl2::create<t_vec>({0, 0});
+		bool found_before = false;
 
 		while(true)
 		{
@@ -430,8 +816,16 @@ std::vector<std::vector<t_vec>> trace_contour(
 					pos[1] += dir[1];
 
 					contour.push_back(pos);
+					set_visited(pos[0], pos[1]);
 					if(boundary)
 						set_pixel<t_boundaryview>(*boundary, pos[0], pos[1], 0xff);
+
+					// possible start pixel in the preceding rows?
+					if(pos[1] < y_begin && !get_pixel(img, pos[0]-1, pos[1]))
+					{
+						found_before = true;
+						break;
+					}
 				}
 			}
 			else
@@ -444,48 +838,315 @@ std::vector<std::vector<t_vec>> trace_contour(
 				break;
 		}
 
-		if(contour.size())
+		if(contour.size() && !found_before)
+		{
 			contours.emplace_back(std::move(contour));
-		else
-			break;
+			if(starts)
+				starts->push_back(start);
+		}
 	}
 
 	return contours;
 }
 
 
-#ifdef USE_OCV
 /**
- * contour tracing using opencv
- * @see https://docs.opencv.org/4.x/index.html
- * @see https://github.com/opencv/opencv
+ * contour tracing
  */
 template<class t_vec,
 	class t_imageview, class t_boundaryview = t_imageview>
 requires tl2::is_vec<t_vec>
-std::vector<std::vector<t_vec>> trace_contour_ocv(const t_imageview& img)
+std::vector<std::vector<t_vec>> trace_contour(
+	const t_imageview& img, t_boundaryview* boundary = nullptr)
 {
-	// convert from internal image format
 	auto [width, height] = get_image_dims(img);
-	cv::Mat mat(height, width, CV_8U);
+	std::vector<bool> visited(std::size_t(width) * std::size_t(height), false);
 
-	for(std::size_t y = 0; y < height; ++y)
-		for(std::size_t x = 0; x < width; ++x)
-			mat.at<std::uint8_t>(y, x) = get_pixel(img, x, y);
+	return trace_contour_rows<t_vec, t_imageview, t_boundaryview>(
+		img, 0, int(height), visited, boundary);
+}
 
-	// find contours
-	std::vector<std::vector<cv::Point>> contours;
-	std::vector<cv::Vec4i> hierarchy;
-	cv::findContours(mat, contours, hierarchy,
-		cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
 
-	// debug output
-	/*cv::Mat cont_mat(height, width, CV_8UC3, cv::Scalar{0, 0, 0});
-	cv::drawContours(cont_mat, contours, -1, cv::Scalar{0xff, 0xff, 0xff});
-	cv::imwrite("/users/tw/tmp/taspaths_cont_0.png", mat);
-	cv::imwrite("/users/tw/tmp/taspaths_cont_1.png", cont_mat);*/
+/**
+ * contour tracing with the image split into bands of rows,
+ * the bands are traced in parallel using their own visited bitmaps;
+ * the contours reaching into a preceding band are left to that band.
+ * afterwards, the contours are merged in band order and
+ * any remaining contours are traced sequentially.
+ */
+template<class t_vec, class t_imageview>
+requires tl2::is_vec<t_vec>
+std::vector<std::vector<t_vec>> trace_contour_parallel(
+	const t_imageview& img, unsigned int num_threads = 4)
+{
+	auto [width, height] = get_image_dims(img);
+	const std::size_t num_pixels = std::size_t(width) * std::size_t(height);
 
-	// convert to internal vector format
+	num_threads = std::max<unsigned int>(1, std::min<unsigned int>(num_threads, height / 64));
+	if(num_threads <= 1)
+		return trace_contour<t_vec, t_imageview>(img);
+
+	// trace the bands
+	std::vector<std::vector<std::vector<t_vec>>> band_contours(num_threads);
+	std::vector<std::vector<t_vec>> band_starts(num_threads);
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads);
+
+	for(unsigned int band=0; band<num_threads; ++band)
+	{
+		threads.emplace_back([&img, &band_contours, &band_starts, band, num_threads, height, num_pixels]()
+		{
+			const int y_begin = int(std::size_t(height) * band / num_threads);
+			const int y_end = int(std::size_t(height) * (band + 1) / num_threads);
+
+			std::vector<bool> visited(num_pixels, false);
+			band_contours[band] = trace_contour_rows<t_vec, t_imageview, t_imageview>(
+				img, y_begin, y_end, visited, nullptr, &band_starts[band]);
+		});
+	}
+
+	for(std::thread& thread : threads)
+		thread.join();
+
+	// merge the contours, skipping any already found ones
+	std::vector<bool> visited(num_pixels, false);
+	std::vector<std::vector<t_vec>> contours;
+
+	for(unsigned int band=0; band<num_threads; ++band)
+	{
+		for(std::size_t idx=0; idx<band_contours[band].size(); ++idx)
+		{
+			auto& contour = band_contours[band][idx];
+			const t_vec& start = band_starts[band][idx];
+			if(visited[std::size_t(start[1])*std::size_t(width) + std::size_t(start[0])])
+				continue;
+
+			visited[std::size_t(start[1])*std::size_t(width) + std::size_t(start[0])] = true;
+			for(const t_vec& pos : contour)
+				visited[std::size_t(pos[1])*std::size_t(width) + std::size_t(pos[0])] = true;
+			contours.emplace_back(std::move(contour));
+		}
+	}
+
+	// trace the contours which none of the bands has kept
+	auto remaining = trace_contour_rows<t_vec, t_imageview>(img, 0, int(height), visited);
+	for(auto& contour : remaining)
+		contours.emplace_back(std::move(contour));
+
+	return contours;
+}
+
+
+/**
+ * sub-pixel contour lines around the set pixels using marching squares
+ * @see https://en.wikipedia.org/wiki/Marching_squares
+ *
+ * the contour lines pass between the centres of set and unset pixels,
+ * the pixels outside the image count as unset. the crossing points on the
+ * cell edges are the midpoints between the pixels, or, if bisection steps
+ * are given, they are refined using is_set(pos) to test arbitrary positions.
+ * saddle cells connect the diagonal set pixels as in the pixel contour tracing.
+ * each cell edge is crossed by at most one contour, the crossed edges are
+ * marked in a bitmap, so that every contour is only followed once.
+ */
+template<class t_vec, class t_imageview, class t_func>
+requires tl2::is_vec<t_vec>
+std::vector<std::vector<t_vec>> trace_isolines(
+	const t_imageview& img, t_func&& is_set, unsigned int num_bisections = 0)
+{
+	using t_real = typename t_vec::value_type;
+
+	std::vector<std::vector<t_vec>> contours;
+	auto [width, height] = get_image_dims(img);
+	const int w = int(width), h = int(height);
+
+	// the cells span the pixel centres, including a border of unset pixels,
+	// the horizontal edges (x, y) -- (x+1, y) come before the vertical edges (x, y) -- (x, y+1)
+	const std::size_t num_hedges = std::size_t(w + 1) * std::size_t(h + 2);
+	const std::size_t num_vedges = std::size_t(w + 2) * std::size_t(h + 1);
+	std::vector<bool> visited(num_hedges + num_vedges, false);
+
+	auto is_pixel_set = [&img](int x, int y) -> bool
+	{
+		return bool(get_pixel(img, x, y));
+	};
+
+	// corner positions of a cell, clockwise starting at the top left
+	static const int corner_offs[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+	// neighbour cells across the edges and their corresponding edges
+	static const int neighbour_offs[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+	// index of the edge i of a cell, i.e. the edge between its corners i and i+1
+	auto get_edge_idx = [w, num_hedges](int cell_x, int cell_y, int edge) -> std::size_t
+	{
+		switch(edge)
+		{
+			case 0: return std::size_t(cell_y + 1)*std::size_t(w + 1) + std::size_t(cell_x + 1);
+			case 1: return num_hedges + std::size_t(cell_y + 1)*std::size_t(w + 2) + std::size_t(cell_x + 2);
+			case 2: return std::size_t(cell_y + 2)*std::size_t(w + 1) + std::size_t(cell_x + 1);
+			default: return num_hedges + std::size_t(cell_y + 1)*std::size_t(w + 2) + std::size_t(cell_x + 1);
+		}
+	};
+
+	// crossing point on the edge i of a cell
+	auto get_crossing = [&is_set, &is_pixel_set, num_bisections, w, h](
+		int cell_x, int cell_y, int edge) -> t_vec
+	{
+		const int x1 = cell_x + corner_offs[edge][0];
+		const int y1 = cell_y + corner_offs[edge][1];
+		const int x2 = cell_x + corner_offs[(edge + 1) % 4][0];
+		const int y2 = cell_y + corner_offs[(edge + 1) % 4][1];
+
+		t_vec pos_set = tl2::create<t_vec>({ t_real(x1), t_real(y1) });
+		t_vec pos_unset = tl2::create<t_vec>({ t_real(x2), t_real(y2) });
+		if(!is_pixel_set(x1, y1))
+			std::swap(pos_set, pos_unset);
+
+		// only refine between pixels inside the image
+		if(std::min(x1, x2) >= 0 && std::max(x1, x2) < w &&
+			std::min(y1, y2) >= 0 && std::max(y1, y2) < h)
+		{
+			for(unsigned int i=0; i<num_bisections; ++i)
+			{
+				t_vec pos_mid = (pos_set + pos_unset) * t_real(0.5);
+				if(is_set(pos_mid))
+					pos_set = pos_mid;
+				else
+					pos_unset = pos_mid;
+			}
+		}
+
+		return (pos_set + pos_unset) * t_real(0.5);
+	};
+
+	// find the contours starting at the crossings of the horizontal edges in the image rows
+	std::vector<int> row_crossings;
+
+	for(int y=0; y<h; ++y)
+	{
+		// the edges between the pixels x and x+1 are crossed at the borders of the set spans
+		row_crossings.clear();
+		bool prev_set = false;
+
+		for_each_run(img, std::size_t(y), [&](std::size_t begin, std::size_t, auto pix) -> bool
+		{
+			const bool set = bool(pix);
+			if(set != prev_set)
+				row_crossings.push_back(int(begin) - 1);
+			prev_set = set;
+			return true;
+		});
+
+		if(prev_set)
+			row_crossings.push_back(w - 1);
+
+		for(int x : row_crossings)
+		{
+			if(visited[std::size_t(y + 1)*std::size_t(w + 1) + std::size_t(x + 1)])
+				continue;
+
+			// the crossing is entered through the top edge of the cell (x, y)
+			// or through the bottom edge of the cell (x, y-1)
+			int cell_x = x, cell_y = y, edge = 0;
+			if(is_pixel_set(x, y))
+			{
+				cell_y = y - 1;
+				edge = 2;
+			}
+
+			const int start_x = cell_x, start_y = cell_y, start_edge = edge;
+			std::vector<t_vec> contour;
+
+			do
+			{
+				contour.emplace_back(get_crossing(cell_x, cell_y, edge));
+				visited[get_edge_idx(cell_x, cell_y, edge)] = true;
+
+				bool corners[4];
+				for(int corner=0; corner<4; ++corner)
+				{
+					corners[corner] = is_pixel_set(
+						cell_x + corner_offs[corner][0],
+						cell_y + corner_offs[corner][1]);
+				}
+
+				// leave through the next crossed edge counter-clockwise
+				int exit_edge = edge;
+				for(int i=1; i<4; ++i)
+				{
+					int next_edge = (edge + 4 - i) % 4;
+					if(corners[next_edge] != corners[(next_edge + 1) % 4])
+					{
+						exit_edge = next_edge;
+						break;
+					}
+				}
+
+				if(exit_edge == edge)
+					break;
+
+				cell_x += neighbour_offs[exit_edge][0];
+				cell_y += neighbour_offs[exit_edge][1];
+				edge = (exit_edge + 2) % 4;
+			}
+			while(cell_x != start_x || cell_y != start_y || edge != start_edge);
+
+			// same orientation as the pixel contour tracing
+			std::reverse(contour.begin(), contour.end());
+			contours.emplace_back(std::move(contour));
+		}
+	}
+
+	return contours;
+}
+
+
+/**
+ * sub-pixel contour lines around the set pixels using marching squares,
+ * the crossing points are the midpoints between the pixels
+ */
+template<class t_vec, class t_imageview>
+requires tl2::is_vec<t_vec>
+std::vector<std::vector<t_vec>> trace_isolines(const t_imageview& img)
+{
+	return trace_isolines<t_vec, t_imageview>(img,
+		[](const t_vec&) -> bool { return false; }, 0);
+}
+
+
+#ifdef USE_OCV
+/**
+ * contour tracing using opencv
+ * @see https://docs.opencv.org/4.x/index.html
+ * @see https://github.com/opencv/opencv
+ */
+template<class t_vec,
+	class t_imageview, class t_boundaryview = t_imageview>
+requires tl2::is_vec<t_vec>
+std::vector<std::vector<t_vec>> trace_contour_ocv(const t_imageview& img)
+{
+	// convert from internal image format
+	auto [width, height] = get_image_dims(img);
+	cv::Mat mat(height, width, CV_8U);
+
+	for(std::size_t y = 0; y < height; ++y)
+		for(std::size_t x = 0; x < width; ++x)
+			mat.at<std::uint8_t>(y, x) = get_pixel(img, x, y);
+
+	// find contours
+	std::vector<std::vector<cv::Point>> contours;
+	std::vector<cv::Vec4i> hierarchy;
+	cv::findContours(mat, contours, hierarchy,
+		cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+	// debug output
+	/*cv::Mat cont_mat(height, width, CV_8UC3, cv::Scalar{0, 0, 0});
+	cv::drawContours(cont_mat, contours, -1, cv::Scalar{0xff, 0xff, 0xff});
+	cv::imwrite("/users/tw/tmp/taspaths_cont_0.png", mat);
+	cv::imwrite("/users/tw/tmp/taspaths_cont_1.png", cont_mat);*/
+
+	// convert to internal vector format
 	std::vector<std::vector<t_vec>> contour_polys;
 	for(const std::vector<cv::Point>& contour : contours)
 	{
@@ -563,9 +1224,8 @@ public:
 				nearest_vertices.emplace_back(std::move(vec));
 			}));
 #elif GEO_OBSTACLES_INDEX_TREE == 2
-		if(const auto* node = idxtree.get_closest(pos); node)
-			nearest_vertices.emplace_back(*node->vec);
-
+		for(std::size_t idx : idxtree.get_closest(pos, num))
+			nearest_vertices.emplace_back(idxtree.get_vec(idx));
 #endif
 
 		return nearest_vertices;
@@ -582,64 +1242,854 @@ public:
 };
 
 
+/**
+ * get the pixels which can be the closest ones to a free position.
+ * pixel x is used if pixel x-1 is set, as in the index tree and distance field,
+ * but only the pixels at the boundary of these regions are returned:
+ * any other pixel has a neighbour which is closer to the free position
+ */
+template<class t_vec, class t_imageview>
+requires tl2::is_vec<t_vec>
+std::vector<t_vec> get_closest_pixel_candidates(const t_imageview& img)
+{
+	// pixel span [begin, end) in a row
+	using t_span = std::pair<std::size_t, std::size_t>;
+
+	auto [width, height] = get_image_dims(img);
+	std::vector<t_vec> candidates;
+
+	// get the spans of the pixels next to set pixels in a row
+	auto get_spans = [&img, width](std::size_t y) -> std::vector<t_span>
+	{
+		std::vector<t_span> spans;
+
+		for_each_run(img, y, [&spans, width](std::size_t begin, std::size_t end, auto pix) -> bool
+		{
+			if(!pix)
+				return true;
+
+			begin += 1;
+			end = std::min(end + 1, std::size_t(width));
+
+			// merge adjacent runs of different set values
+			if(spans.size() && spans.back().second >= begin)
+				spans.back().second = end;
+			else if(begin < end)
+				spans.emplace_back(begin, end);
+			return true;
+		});
+
+		return spans;
+	};
+
+	// get the pixels of the spans a which are not covered by the spans b
+	auto get_difference = [](const std::vector<t_span>& a, const std::vector<t_span>& b,
+		std::vector<std::size_t>& pixels)
+	{
+		std::size_t idx_b = 0;
+
+		for(auto [begin, end] : a)
+		{
+			for(std::size_t x=begin; x<end;)
+			{
+				while(idx_b < b.size() && b[idx_b].second <= x)
+					++idx_b;
+
+				// no more covering spans
+				if(idx_b >= b.size() || b[idx_b].first >= end)
+				{
+					for(; x<end; ++x)
+						pixels.push_back(x);
+					break;
+				}
+
+				for(; x<b[idx_b].first; ++x)
+					pixels.push_back(x);
+				x = std::max(x, b[idx_b].second);
+			}
+		}
+	};
+
+	std::vector<t_span> spans_prev, spans_cur, spans_next;
+	if(height)
+		spans_next = get_spans(0);
+
+	std::vector<std::size_t> pixels;
+
+	for(std::size_t y=0; y<std::size_t(height); ++y)
+	{
+		spans_prev = std::move(spans_cur);
+		spans_cur = std::move(spans_next);
+		spans_next.clear();
+		if(y + 1 < std::size_t(height))
+			spans_next = get_spans(y + 1);
+
+		// the span ends are boundary pixels
+		pixels.clear();
+		for(auto [begin, end] : spans_cur)
+		{
+			pixels.push_back(begin);
+			pixels.push_back(end - 1);
+		}
+
+		// pixels without vertical neighbours are boundary pixels
+		if(y > 0)
+			get_difference(spans_cur, spans_prev, pixels);
+		if(y + 1 < std::size_t(height))
+			get_difference(spans_cur, spans_next, pixels);
+
+		std::sort(pixels.begin(), pixels.end());
+		pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+
+		for(std::size_t x : pixels)
+			candidates.emplace_back(tl2::create<t_vec>({ int(x), int(y) }));
+	}
+
+	return candidates;
+}
+
+
 /**
  * build an index tree to find the pixel of a certain value
- * which is closest to a given coordinate
+ * which is closest to a given coordinate,
+ * the tree only contains the boundary pixels and is bulk-loaded
  */
 template<class t_vec, class t_imageview>
 requires tl2::is_vec<t_vec>
 ClosestPixelTreeResults<t_vec>
 build_closest_pixel_tree(const t_imageview& img)
 {
-#if GEO_OBSTACLES_INDEX_TREE == 1
 	using t_results = ClosestPixelTreeResults<t_vec>;
+
+	t_results results;
+	std::vector<t_vec> verts = get_closest_pixel_candidates<t_vec, t_imageview>(img);
+
+#if GEO_OBSTACLES_INDEX_TREE == 1
 	using t_scalar = typename t_results::t_scalar;
 	using t_idxvertex = typename t_results::template t_idxvertex<t_scalar>;
+	using t_idxtree = typename t_results::t_idxtree;
 
-	t_results results;
-	auto& tree = results.GetIndexTree();
+	// convert pixel coordinates to index vertices
+	std::vector<t_idxvertex> idxverts;
+	idxverts.reserve(verts.size());
+	for(const t_vec& vert : verts)
+		idxverts.emplace_back(t_idxvertex{vert[0], vert[1]});
+
+	// create the tree using the packing algorithm
+	results.GetIndexTree() = t_idxtree(idxverts,
+		typename t_idxtree::parameters_type(8));
+
+#elif GEO_OBSTACLES_INDEX_TREE == 2
+	results.GetIndexTree().create(verts);
+#endif
+
+	return results;
+}
 
-	auto [width, height] = get_image_dims(img);
 
-	// iterate pixels
-	for(int y=0; y<(int)height; ++y)
+/**
+ * exact euclidean feature transform of an image,
+ * for every pixel the closest feature pixel is stored.
+ * the transform is separable, first all columns and then all rows
+ * are processed; the columns and rows are independent of each other
+ * and can be calculated in parallel.
+ * @see P. F. Felzenszwalb and D. P. Huttenlocher, Theory of Computing 8, pp. 415-428 (2012), doi: 10.4086/toc.2012.v008a019
+ * @see A. Meijster, J. B. T. M. Roerdink and W. H. Hesselink, Mathematical Morphology and its Applications to Image and Signal Processing, pp. 331-340 (2000), doi: 10.1007/0-306-47025-X_36
+ */
+template<class t_vec, class t_calcreal = double>
+requires tl2::is_vec<t_vec>
+class ClosestPixelField
+{
+public:
+	using t_scalar = typename t_vec::value_type;
+	using t_index = std::uint32_t;
+	using t_real = t_calcreal;
+
+	static constexpr t_index NO_PIXEL = std::numeric_limits<t_index>::max();
+
+
+public:
+	void Init(std::size_t w, std::size_t h)
+	{
+		m_width = w;
+		m_height = h;
+		m_closest.assign(w*h, NO_PIXEL);
+	}
+
+
+	void Clear()
 	{
-		for(int x=0; x<(int)width; ++x)
+		m_width = m_height = 0;
+		m_closest.clear();
+		m_closest.shrink_to_fit();
+	}
+
+
+	/**
+	 * set the scale factors of the metric for anisotropic distances,
+	 * |(dx, dy)| = sqrt((scale_x*dx)^2 + (scale_y*dy)^2)
+	 */
+	void SetScale(t_real scale_x, t_real scale_y)
+	{
+		m_scale_x = scale_x;
+		m_scale_y = scale_y;
+	}
+
+
+	std::size_t GetWidth() const { return m_width; }
+	std::size_t GetHeight() const { return m_height; }
+	bool IsValid() const { return m_width && m_height; }
+
+
+	/**
+	 * first pass: find the closest feature pixel in each of the columns [x0, x1),
+	 * is_feature(x, y) tells if a pixel is a feature
+	 */
+	template<class t_pred>
+	void CalcColumns(std::size_t x0, std::size_t x1, t_pred&& is_feature)
+	{
+		x1 = std::min(x1, m_width);
+		if(!m_height)
+			return;
+
+		// forward sweep, remember the last feature row of each column
+		for(std::size_t y=0; y<m_height; ++y)
+		{
+			for(std::size_t x=x0; x<x1; ++x)
+			{
+				if(is_feature(x, y))
+					m_closest[y*m_width + x] = t_index(y);
+				else if(y > 0)
+					m_closest[y*m_width + x] = m_closest[(y - 1)*m_width + x];
+			}
+		}
+
+		// backward sweep, take the next feature row if it is closer
+		for(std::size_t y=m_height-1; y>0; --y)
 		{
-			auto pix_val = get_pixel(img, x-1, y);
-			if(pix_val)
+			for(std::size_t x=x0; x<x1; ++x)
 			{
-				// convert pixel coordinate to index vertex and insert it into the tree
-				tree.insert(t_idxvertex{x, y});
+				const t_index next = m_closest[y*m_width + x];
+				if(next == NO_PIXEL)
+					continue;
+
+				// the previous feature row is above, the next one can be on either side
+				t_index& cur = m_closest[(y - 1)*m_width + x];
+				if(cur == NO_PIXEL || std::abs(std::int64_t(next) - std::int64_t(y - 1))
+					< std::int64_t(y - 1) - std::int64_t(cur))
+					cur = next;
 			}
 		}
 	}
 
-	return results;
 
-#elif GEO_OBSTACLES_INDEX_TREE == 2
-	using t_results = ClosestPixelTreeResults<t_vec>;
+	/**
+	 * second pass: find the closest feature pixel in row y,
+	 * using the lower envelope of the column distance parabolas
+	 */
+	void CalcRow(std::size_t y)
+	{
+		t_index *row = m_closest.data() + y*m_width;
 
-	t_results results;
-	auto& tree = results.GetIndexTree();
+		// squared column distances
+		std::vector<t_real> dist_sq(m_width);
+		std::vector<t_index> feature_y(row, row + m_width);
+
+		// parabolas of the lower envelope and their boundaries
+		std::vector<std::size_t> parabolas;
+		std::vector<t_real> bounds;
+		parabolas.reserve(m_width);
+		bounds.reserve(m_width + 1);
+
+		const t_real scale_x_sq = m_scale_x * m_scale_x;
+
+		auto intersect = [&dist_sq, scale_x_sq](std::size_t q, std::size_t p) -> t_real
+		{
+			t_real fq = dist_sq[q] + scale_x_sq*t_real(q)*t_real(q);
+			t_real fp = dist_sq[p] + scale_x_sq*t_real(p)*t_real(p);
+			return (fq - fp) / (t_real(2)*scale_x_sq*(t_real(q) - t_real(p)));
+		};
+
+		for(std::size_t q=0; q<m_width; ++q)
+		{
+			if(feature_y[q] == NO_PIXEL)
+				continue;
+
+			t_real dy = m_scale_y * (t_real(feature_y[q]) - t_real(y));
+			dist_sq[q] = dy*dy;
+
+			t_real bound = -std::numeric_limits<t_real>::infinity();
+			while(parabolas.size())
+			{
+				bound = intersect(q, parabolas.back());
+				if(bound > bounds.back())
+					break;
+
+				parabolas.pop_back();
+				bounds.pop_back();
+				bound = -std::numeric_limits<t_real>::infinity();
+			}
+
+			parabolas.push_back(q);
+			bounds.push_back(bound);
+		}
+
+		// no features in any column
+		if(parabolas.empty())
+		{
+			std::fill(row, row + m_width, NO_PIXEL);
+			return;
+		}
+
+		// find the closest feature pixels
+		std::size_t k = 0;
+		for(std::size_t x=0; x<m_width; ++x)
+		{
+			while(k + 1 < parabolas.size() && bounds[k + 1] < t_real(x))
+				++k;
+
+			const std::size_t px = parabolas[k];
+			row[x] = t_index(feature_y[px]*m_width + px);
+		}
+	}
+
+
+	/**
+	 * get the closest feature pixel
+	 */
+	std::optional<t_vec> GetClosest(std::size_t x, std::size_t y) const
+	{
+		if(x >= m_width || y >= m_height)
+			return std::nullopt;
+
+		const t_index idx = m_closest[y*m_width + x];
+		if(idx == NO_PIXEL)
+			return std::nullopt;
+
+		return tl2::create<t_vec>({ t_scalar(idx % m_width), t_scalar(idx / m_width) });
+	}
+
+
+	/**
+	 * get the distance to the closest feature pixel
+	 */
+	t_real GetDist(std::size_t x, std::size_t y) const
+	{
+		if(auto closest = GetClosest(x, y); closest)
+		{
+			t_real dx = m_scale_x * (t_real((*closest)[0]) - t_real(x));
+			t_real dy = m_scale_y * (t_real((*closest)[1]) - t_real(y));
+			return std::sqrt(dx*dx + dy*dy);
+		}
+
+		return std::numeric_limits<t_real>::max();
+	}
+
+
+	/**
+	 * get the flat index of the closest feature pixel
+	 */
+	t_index GetClosestIndex(std::size_t x, std::size_t y) const
+	{
+		if(x >= m_width || y >= m_height)
+			return NO_PIXEL;
+
+		return m_closest[y*m_width + x];
+	}
+
+
+	/**
+	 * get the squared distance between a pixel and a feature pixel given by its flat index
+	 */
+	t_real GetDistSq(std::size_t x, std::size_t y, t_index feature) const
+	{
+		t_real dx = m_scale_x * (t_real(feature % m_width) - t_real(x));
+		t_real dy = m_scale_y * (t_real(feature / m_width) - t_real(y));
+		return dx*dx + dy*dy;
+	}
+
+
+private:
+	std::size_t m_width{}, m_height{};
+	t_real m_scale_x{1}, m_scale_y{1};
+
+	// flat index of the closest feature pixel, after the first pass:
+	// row of the closest feature pixel in the same column
+	std::vector<t_index> m_closest{};
+};
+
+
+/**
+ * calculate the field of the closest pixels of an image,
+ * the same pixels are features as for build_closest_pixel_tree
+ */
+template<class t_vec, class t_imageview, class t_real = double>
+requires tl2::is_vec<t_vec>
+ClosestPixelField<t_vec, t_real>
+build_closest_pixel_field(const t_imageview& img,
+	t_real scale_x = t_real(1), t_real scale_y = t_real(1))
+{
+	ClosestPixelField<t_vec, t_real> field;
 	auto [width, height] = get_image_dims(img);
+	field.Init(width, height);
+	field.SetScale(scale_x, scale_y);
+
+	field.CalcColumns(0, width, [&img](std::size_t x, std::size_t y) -> bool
+	{
+		return bool(get_pixel(img, int(x) - 1, int(y)));
+	});
+
+	for(std::size_t y=0; y<height; ++y)
+		field.CalcRow(y);
+
+	return field;
+}
+
+
+/**
+ * labels of the connected regions of set and unset pixels;
+ * the set pixels are 8-connected (as in the contour tracing)
+ * and the unset pixels are 4-connected
+ */
+class RegionLabels
+{
+public:
+	using t_label = std::uint32_t;
+
+	static constexpr t_label NO_LABEL = std::numeric_limits<t_label>::max();
+
+
+public:
+	void Clear()
+	{
+		m_width = m_height = 0;
+		m_labels.clear();
+		m_labels.shrink_to_fit();
+		m_set.clear();
+		m_border.clear();
+	}
+
+
+	std::size_t GetWidth() const { return m_width; }
+	std::size_t GetHeight() const { return m_height; }
+	bool IsValid() const { return m_width && m_height; }
+
+	std::size_t GetNumRegions() const { return m_set.size(); }
+
+
+	/**
+	 * get the region label of a pixel
+	 */
+	t_label GetLabel(std::size_t x, std::size_t y) const
+	{
+		if(x >= m_width || y >= m_height)
+			return NO_LABEL;
+
+		return m_labels[y*m_width + x];
+	}
+
+
+	/**
+	 * does the region consist of set pixels?
+	 */
+	bool IsSet(t_label label) const
+	{
+		return label < m_set.size() && m_set[label];
+	}
+
+
+	/**
+	 * is the region enclosed by other regions, i.e. doesn't it touch the image border?
+	 */
+	bool IsEnclosed(t_label label) const
+	{
+		return label < m_border.size() && !m_border[label];
+	}
+
+
+	/**
+	 * label the regions of an image,
+	 * the runs of equal pixels in bands of rows are joined in parallel,
+	 * then the bands are joined sequentially at their boundary rows.
+	 * the labels are numbered in the order of the regions' first pixels.
+	 */
+	template<class t_imageview>
+	void Calculate(const t_imageview& img, unsigned int num_threads = 4)
+	{
+		auto [width, height] = get_image_dims(img);
+		m_width = width;
+		m_height = height;
+
+		m_labels.assign(m_width * m_height, NO_LABEL);
+		m_set.clear();
+		m_border.clear();
+
+		if(!m_width || !m_height)
+			return;
+
+		num_threads = std::max<unsigned int>(1, std::min<unsigned int>(num_threads, m_height / 64));
+
+		// first row of a band
+		auto get_band_row = [this, num_threads](unsigned int band) -> std::size_t
+		{
+			return m_height * band / num_threads;
+		};
+
+		// runs of set or unset pixels, the row's runs start at row_offs[y]
+		struct Run
+		{
+			std::uint32_t begin, end;
+			bool set;
+		};
+
+		std::vector<std::vector<Run>> band_runs(num_threads);
+		std::vector<std::size_t> row_offs(m_height + 1, 0);
+
+		auto run_bands = [num_threads](auto&& func)
+		{
+			std::vector<std::thread> threads;
+			threads.reserve(num_threads);
+
+			for(unsigned int band=0; band<num_threads; ++band)
+				threads.emplace_back(func, band);
+			for(std::thread& thread : threads)
+				thread.join();
+		};
+
+		// get the runs of the rows
+		run_bands([this, &img, &band_runs, &row_offs, &get_band_row](unsigned int band)
+		{
+			std::vector<Run>& runs = band_runs[band];
+
+			for(std::size_t y=get_band_row(band); y<get_band_row(band + 1); ++y)
+			{
+				const std::size_t num_runs = runs.size();
+
+				for_each_run(img, y, [&runs, num_runs](std::size_t begin, std::size_t end, auto pix) -> bool
+				{
+					// merge runs of different set pixel values
+					const bool set = bool(pix);
+					if(runs.size() > num_runs && runs.back().set == set)
+						runs.back().end = std::uint32_t(end);
+					else
+						runs.emplace_back(Run{ std::uint32_t(begin), std::uint32_t(end), set });
+					return true;
+				});
+
+				row_offs[y + 1] = runs.size() - num_runs;
+			}
+		});
+
+		for(std::size_t y=0; y<m_height; ++y)
+			row_offs[y + 1] += row_offs[y];
+
+		std::vector<Run> runs;
+		runs.reserve(row_offs[m_height]);
+		for(std::vector<Run>& runs_band : band_runs)
+		{
+			runs.insert(runs.end(), runs_band.begin(), runs_band.end());
+			runs_band.clear();
+			runs_band.shrink_to_fit();
+		}
+
+		// union-find over the runs, the root is the first run of a region
+		std::vector<t_label> parents(runs.size());
+		for(std::size_t idx=0; idx<runs.size(); ++idx)
+			parents[idx] = t_label(idx);
+
+		auto find_root = [&parents](t_label idx) -> t_label
+		{
+			while(parents[idx] != idx)
+			{
+				parents[idx] = parents[parents[idx]];
+				idx = parents[idx];
+			}
+			return idx;
+		};
+
+		// join the runs of row y with the connected runs in row y-1
+		auto join_rows = [&runs, &row_offs, &parents, &find_root](std::size_t y)
+		{
+			std::size_t prev = row_offs[y - 1];
+			const std::size_t prev_end = row_offs[y];
+
+			for(std::size_t cur=row_offs[y]; cur<row_offs[y + 1]; ++cur)
+			{
+				const Run& run = runs[cur];
+
+				// skip the runs that end before the current one, including its diagonal neighbours
+				while(prev < prev_end && runs[prev].end < run.begin)
+					++prev;
+
+				for(std::size_t idx=prev; idx<prev_end && runs[idx].begin <= run.end; ++idx)
+				{
+					const Run& run_prev = runs[idx];
+					if(run_prev.set != run.set)
+						continue;
+
+					// unset pixels only connect to direct neighbours
+					if(!run.set && (run_prev.end == run.begin || run_prev.begin == run.end))
+						continue;
+
+					t_label root1 = find_root(t_label(idx));
+					t_label root2 = find_root(t_label(cur));
+					if(root1 < root2)
+						parents[root2] = root1;
+					else if(root2 < root1)
+						parents[root1] = root2;
+				}
+			}
+		};
+
+		run_bands([&join_rows, &get_band_row](unsigned int band)
+		{
+			for(std::size_t y=get_band_row(band) + 1; y<get_band_row(band + 1); ++y)
+				join_rows(y);
+		});
+
+		for(unsigned int band=1; band<num_threads; ++band)
+			join_rows(get_band_row(band));
+
+		// number the regions
+		std::vector<t_label> run_labels(runs.size());
+		for(std::size_t y=0; y<m_height; ++y)
+		{
+			for(std::size_t idx=row_offs[y]; idx<row_offs[y + 1]; ++idx)
+			{
+				const Run& run = runs[idx];
+				const t_label root = find_root(t_label(idx));
+
+				if(root == t_label(idx))
+				{
+					run_labels[idx] = t_label(m_set.size());
+					m_set.push_back(run.set);
+					m_border.push_back(false);
+				}
+				else
+				{
+					run_labels[idx] = run_labels[root];
+				}
+
+				if(y == 0 || y == m_height - 1 || run.begin == 0 || run.end == m_width)
+					m_border[run_labels[idx]] = true;
+			}
+		}
+
+		// write the pixel labels
+		run_bands([this, &runs, &row_offs, &run_labels, &get_band_row](unsigned int band)
+		{
+			for(std::size_t y=get_band_row(band); y<get_band_row(band + 1); ++y)
+			{
+				for(std::size_t idx=row_offs[y]; idx<row_offs[y + 1]; ++idx)
+				{
+					std::fill(m_labels.begin() + y*m_width + runs[idx].begin,
+						m_labels.begin() + y*m_width + runs[idx].end,
+						run_labels[idx]);
+				}
+			}
+		});
+	}
+
+
+private:
+	std::size_t m_width{}, m_height{};
+
+	// region labels of the pixels
+	std::vector<t_label> m_labels{};
+
+	// regions of set pixels and regions touching the border
+	std::vector<bool> m_set{}, m_border{};
+};
 
-	std::vector<t_vec> verts_to_insert;
 
-	// iterate pixels
-	for(int y=0; y<(int)height; ++y)
+/**
+ * label the connected regions of set and unset pixels
+ */
+template<class t_imageview>
+RegionLabels label_regions(const t_imageview& img, unsigned int num_threads = 4)
+{
+	RegionLabels labels;
+	labels.Calculate(img, num_threads);
+
+	return labels;
+}
+
+
+/**
+ * medial axis of the unset pixels from the closest set pixels (the features).
+ * two neighbouring pixels straddle the axis if their features belong to different
+ * regions or are far enough apart (see below); of the two pixels only the one
+ * closer to the bisector of the features is marked, so the axis is mostly one pixel thick.
+ * is_excluded(x, y) removes pixels from the axis.
+ * the rows are processed in parallel bands.
+ * @see W. H. Hesselink and J. B. T. M. Roerdink, IEEE TPAMI 30(12), pp. 2204-2217 (2008), doi: 10.1109/TPAMI.2008.21
+ */
+template<class t_vec, class t_real, class t_func>
+Image<std::uint8_t> calc_medial_axis(const ClosestPixelField<t_vec, t_real>& field,
+	const RegionLabels& labels, t_real min_feature_dist, t_func&& is_excluded,
+	unsigned int num_threads = 4)
+{
+	using t_index = typename ClosestPixelField<t_vec, t_real>::t_index;
+	constexpr t_index NO_PIXEL = ClosestPixelField<t_vec, t_real>::NO_PIXEL;
+
+	const std::size_t width = field.GetWidth();
+	const std::size_t height = field.GetHeight();
+	const t_real min_feature_dist_sq = min_feature_dist * min_feature_dist;
+
+	Image<std::uint8_t> axis(width, height);
+	if(!width || !height)
+		return axis;
+
+	auto get_feature_label = [&labels, width](t_index feature) -> RegionLabels::t_label
+	{
+		return labels.GetLabel(feature % width, feature / width);
+	};
+
+	auto is_axis_pixel = [&](std::size_t x, std::size_t y) -> bool
 	{
-		for(int x=0; x<(int)width; ++x)
+		const t_index idx = t_index(y*width + x);
+		const t_index feature = field.GetClosestIndex(x, y);
+
+		// no features or a feature itself
+		if(feature == NO_PIXEL || feature == idx)
+			return false;
+
+		const std::array<std::array<int, 2>, 4> neighbours{{
+			{{ -1, 0 }}, {{ 1, 0 }}, {{ 0, -1 }}, {{ 0, 1 }} }};
+
+		for(const auto& [dx, dy] : neighbours)
 		{
-			auto pix_val = get_pixel(img, x-1, y);
-			if(pix_val)
-				verts_to_insert.emplace_back(tl2::create<t_vec>({x, y}));
+			if((dx < 0 && x == 0) || (dy < 0 && y == 0) ||
+				(dx > 0 && x + 1 >= width) || (dy > 0 && y + 1 >= height))
+				continue;
+
+			const std::size_t x2 = std::size_t(int(x) + dx);
+			const std::size_t y2 = std::size_t(int(y) + dy);
+			const t_index idx2 = t_index(y2*width + x2);
+			const t_index feature2 = field.GetClosestIndex(x2, y2);
+
+			if(feature2 == NO_PIXEL || feature2 == idx2 || feature2 == feature)
+				continue;
+
+			// do the features belong to different parts of the medial axis?
+			// features of the same region have to be at least min_feature_dist apart
+			// and must not be closer to each other than to the pixel, i.e. they have to
+			// span an angle of at least 60 degrees, this suppresses the spurious
+			// branches from the corners of digitised curves
+			if(get_feature_label(feature) == get_feature_label(feature2))
+			{
+				const t_real feature_dist_sq = field.GetDistSq(
+					feature % width, feature / width, feature2);
+				if(feature_dist_sq <= min_feature_dist_sq ||
+					feature_dist_sq < field.GetDistSq(x, y, feature))
+					continue;
+			}
+
+			// mark the pixel that is closer to the bisector of the features
+			const t_real dist = field.GetDistSq(x, y, feature2) - field.GetDistSq(x, y, feature);
+			const t_real dist2 = field.GetDistSq(x2, y2, feature) - field.GetDistSq(x2, y2, feature2);
+
+			if(dist < dist2 || (dist == dist2 && idx < idx2))
+				return true;
 		}
+
+		return false;
+	};
+
+	num_threads = std::max<unsigned int>(1, std::min<unsigned int>(num_threads, height / 64));
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads);
+
+	for(unsigned int band=0; band<num_threads; ++band)
+	{
+		threads.emplace_back([&, band]()
+		{
+			for(std::size_t y=height*band/num_threads; y<height*(band + 1)/num_threads; ++y)
+			{
+				for(std::size_t x=0; x<width; ++x)
+				{
+					if(is_axis_pixel(x, y) && !is_excluded(x, y))
+						axis.SetPixel(x, y, 1);
+				}
+			}
+		});
 	}
 
-	tree.create(verts_to_insert);
-	return results;
-#endif
+	for(std::thread& thread : threads)
+		thread.join();
+
+	return axis;
+}
+
+
+/**
+ * thin a skeleton to a width of one pixel by removing its simple pixels,
+ * i.e. the pixels whose removal doesn't change the 8-connectivity of the skeleton.
+ * the end pixels are kept, so the lines don't get shorter.
+ * only the set pixels are visited, so the cost scales with the skeleton size.
+ * @see S. Yokoi, J. Toriwaki and T. Fukumura, Comput. Graph. Image Process. 4(1), pp. 63-73 (1975), doi: 10.1016/0146-664X(75)90022-1
+ */
+template<class t_pixel>
+void thin_skeleton(Image<t_pixel>& img)
+{
+	const std::size_t width = img.GetWidth();
+	const std::size_t height = img.GetHeight();
+
+	std::vector<std::pair<std::size_t, std::size_t>> pixels;
+	for(std::size_t y=0; y<height; ++y)
+		for(std::size_t x=0; x<width; ++x)
+			if(img.GetPixel(x, y))
+				pixels.emplace_back(std::make_pair(x, y));
+
+	// neighbours in counter-clockwise order, starting with the right one
+	const std::array<std::array<int, 2>, 8> neighbours{{
+		{{ 1, 0 }}, {{ 1, -1 }}, {{ 0, -1 }}, {{ -1, -1 }},
+		{{ -1, 0 }}, {{ -1, 1 }}, {{ 0, 1 }}, {{ 1, 1 }} }};
+
+	auto is_removable = [&img, &neighbours](std::size_t x, std::size_t y) -> bool
+	{
+		std::array<bool, 8> unset{};
+		int num_set = 0;
+
+		for(std::size_t i=0; i<neighbours.size(); ++i)
+		{
+			unset[i] = !get_pixel(img, int(x) + neighbours[i][0], int(y) + neighbours[i][1]);
+			if(!unset[i])
+				++num_set;
+		}
+
+		// keep end pixels
+		if(num_set < 2)
+			return false;
+
+		// 8-connectivity number
+		int conn = 0;
+		for(std::size_t i=0; i<neighbours.size(); i+=2)
+			conn += int(unset[i]) - int(unset[i] && unset[i + 1] && unset[(i + 2) % 8]);
+
+		return conn == 1;
+	};
+
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+
+		for(auto& [x, y] : pixels)
+		{
+			if(!img.GetPixel(x, y) || !is_removable(x, y))
+				continue;
+
+			img.SetPixel(x, y, 0);
+			changed = true;
+		}
+
+		std::erase_if(pixels, [&img](const auto& pix) -> bool
+		{
+			return !img.GetPixel(pix.first, pix.second);
+		});
+	}
 }
 // ----------------------------------------------------------------------------
 
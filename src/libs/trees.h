@@ -47,6 +47,10 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <thread>
 #include <cstdint>
 #include <iostream>
 
@@ -889,330 +893,361 @@ private:
 // @see https://en.wikipedia.org/wiki/K-d_tree
 // ----------------------------------------------------------------------------
 
-template<class t_vec> requires tl2::is_basic_vec<t_vec> class KdTree;
-
 /**
- * k-d tree node
+ * k-d tree with an implicit layout:
+ *   - the points are stored in one contiguous array in tree order,
+ *     the node of a range [begin, end) is the point at its middle
+ *   - the left subtree is the range [begin, mid), the right one [mid+1, end)
+ *   - small ranges are scanned linearly as leaves
  */
 template<class t_vec>
 requires tl2::is_basic_vec<t_vec>
-struct KdTreeNode : public CommonTreeNode<KdTreeNode<t_vec>>
+class KdTree
 {
+public:
 	using t_scalar = typename t_vec::value_type;
 
-	using t_balance = std::int64_t;
-	t_balance balance = 0;
+	// number of points below which a range is scanned linearly
+	static constexpr std::size_t LEAF_SIZE = 8;
 
-	// pointer to actual data for leaf nodes
-	std::shared_ptr<const t_vec> vec{};
-
-	// coordinate component index offset of splitting plane for inner nodes
-	std::size_t split_idx{};
-	t_scalar split_value{};
 
+public:
+	KdTree(std::size_t dim = 3) : m_dim{dim}
+	{}
 
-	KdTreeNode() = default;
-	virtual ~KdTreeNode() = default;
+	~KdTree() = default;
 
-	KdTreeNode(const std::shared_ptr<const t_vec>& vec)
-		: CommonTreeNode<KdTreeNode<t_vec>>{}, vec{vec}
-	{}
+	KdTree(const KdTree<t_vec>& other) = default;
+	KdTree(KdTree<t_vec>&& other) = default;
+	KdTree<t_vec>& operator=(const KdTree<t_vec>& other) = default;
+	KdTree<t_vec>& operator=(KdTree<t_vec>&& other) = default;
 
 
-	void print(std::ostream& ostr, std::size_t indent = 0) const
+	void clear()
 	{
-		using namespace tl2_ops;
-		const KdTreeNode<t_vec> *node = this;
+		m_coords.clear();
+		m_indices.clear();
+		m_split_dims.clear();
+		m_tree_pos.clear();
+	}
 
-		ostr << "ptr: " << (void*)node << ", balance: " << node->balance;
-		if(node->vec)
-			ostr << ", vec: " << *node->vec;
-		else
-			ostr << ", split index: " << node->split_idx << ", split value: " << node->split_value;
 
-		if(node->left || node->right)
-		{
-			ostr << "\n";
-			for(std::size_t i=0; i<indent+1; ++i)
-				ostr << "  ";
-			ostr << "left: ";
-			if(node->left)
-				node->left->print(ostr, indent+1);
-			else
-				ostr << "nullptr\n";
+	std::size_t size() const { return m_indices.size(); }
+	bool empty() const { return m_indices.empty(); }
+	std::size_t get_dim() const { return m_dim; }
 
-			ostr << "\n";
-			for(std::size_t i=0; i<indent+1; ++i)
-				ostr << "  ";
-			ostr << "right: ";
-			if(node->right)
-				node->right->print(ostr, indent+1);
-			else
-				ostr << "nullptr\n";
-		}
-	}
 
-
-	virtual std::string description() const override
+	/**
+	 * create the tree from a collection of vectors,
+	 * the queries return the indices into this collection
+	 * @see (Berg 2008), pp. 100-101
+	 */
+	void create(const std::vector<t_vec>& vecs)
 	{
-		using namespace tl2_ops;
+		const std::size_t num = vecs.size();
 
-		std::ostringstream ostr;
+		m_indices.resize(num);
+		std::iota(m_indices.begin(), m_indices.end(), 0);
+		m_split_dims.assign(num, 0);
 
-		// left node or inner node?
-		if(vec)
-			ostr << "vertex: " << *vec;
-		else
-			ostr << "split index: " << split_idx
-				<< "\nsplit value: " << split_value;
+		create(vecs, 0, num);
 
-		return ostr.str();
+		// store the points in tree order
+		m_coords.resize(num * m_dim);
+		m_tree_pos.resize(num);
+		for(std::size_t pos=0; pos<num; ++pos)
+		{
+			const t_vec& vec = vecs[m_indices[pos]];
+			for(std::size_t i=0; i<m_dim; ++i)
+				m_coords[pos*m_dim + i] = vec[i];
+			m_tree_pos[m_indices[pos]] = pos;
+		}
 	}
 
 
-	friend std::ostream& operator<<(std::ostream& ostr, const KdTreeNode<t_vec>& node)
+	/**
+	 * get a point by its index in the original collection
+	 */
+	t_vec get_vec(std::size_t idx) const
 	{
-		node.print(ostr);
-		return ostr;
+		t_vec vec = tl2::zero<t_vec>(m_dim);
+		const t_scalar* coords = get_coords(m_tree_pos[idx]);
+
+		for(std::size_t i=0; i<m_dim; ++i)
+			vec[i] = coords[i];
+		return vec;
 	}
-};
 
 
+	/**
+	 * get the indices of the k points closest to a query point,
+	 * sorted by their distance
+	 */
+	std::vector<std::size_t> get_closest(const t_vec& vec, std::size_t k = 1) const
+	{
+		std::vector<std::size_t> indices;
+		if(empty() || k == 0)
+			return indices;
 
-/**
- * k-d tree
- * @see (Klein 2005), ch. 3.3.1, pp. 126f
- * @see (Berg 2008), pp. 99-105
- * @see https://en.wikipedia.org/wiki/K-d_tree
- */
-template<class t_vec>
-requires tl2::is_basic_vec<t_vec>
-class KdTree
-{
-public:
-	using t_node = KdTreeNode<t_vec>;
-	using t_scalar = typename t_vec::value_type;
+		// max-heap of the closest points found so far
+		std::vector<std::pair<t_scalar, std::size_t>> heap;
+		heap.reserve(k + 1);
 
-	using t_nodetraits = BinTreeNodeTraits<t_node>;
-	using t_treealgos = boost::intrusive::bstree_algorithms<t_nodetraits>;
+		get_closest(vec, k, 0, size(), heap);
 
+		std::sort_heap(heap.begin(), heap.end());
+		indices.reserve(heap.size());
+		for(const auto& [dist_sq, pos] : heap)
+			indices.push_back(m_indices[pos]);
 
-public:
-	KdTree(std::size_t dim = 3) : m_dim{dim}
-	{
-		t_treealgos::init_header(&m_root);
+		return indices;
 	}
 
-	~KdTree()
+
+	/**
+	 * get the indices of the points within a radius around a query point
+	 */
+	std::vector<std::size_t> get_in_radius(const t_vec& vec, t_scalar rad) const
 	{
-		clear();
+		std::vector<std::size_t> indices;
+		if(!empty())
+			get_in_radius(vec, rad*rad, 0, size(), indices);
+
+		return indices;
 	}
 
-	// TODO
-	KdTree(const KdTree<t_vec>& other) = delete;
-	KdTree<t_vec>& operator=(const KdTree<t_vec>& other) = delete;
 
-	KdTree(KdTree<t_vec>&& other)
+	/**
+	 * get the indices of the k closest points for several query points,
+	 * the queries are distributed over the given number of threads
+	 */
+	std::vector<std::vector<std::size_t>> get_closest(
+		const std::vector<t_vec>& vecs, std::size_t k, unsigned int num_threads = 1) const
 	{
-		this->operator=(std::forward<KdTree<t_vec>&&>(other));
-	}
+		std::vector<std::vector<std::size_t>> results(vecs.size());
 
-	KdTree<t_vec>& operator=(KdTree<t_vec>&& other)
-	{
-		other.m_ownsroot = false;
-		this->m_root = std::move(other.m_root);
-		this->m_dim = other.m_dim;
-		return *this;
+		auto query_range = [this, &vecs, &results, k](std::size_t begin, std::size_t end)
+		{
+			for(std::size_t idx=begin; idx<end; ++idx)
+				results[idx] = get_closest(vecs[idx], k);
+		};
+
+		num_threads = std::max<unsigned int>(1, std::min<std::size_t>(num_threads, vecs.size()));
+		if(num_threads <= 1)
+		{
+			query_range(0, vecs.size());
+			return results;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads);
+
+		const std::size_t chunk = (vecs.size() + num_threads - 1) / num_threads;
+		for(std::size_t begin=0; begin<vecs.size(); begin+=chunk)
+			threads.emplace_back(query_range, begin, std::min(begin + chunk, vecs.size()));
+
+		for(std::thread& thread : threads)
+			thread.join();
+
+		return results;
 	}
 
 
-	void clear()
+	friend std::ostream& operator<<(std::ostream& ostr, const KdTree<t_vec>& tree)
 	{
-		if(m_ownsroot)
-			free_nodes(get_root());
+		tree.print(ostr, 0, tree.size(), 0);
+		return ostr;
 	}
 
 
-	const t_node* get_root() const
+protected:
+	const t_scalar* get_coords(std::size_t pos) const
 	{
-		return t_treealgos::root_node(&m_root);
+		return m_coords.data() + pos*m_dim;
 	}
 
-	t_node* get_root()
+
+	t_scalar get_dist_sq(const t_vec& vec, std::size_t pos) const
 	{
-		return t_treealgos::root_node(&m_root);
+		const t_scalar* coords = get_coords(pos);
+
+		t_scalar dist_sq{};
+		for(std::size_t i=0; i<m_dim; ++i)
+		{
+			t_scalar diff = vec[i] - coords[i];
+			dist_sq += diff*diff;
+		}
+
+		return dist_sq;
 	}
 
 
 	/**
-	 * create the tree from a collection of vectors
+	 * sort the points of a range into tree order,
+	 * splitting at the median of the dimension with the largest spread
 	 */
-	void create(const std::vector<t_vec>& _vecs)
+	void create(const std::vector<t_vec>& vecs, std::size_t begin, std::size_t end)
 	{
-		std::vector<std::shared_ptr<t_vec>> vecs;
-		vecs.reserve(_vecs.size());
-
-		for(const t_vec& vec : _vecs)
-			vecs.emplace_back(std::make_shared<t_vec>(vec));
+		if(end - begin <= 1)
+			return;
 
-		create(get_root(), vecs, m_dim);
-	}
+		std::size_t split_dim = 0;
+		t_scalar max_spread{};
 
+		for(std::size_t i=0; i<m_dim; ++i)
+		{
+			auto [min_iter, max_iter] = std::minmax_element(
+				m_indices.begin() + begin, m_indices.begin() + end,
+				[&vecs, i](std::size_t idx1, std::size_t idx2) -> bool
+				{
+					return vecs[idx1][i] < vecs[idx2][i];
+				});
 
-	const t_node* get_closest(const t_vec& vec) const
-	{
-		const t_node* closest_node = nullptr;
-		t_scalar closest_dist_sq = std::numeric_limits<t_scalar>::max();
+			t_scalar spread = vecs[*max_iter][i] - vecs[*min_iter][i];
+			if(i == 0 || spread > max_spread)
+			{
+				max_spread = spread;
+				split_dim = i;
+			}
+		}
 
-		get_closest(get_root(), vec, &closest_node, &closest_dist_sq);
-		return closest_node;
-	}
+		const std::size_t mid = begin + (end - begin) / 2;
+		std::nth_element(m_indices.begin() + begin,
+			m_indices.begin() + mid, m_indices.begin() + end,
+			[&vecs, split_dim](std::size_t idx1, std::size_t idx2) -> bool
+			{
+				return vecs[idx1][split_dim] < vecs[idx2][split_dim];
+			});
 
+		m_split_dims[mid] = split_dim;
 
-	friend std::ostream& operator<<(std::ostream& ostr, const KdTree<t_vec>& tree)
-	{
-		ostr << *tree.get_root();
-		return ostr;
+		create(vecs, begin, mid);
+		create(vecs, mid + 1, end);
 	}
 
 
-protected:
 	/**
-	 * create the tree from a collection of points
-	 * @see (Berg 2008), pp. 100-101
+	 * look for the k closest points in a range
+	 * @see https://en.wikipedia.org/wiki/K-d_tree#Nearest_neighbour_search
 	 */
-	static void create(t_node* node,
-		const std::vector<std::shared_ptr<t_vec>>& vecs,
-		std::size_t dim = 3, std::size_t depth = 0)
+	void get_closest(const t_vec& vec, std::size_t k, std::size_t begin, std::size_t end,
+		std::vector<std::pair<t_scalar, std::size_t>>& heap) const
 	{
-		if(!node || vecs.size() == 0)
-			return;
+		auto add_point = [&heap, k](t_scalar dist_sq, std::size_t pos)
+		{
+			if(heap.size() < k)
+			{
+				heap.emplace_back(dist_sq, pos);
+				std::push_heap(heap.begin(), heap.end());
+			}
+			else if(dist_sq < heap.front().first)
+			{
+				std::pop_heap(heap.begin(), heap.end());
+				heap.back() = std::make_pair(dist_sq, pos);
+				std::push_heap(heap.begin(), heap.end());
+			}
+		};
 
-		// create a leaf node
-		if(vecs.size() == 1)
+		// leaf range
+		if(end - begin <= LEAF_SIZE)
 		{
-			node->vec = vecs[0];
+			for(std::size_t pos=begin; pos<end; ++pos)
+				add_point(get_dist_sq(vec, pos), pos);
 			return;
 		}
 
-		node->split_idx = (depth % dim);
+		const std::size_t mid = begin + (end - begin) / 2;
+		add_point(get_dist_sq(vec, mid), mid);
 
-		// use the mean value for the splitting plane offset
-		t_scalar mean{};
-		for(const auto& vec : vecs)
-			mean += (*vec)[node->split_idx];
-		mean /= t_scalar(vecs.size());
-		node->split_value = mean;
+		const t_scalar dist_plane = vec[m_split_dims[mid]] - get_coords(mid)[m_split_dims[mid]];
 
-		std::vector<std::shared_ptr<t_vec>> left{};
-		std::vector<std::shared_ptr<t_vec>> right{};
-		left.reserve(vecs.size());
-		right.reserve(vecs.size());
+		// first continue on the side of the query point
+		if(dist_plane <= t_scalar(0))
+			get_closest(vec, k, begin, mid, heap);
+		else
+			get_closest(vec, k, mid + 1, end, heap);
 
-		// find the half-spaces of the points and sort them
-		// into the respective vectors
-		for(const auto& vec : vecs)
+		// the other side can only contain closer points if
+		// the splitting plane is closer than the farthest point so far
+		if(heap.size() < k || dist_plane*dist_plane < heap.front().first)
 		{
-			if((*vec)[node->split_idx] <= node->split_value)
-				left.push_back(vec);
+			if(dist_plane <= t_scalar(0))
+				get_closest(vec, k, mid + 1, end, heap);
 			else
-				right.push_back(vec);
+				get_closest(vec, k, begin, mid, heap);
 		}
-
-		// create the left and right child nodes
-		if(left.size())
-		{
-			node->left = new t_node{};
-			node->left->parent = node;
-			create(node->left, left, dim, depth+1);
-		}
-		if(right.size())
-		{
-			node->right = new t_node{};
-			node->right->parent = node;
-			create(node->right, right, dim, depth+1);
-		}
-
-		// set balance factor
-		decltype(node->balance) left_balance = 0;
-		decltype(node->balance) right_balance = 0;
-		if(node->left)
-			left_balance = node->left->balance + 1;
-		if(node->right)
-			right_balance = node->right->balance + 1;
-		node->balance = left_balance - right_balance;
 	}
 
 
 	/**
-	 * delete node and its child nodes
+	 * look for the points within a radius in a range
 	 */
-	static void free_nodes(t_node* node)
+	void get_in_radius(const t_vec& vec, t_scalar rad_sq, std::size_t begin, std::size_t end,
+		std::vector<std::size_t>& indices) const
 	{
-		if(!node) return;
-
-		if(node->left && node->left != node)
+		// leaf range
+		if(end - begin <= LEAF_SIZE)
 		{
-			free_nodes(node->left);
-			delete node->left;
-			node->left = nullptr;
+			for(std::size_t pos=begin; pos<end; ++pos)
+			{
+				if(get_dist_sq(vec, pos) <= rad_sq)
+					indices.push_back(m_indices[pos]);
+			}
+			return;
 		}
 
-		if(node->right && node->right != node)
-		{
-			free_nodes(node->right);
-			delete node->right;
-			node->right = nullptr;
-		}
+		const std::size_t mid = begin + (end - begin) / 2;
+		if(get_dist_sq(vec, mid) <= rad_sq)
+			indices.push_back(m_indices[mid]);
+
+		const t_scalar dist_plane = vec[m_split_dims[mid]] - get_coords(mid)[m_split_dims[mid]];
+
+		if(dist_plane <= t_scalar(0) || dist_plane*dist_plane <= rad_sq)
+			get_in_radius(vec, rad_sq, begin, mid, indices);
+		if(dist_plane >= t_scalar(0) || dist_plane*dist_plane <= rad_sq)
+			get_in_radius(vec, rad_sq, mid + 1, end, indices);
 	}
 
 
-	/**
-	 * look for the closest node
-	 * @see https://en.wikipedia.org/wiki/K-d_tree#Nearest_neighbour_search
-	 */
-	static void get_closest(const t_node* node, const t_vec& vec,
-		const t_node** closest_node, t_scalar* closest_dist_sq)
+	void print(std::ostream& ostr, std::size_t begin, std::size_t end, std::size_t indent) const
 	{
-		if(!node) return;
+		using namespace tl2_ops;
 
-		// at leaf node?
-		if(node->vec)
+		if(begin >= end)
+			return;
+
+		for(std::size_t i=0; i<indent; ++i)
+			ostr << "  ";
+
+		if(end - begin <= LEAF_SIZE)
 		{
-			// get leaf node closest to query point so far
-			t_scalar dist_sq = tl2::inner<t_vec>(vec-*node->vec, vec-*node->vec);
-			if(dist_sq < *closest_dist_sq)
-			{
-				*closest_dist_sq = dist_sq;
-				*closest_node = node;
-			}
+			ostr << "leaf:";
+			for(std::size_t pos=begin; pos<end; ++pos)
+				ostr << " " << get_vec(m_indices[pos]);
+			ostr << "\n";
+			return;
 		}
 
-		t_scalar dist_node_plane = vec[node->split_idx] - node->split_value;
-		if(*closest_dist_sq >= dist_node_plane*dist_node_plane)
-		{ // the distance between the query point and the node is greater
-		  // than the distance between the node and the splitting plane
-		  //   => need to continue looking on both sides
-			get_closest(node->left, vec, closest_node, closest_dist_sq);
-			if(dist_node_plane*dist_node_plane < *closest_dist_sq)
-				get_closest(node->right, vec, closest_node, closest_dist_sq);
-		}
-		else
-		{ // the distance between the query point and the node is less
-		  // than the distance between the node and the splitting plane
-		  //   => only need to continue on one side
-			if(dist_node_plane <= 0.) // only continue on one side of the plane
-				get_closest(node->left, vec, closest_node, closest_dist_sq);
-			else
-				get_closest(node->right, vec, closest_node, closest_dist_sq);
-		}
+		const std::size_t mid = begin + (end - begin) / 2;
+		ostr << "vec: " << get_vec(m_indices[mid])
+			<< ", split index: " << m_split_dims[mid] << "\n";
+
+		print(ostr, begin, mid, indent + 1);
+		print(ostr, mid + 1, end, indent + 1);
 	}
 
 
 private:
-	bool m_ownsroot{true};
-	t_node m_root{};
 	std::size_t m_dim{3};
+
+	// point coordinates in tree order
+	std::vector<t_scalar> m_coords{};
+	// indices of the points in the original collection, in tree order
+	std::vector<std::size_t> m_indices{};
+	// split dimension of the node at each position
+	std::vector<std::size_t> m_split_dims{};
+	// position in the tree of the points in the original collection
+	std::vector<std::size_t> m_tree_pos{};
 };
 
 // ----------------------------------------------------------------------------
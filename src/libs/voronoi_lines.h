@@ -42,13 +42,25 @@
 #ifndef __GEO_ALGOS_VORONOI_LINES_H__
 #define __GEO_ALGOS_VORONOI_LINES_H__
 
+/**
+ * which index tree to use for finding the closest voronoi vertices
+ * 1: r* tree
+ * 2: kd tree
+ */
+#define GEO_VORONOI_INDEX_TREE 1
+
+
+#include <thread>
+#include <array>
+#include <map>
+#include <cstdint>
+
 #include <boost/geometry.hpp>
 #include <boost/geometry/index/rtree.hpp>
 #include <boost/function_output_iterator.hpp>
 
 #include <boost/polygon/polygon.hpp>
 #include <boost/polygon/voronoi.hpp>
-#include <voronoi_visual_utils.hpp>
 
 #ifdef USE_OVD
 	#include <openvoronoi/voronoidiagram.hpp>
@@ -81,6 +93,7 @@
 #include "graphs.h"
 #include "hashes.h"
 #include "circular_iterator.h"
+#include "img.h"
 
 
 // ----------------------------------------------------------------------------
@@ -239,6 +252,149 @@ void remove_path_loops(std::vector<t_idx>& indices)
 		}
 	}
 }
+
+
+/**
+ * distance of a point to a line segment
+ */
+template<class t_vec, class t_real = typename t_vec::value_type>
+requires tl2::is_vec<t_vec>
+t_real dist_pt_segment(const t_vec& pt, const t_vec& seg1, const t_vec& seg2)
+{
+	const t_real dir_x = seg2[0] - seg1[0];
+	const t_real dir_y = seg2[1] - seg1[1];
+	const t_real len2 = dir_x*dir_x + dir_y*dir_y;
+
+	// position of the closest point on the segment
+	t_real param = 0;
+	if(len2 > t_real(0))
+	{
+		param = ((pt[0] - seg1[0])*dir_x + (pt[1] - seg1[1])*dir_y) / len2;
+		param = std::clamp<t_real>(param, 0, 1);
+	}
+
+	const t_real diff_x = pt[0] - (seg1[0] + param*dir_x);
+	const t_real diff_y = pt[1] - (seg1[1] + param*dir_y);
+	return std::sqrt(diff_x*diff_x + diff_y*diff_y);
+}
+
+
+/**
+ * parameters of a quadratic bisector:
+ * the points equidistant to a focus point and a directrix line
+ */
+template<class t_vec, class t_line = std::pair<t_vec, t_vec>>
+requires tl2::is_vec<t_vec>
+struct VoronoiParabola
+{
+	t_vec focus{};
+	t_line directrix{};
+};
+
+
+/**
+ * sample the arc of a parabola between two of its points,
+ * the arc is adaptively subdivided until its distance to the chords is at most max_dist
+ * @see https://github.com/boostorg/polygon/blob/develop/example/voronoi_visual_utils.hpp
+ */
+template<class t_vec, class t_line = std::pair<t_vec, t_vec>,
+	class t_real = typename t_vec::value_type>
+requires tl2::is_vec<t_vec>
+std::vector<t_vec> sample_parabola(const VoronoiParabola<t_vec, t_line>& parabola,
+	const t_vec& start, const t_vec& end, t_real max_dist,
+	std::size_t max_points = 4096)
+{
+	std::vector<t_vec> points{ start };
+
+	// local coordinate system with the directrix as x axis
+	const t_vec& origin = std::get<0>(parabola.directrix);
+	t_vec dir_x = std::get<1>(parabola.directrix) - origin;
+	const t_real dir_len = tl2::norm<t_vec>(dir_x);
+	if(dir_len <= t_real(0))
+	{
+		points.push_back(end);
+		return points;
+	}
+
+	dir_x /= dir_len;
+	const t_vec dir_y = tl2::create<t_vec>({ -dir_x[1], dir_x[0] });
+
+	const t_real focus_x = tl2::inner<t_vec>(parabola.focus - origin, dir_x);
+	const t_real focus_y = tl2::inner<t_vec>(parabola.focus - origin, dir_y);
+	const t_real start_x = tl2::inner<t_vec>(start - origin, dir_x);
+	const t_real end_x = tl2::inner<t_vec>(end - origin, dir_x);
+
+	// degenerate parabola or arc
+	if(std::abs(focus_y) <= std::numeric_limits<t_real>::epsilon() ||
+		std::abs(end_x - start_x) <= std::numeric_limits<t_real>::epsilon())
+	{
+		points.push_back(end);
+		return points;
+	}
+
+	auto get_y = [focus_x, focus_y](t_real x) -> t_real
+	{
+		return ((x - focus_x)*(x - focus_x) + focus_y*focus_y) / (t_real(2)*focus_y);
+	};
+
+	// subdivide the arc at the points with the largest distance to the chords
+	std::vector<t_real> params{ start_x };
+	std::vector<t_real> params_todo{ end_x };
+
+	while(params_todo.size())
+	{
+		const t_real x0 = params.back();
+		const t_real x1 = params_todo.back();
+		const t_real y0 = get_y(x0);
+
+		const t_real slope = (get_y(x1) - y0) / (x1 - x0);
+		const t_real x_mid = focus_x + slope*focus_y;
+		const t_real dist = std::abs(get_y(x_mid) - y0 - slope*(x_mid - x0))
+			/ std::sqrt(t_real(1) + slope*slope);
+
+		if(dist <= max_dist || params.size() + params_todo.size() >= max_points)
+		{
+			params.push_back(x1);
+			params_todo.pop_back();
+		}
+		else
+		{
+			params_todo.push_back(x_mid);
+		}
+	}
+
+	points.reserve(params.size());
+	for(std::size_t idx=1; idx<params.size()-1; ++idx)
+		points.emplace_back(origin + params[idx]*dir_x + get_y(params[idx])*dir_y);
+	points.push_back(end);
+
+	return points;
+}
+
+
+/**
+ * call func(begin, end) on contiguous chunks of the index range [0, num) in parallel threads
+ */
+template<class t_func>
+void for_each_chunk(std::size_t num, unsigned int num_threads, const t_func& func)
+{
+	num_threads = std::max<unsigned int>(1, std::min<std::size_t>(num_threads, num));
+	if(num_threads <= 1)
+	{
+		func(std::size_t(0), num);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads);
+
+	const std::size_t chunk = (num + num_threads - 1) / num_threads;
+	for(std::size_t begin=0; begin<num; begin+=chunk)
+		threads.emplace_back(func, begin, std::min(begin + chunk, num));
+
+	for(std::thread& thread : threads)
+		thread.join();
+}
 // ----------------------------------------------------------------------------
 
 
@@ -258,11 +414,9 @@ public:
 
 public:
 	/**
-	 * remove the voronoi vertex if it's inside a region defined by a line group
+	 * is the voronoi vertex inside a region defined by a line group?
 	 */
-	bool IsVertexInRegion(
-		const std::vector<t_line>& lines, const std::vector<t_vec>& vertices,
-		const t_vert_index_opt& vert0idx, const t_vert_index_opt& vert1idx,
+	bool IsVertexInRegion(const std::vector<t_line>& lines, const t_vec& vorovert,
 		t_scalar eps = std::numeric_limits<t_scalar>::eps()) const
 	{
 		if(!remove_voronoi_vertices_in_regions)
@@ -270,106 +424,80 @@ public:
 
 		// use alternate method if a callback function is available
 		if(region_func)
+			return (*region_func)(vorovert);
+
+		// use standard method without callback function
+		bool has_inv_regions = false;
+		bool outside_all_inv_regions = true;
+
+		for(std::size_t grpidx=0; grpidx<line_groups->size(); ++grpidx)
 		{
-			bool vert0_inside_region = false;
-			bool vert1_inside_region = false;
+			auto [grp_beg, grp_end] = (*line_groups)[grpidx];
+			const t_vec* pt_outside = nullptr;
+			bool inv_region = false;
 
-			// check edge vertex 0
-			if(vert0idx)
-			{
-				const auto& vorovert = vertices[*vert0idx];
-				vert0_inside_region = (*region_func)(vorovert);
-			}
+			if(points_outside_regions && points_outside_regions->size())
+				pt_outside = &(*points_outside_regions)[grpidx];
+			if(inverted_regions && inverted_regions->size())
+				inv_region = (*inverted_regions)[grpidx];
 
-			// check edge vertex 1
-			if(vert1idx)
+			bool vert_inside_region = pt_inside_poly<t_vec>(
+				lines, vorovert, grp_beg, grp_end, pt_outside, eps);
+
+			if(inv_region)
 			{
-				const auto& vorovert = vertices[*vert1idx];
-				vert1_inside_region = (*region_func)(vorovert);
+				has_inv_regions = true;
+				if(vert_inside_region)
+					outside_all_inv_regions = false;
 			}
-
-			if(vert0_inside_region || vert1_inside_region)
+			else if(vert_inside_region)
+			{
 				return true;
+			}
 		}
 
-		// use standard method without callback function
-		else
-		{
-			bool vert0_inside_norm_region = false;
-			bool vert1_inside_norm_region = false;
-			bool has_inv_regions = false;
-			bool vert0_outside_all_inv_regions = true;
-			bool vert1_outside_all_inv_regions = true;
-
-			for(std::size_t grpidx=0; grpidx<line_groups->size(); ++grpidx)
-			{
-				bool vert_inside_region = false;
-				auto [grp_beg, grp_end] = (*line_groups)[grpidx];
-				const t_vec* pt_outside = nullptr;
-				bool inv_region = false;
+		return has_inv_regions && outside_all_inv_regions;
+	}
 
-				if(points_outside_regions && points_outside_regions->size())
-					pt_outside = &(*points_outside_regions)[grpidx];
-				if(inverted_regions && inverted_regions->size())
-					inv_region = (*inverted_regions)[grpidx];
 
-				// check edge vertex 0
-				if(vert0idx)
-				{
-					const auto& vorovert = vertices[*vert0idx];
-					vert_inside_region = pt_inside_poly<t_vec>(
-						lines, vorovert, grp_beg, grp_end, pt_outside, eps);
-					if(inv_region)
-					{
-						has_inv_regions = true;
-						if(vert_inside_region)
-							vert0_outside_all_inv_regions = false;
-					}
-					else
-					{
-						if(vert_inside_region)
-						{
-							vert0_inside_norm_region = true;
-							break;
-						}
-					}
-				}
+	/**
+	 * remove the voronoi edge if one of its vertices is inside a region defined by a line group
+	 */
+	bool IsVertexInRegion(
+		const std::vector<t_line>& lines, const std::vector<t_vec>& vertices,
+		const t_vert_index_opt& vert0idx, const t_vert_index_opt& vert1idx,
+		t_scalar eps = std::numeric_limits<t_scalar>::eps()) const
+	{
+		if(!remove_voronoi_vertices_in_regions)
+			return false;
 
-				// check edge vertex 1
-				if(vert1idx)
-				{
-					const auto& vorovert = vertices[*vert1idx];
-					vert_inside_region = pt_inside_poly<t_vec>(
-						lines, vorovert, grp_beg, grp_end, pt_outside, eps);
-					if(inv_region)
-					{
-						has_inv_regions = true;
-						if(vert_inside_region)
-							vert1_outside_all_inv_regions = false;
-					}
-					else
-					{
-						if(vert_inside_region)
-						{
-							vert1_inside_norm_region = true;
-							break;
-						}
-					}
-				}
-			}
+		if(vert0idx && IsVertexInRegion(lines, vertices[*vert0idx], eps))
+			return true;
+		if(vert1idx && IsVertexInRegion(lines, vertices[*vert1idx], eps))
+			return true;
 
-			// ignore this voronoi edge and skip to the next one
-			if(vert0_inside_norm_region || vert1_inside_norm_region)
-				return true;
-			if(has_inv_regions &&
-				(vert0_outside_all_inv_regions || vert1_outside_all_inv_regions))
-				return true;
-		}
+		// a missing vertex at infinity is outside all inverted regions
+		if(!region_func && (vert0idx || vert1idx) && (!vert0idx || !vert1idx))
+			return HasInvertedRegions();
 
 		return false;
 	}
 
 
+	/**
+	 * are any of the line groups inverted regions?
+	 */
+	bool HasInvertedRegions() const
+	{
+		if(!inverted_regions || !line_groups)
+			return false;
+
+		const std::size_t num_groups = std::min(line_groups->size(), inverted_regions->size());
+		return std::find(inverted_regions->begin(), inverted_regions->begin() + num_groups, true)
+			!= inverted_regions->begin() + num_groups;
+	}
+
+
 	/**
 	 * call the external validation function on the vertex
 	 * TODO: move this into its own option struct (and out of VoronoiLinesRegions)
@@ -392,6 +520,8 @@ public:
 	const std::vector<t_vec>* GetPointsOutsideRegions() const { return points_outside_regions; }
 	const std::vector<bool>* GetInvertedRegions() const { return inverted_regions; }
 
+	const std::function<bool(const t_vec& vert)>* GetRegionFunc() const { return region_func; }
+
 	void SetGroupLines(bool b) { group_lines = b; }
 	void SetRemoveVoronoiVertices(bool b) { remove_voronoi_vertices_in_regions = b; }
 	void SetLineGroups(const std::vector<std::pair<std::size_t, std::size_t>>* g) { line_groups = g; }
@@ -453,9 +583,13 @@ public:
 		T, 2, boost::geometry::cs::cartesian>;
 
 	// the spatial index tree to use for finding voronoi vertices
+#if GEO_VORONOI_INDEX_TREE == 1
 	using t_idxtree = boost::geometry::index::rtree<
 		std::tuple<t_idxvertex<t_scalar>, std::size_t>,
 		boost::geometry::index::dynamic_rstar>;
+#elif GEO_VORONOI_INDEX_TREE == 2
+	using t_idxtree = KdTree<t_vec>;
+#endif
 
 
 	// ------------------------------------------------------------------------
@@ -519,6 +653,17 @@ public:
 	using t_edgevec_quadr =
 		std::vector<std::tuple<std::vector<t_vec>,
 			t_vert_index, t_vert_index>>;
+
+	// container type mapping voronoi vertex indices to the parameters of their quadratic bisectors
+	using t_parabola = VoronoiParabola<t_vec, t_line>;
+	using t_edgemap_parabola =
+		std::unordered_map<
+			t_vert_indices, t_parabola,
+			t_bisector_hash<t_vert_indices>,
+			t_bisector_equ<t_vert_indices>>;
+	using t_edgevec_parabola =
+		std::vector<std::tuple<t_parabola,
+			t_vert_index, t_vert_index>>;
 	// ------------------------------------------------------------------------
 
 
@@ -526,198 +671,730 @@ public:
 	/**
 	 * number of elements in the index tree
 	 */
-	typename t_idxtree::size_type GetIndexTreeSize() const
+	std::size_t GetIndexTreeSize() const
 	{
 		return idxtree.size();
 	}
 
 
 	/**
-	 * remove vertices with no connection
+	 * merge the graph's pending edges before it gets read
+	 */
+	void CompactGraph()
+	{
+		if constexpr(requires { graph.Compact(); })
+			graph.Compact();
+	}
+
+
+	/**
+	 * remove vertices with no connection,
+	 * the vertices are compacted in a single pass using an index remapping table
 	 */
 	void RemoveUnconnectedVertices()
 	{
-		std::vector<std::string> verts;
-		verts.reserve(graph.GetNumVertices());
+		constexpr t_vert_index removed = std::numeric_limits<t_vert_index>::max();
+		const std::size_t num_verts = graph.GetNumVertices();
+		CompactGraph();
 
-		// get vertex identifiers
-		for(std::size_t vert=0; vert<graph.GetNumVertices(); ++vert)
+		if(num_verts != vertices.size())
 		{
-			const std::string& id = graph.GetVertexIdent(vert);
-			verts.push_back(id);
+			std::ostringstream ostrErr;
+			ostrErr << "Vertex count mismatch: " << num_verts << ". ";
+			ostrErr << "Vector size: " << vertices.size() << ".";
+			throw std::out_of_range(ostrErr.str());
 		}
 
-		// remove vertices with no connections from graph
-		std::vector<std::size_t> removed_indices;
-		removed_indices.reserve(verts.size());
+		// new indices of the vertices with outgoing connections
+		std::vector<t_vert_index> remap(num_verts, removed);
+		std::vector<std::vector<std::size_t>> neighbours(num_verts);
+		std::size_t num_kept = 0;
 
-		for(std::size_t vertidx=0; vertidx<verts.size(); ++vertidx)
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
 		{
-			const std::string& id = verts[vertidx];
-			auto neighbours_outgoing = graph.GetNeighbours(id, 1);
+			const auto vert_neighbours = graph.GetNeighbours(vertidx, true);
+			neighbours[vertidx].assign(vert_neighbours.begin(), vert_neighbours.end());
+			if(neighbours[vertidx].size())
+				remap[vertidx] = num_kept++;
+		}
+
+		if(num_kept == num_verts)
+			return;
+
+		// rebuild the graph with the remaining vertices
+		t_graph newgraph{};
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(remap[vertidx] != removed)
+				newgraph.AddVertex(graph.GetVertexIdent(vertidx));
+		}
+
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(remap[vertidx] == removed)
+				continue;
 
-			if(neighbours_outgoing.size() == 0)
+			// insert in reverse to keep the neighbour order of the adjacency lists
+			for(auto iter = neighbours[vertidx].rbegin(); iter != neighbours[vertidx].rend(); ++iter)
 			{
-				graph.RemoveVertex(id);
-				removed_indices.push_back(vertidx);
+				std::size_t neighbour = *iter;
+				if(remap[neighbour] == removed)
+					continue;
+
+				auto weight = graph.GetWeight(vertidx, neighbour);
+				newgraph.AddEdge(remap[vertidx], remap[neighbour],
+					weight ? *weight : typename t_graph::t_weight{});
 			}
 		}
 
-		// remove the vertex coordinates
-		//std::sort(removed_indices.begin(), removed_indices.end(),
-		//	[](std::size_t idx1, std::size_t idx2) -> bool { return idx1 > idx2; });
-		std::reverse(removed_indices.begin(), removed_indices.end());
+		graph = std::move(newgraph);
 
-		for(std::size_t idx : removed_indices)
+		// compact the vertex coordinates
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
 		{
-			if(idx < vertices.size())
-			{
-				vertices.erase(vertices.begin() + idx);
-			}
-			else
+			if(remap[vertidx] != removed && remap[vertidx] != vertidx)
+				vertices[remap[vertidx]] = std::move(vertices[vertidx]);
+		}
+		vertices.resize(num_kept);
+
+		if(vertex_dists.size() == num_verts)
+		{
+			for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
 			{
-				std::ostringstream ostrErr;
-				ostrErr << "Vertex index out of range: " << idx << ". ";
-				ostrErr << "Vector size: " << vertices.size() << ".";
-				throw std::out_of_range(ostrErr.str());
-				break;
+				if(remap[vertidx] != removed)
+					vertex_dists[remap[vertidx]] = vertex_dists[vertidx];
 			}
+			vertex_dists.resize(num_kept);
+		}
 
-			// remove linear bisectors containing the removed vertex (and correct other indices)
-			for(auto iter = linear_edges_vec.begin(); iter != linear_edges_vec.end();)
-			{
-				// remove bisector
-				if((std::get<1>(*iter) && *std::get<1>(*iter)==idx) ||
-					(std::get<2>(*iter) && *std::get<2>(*iter)==idx))
-				{
-					iter = linear_edges_vec.erase(iter);
-					continue;
-				}
+		// remove linear bisectors containing a removed vertex and correct the other indices
+		auto remap_opt = [&remap](t_vert_index_opt& idx) -> bool
+		{
+			if(!idx)
+				return true;
+			if(*idx >= remap.size() || remap[*idx] == removed)
+				return false;
 
-				// correct indices
-				if(std::get<1>(*iter) && *std::get<1>(*iter) >= idx)
-					--*std::get<1>(*iter);
-				if(std::get<2>(*iter) && *std::get<2>(*iter) >= idx)
-					--*std::get<2>(*iter);
+			idx = remap[*idx];
+			return true;
+		};
 
-				++iter;
-			}
+		std::erase_if(linear_edges_vec, [&remap_opt](auto& edge) -> bool
+		{
+			bool valid0 = remap_opt(std::get<1>(edge));
+			bool valid1 = remap_opt(std::get<2>(edge));
+			return !valid0 || !valid1;
+		});
 
-			// remove quadratic bisectors containing the removed vertex (and correct other indices)
-			for(auto iter = parabolic_edges_vec.begin(); iter != parabolic_edges_vec.end();)
-			{
-				// remove bisector
-				if(std::get<1>(*iter)==idx || std::get<2>(*iter)==idx)
-				{
-					iter = parabolic_edges_vec.erase(iter);
-					continue;
-				}
+		// remove quadratic bisectors containing a removed vertex and correct the other indices
+		auto remove_quadr = [&remap](auto& edge) -> bool
+		{
+			t_vert_index& idx0 = std::get<1>(edge);
+			t_vert_index& idx1 = std::get<2>(edge);
+
+			if(idx0 >= remap.size() || idx1 >= remap.size() ||
+				remap[idx0] == removed || remap[idx1] == removed)
+				return true;
 
-				// correct indices
-				if(std::get<1>(*iter) >= idx)
-					--std::get<1>(*iter);
-				if(std::get<2>(*iter) >= idx)
-					--std::get<2>(*iter);
+			idx0 = remap[idx0];
+			idx1 = remap[idx1];
+			return false;
+		};
 
-				++iter;
-			}
+		std::erase_if(parabolic_edges_vec, remove_quadr);
+		std::erase_if(parabolas_vec, remove_quadr);
+
+		// correct the edge indices of the contracted chains
+		t_edgemap_quadr new_chain_vertices{};
+		for(auto& [indices, points] : chain_vertices)
+		{
+			if(remap[indices.first] == removed || remap[indices.second] == removed)
+				continue;
+
+			new_chain_vertices.emplace(std::make_pair(
+				std::make_pair(remap[indices.first], remap[indices.second]),
+				std::move(points)));
 		}
+		chain_vertices = std::move(new_chain_vertices);
 	}
 
 
-	/*
-	 * convert edge vectors to edge map
-	 * TODO: generate them directly and remove the vector types
+	/**
+	 * contract the chains of vertices with two neighbours into single edges,
+	 * the weights of the chain edges are summed up and their bisectors are
+	 * concatenated into a quadratic bisector, in which the linear parts are
+	 * subdivided into pieces not longer than max_seg_len (if > 0).
+	 * a vertex is kept in the middle of a chain that would otherwise form
+	 * a loop or repeat an existing edge.
+	 * the removed vertices are kept as inner chain vertices of their new edges.
+	 * @returns number of removed vertices
 	 */
-	void CreateEdgeMaps()
+	std::size_t ContractChains(t_scalar max_seg_len = 0)
 	{
-		for(const auto& edge : parabolic_edges_vec)
-		{
-			std::size_t idx1 = std::get<1>(edge);
-			std::size_t idx2 = std::get<2>(edge);
+		constexpr t_vert_index removed = std::numeric_limits<t_vert_index>::max();
+		const std::size_t num_verts = graph.GetNumVertices();
+		CompactGraph();
 
-			parabolic_edges.emplace(
-				std::make_pair(
-					std::make_pair(idx1, idx2),	// key
-					std::move(std::get<0>(edge))));
+		if(num_verts != vertices.size())
+		{
+			std::ostringstream ostrErr;
+			ostrErr << "Vertex count mismatch: " << num_verts << ". ";
+			ostrErr << "Vector size: " << vertices.size() << ".";
+			throw std::out_of_range(ostrErr.str());
 		}
 
-		for(const auto& edge : linear_edges_vec)
+		// distinct neighbours of the vertices
+		std::vector<std::vector<t_vert_index>> neighbours(num_verts);
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
 		{
-			const auto& _idx1 = std::get<1>(edge);
-			const auto& _idx2 = std::get<2>(edge);
-
-			std::size_t idx1 = _idx1 ? *_idx1 : std::numeric_limits<std::size_t>::max();
-			std::size_t idx2 = _idx2 ? *_idx2 : std::numeric_limits<std::size_t>::max();
+			std::vector<t_vert_index>& vert_neighbours = neighbours[vertidx];
+			for(std::size_t neighbour : graph.GetNeighbours(vertidx, true))
+				vert_neighbours.push_back(neighbour);
 
-			linear_edges.emplace(
-				std::make_pair(
-					std::make_pair(idx1, idx2),	// key
-					std::move(std::get<0>(edge))));
+			std::sort(vert_neighbours.begin(), vert_neighbours.end());
+			vert_neighbours.erase(std::unique(vert_neighbours.begin(), vert_neighbours.end()),
+				vert_neighbours.end());
 		}
-	}
 
+		// keep all vertices that don't have exactly two neighbours, that
+		// have a loop or that are the finite vertices of infinite bisectors
+		std::vector<bool> keep(num_verts, false);
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			const std::vector<t_vert_index>& vert_neighbours = neighbours[vertidx];
+			keep[vertidx] = vert_neighbours.size() != 2 ||
+				std::find(vert_neighbours.begin(), vert_neighbours.end(), vertidx)
+					!= vert_neighbours.end();
+		}
 
-	/**
-	 * create a spatial index tree
-	 */
-	void CreateIndexTree()
-	{
-		// iterate voronoi vertices
-		for(std::size_t idx=0; idx<vertices.size(); ++idx)
+		for(const auto& edge : linear_edges_vec)
 		{
-			// convert vertex to index vertex and insert it into the tree
-			const t_vec& vert = vertices[idx];
-			t_idxvertex<t_scalar> idxvert{vert[0], vert[1]};
+			const t_vert_index_opt& idx0 = std::get<1>(edge);
+			const t_vert_index_opt& idx1 = std::get<2>(edge);
 
-			idxtree.insert(std::make_tuple(idxvert, idx));
+			if(idx0 && !idx1 && *idx0 < num_verts)
+				keep[*idx0] = true;
+			else if(idx1 && !idx0 && *idx1 < num_verts)
+				keep[*idx1] = true;
 		}
-	}
 
+		// follow a chain from a kept vertex until the next kept vertex
+		auto trace_chain = [&neighbours, &keep](t_vert_index start, t_vert_index first,
+			std::vector<t_vert_index>& chain)
+		{
+			chain.clear();
+			chain.push_back(start);
+			chain.push_back(first);
 
-	/**
-	 * get the index of the closest n voronoi vertices
-	 */
-	std::vector<std::size_t>
-	GetClosestVoronoiVertices(const t_vec& vec, std::size_t n = 1, bool sort = false) const
-	{
-		std::vector<std::size_t> indices;
-		indices.reserve(n);
+			t_vert_index prev = start, cur = first;
+			while(!keep[cur])
+			{
+				const std::vector<t_vert_index>& cur_neighbours = neighbours[cur];
+				const t_vert_index next = cur_neighbours[0] == prev
+					? cur_neighbours[1] : cur_neighbours[0];
 
-		idxtree.query(boost::geometry::index::nearest(
-			t_idxvertex<t_scalar>(vec[0], vec[1]), n),
-			boost::make_function_output_iterator([&indices](const auto& val)
+				chain.push_back(next);
+				prev = cur;
+				cur = next;
+			}
+		};
+
+		// keep three vertices of every closed chain that doesn't have any kept vertex
+		std::vector<t_vert_index> chain;
+		std::vector<bool> visited(num_verts, false);
+
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(!keep[vertidx])
+				continue;
+
+			for(t_vert_index neighbour : neighbours[vertidx])
 			{
-				indices.push_back(std::get<1>(val));
-			}));
+				if(keep[neighbour] || visited[neighbour])
+					continue;
 
-		if(sort)
+				trace_chain(vertidx, neighbour, chain);
+				for(t_vert_index chainidx : chain)
+					visited[chainidx] = true;
+			}
+		}
+
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
 		{
-			std::stable_sort(indices.begin(), indices.end(),
-				[this, &vec](std::size_t idx1, std::size_t idx2) -> bool
-				{
-					using t_real = typename t_vec::value_type;
+			if(keep[vertidx] || visited[vertidx])
+				continue;
 
-					t_vec dir1 = vertices[idx1] - vec;
-					t_vec dir2 = vertices[idx2] - vec;
+			chain.clear();
+			t_vert_index prev = neighbours[vertidx][1], cur = vertidx;
+			do
+			{
+				chain.push_back(cur);
+				visited[cur] = true;
 
-					t_real len1 = tl2::inner<t_vec>(dir1, dir1);
-					t_real len2 = tl2::inner<t_vec>(dir2, dir2);
+				const t_vert_index next = neighbours[cur][0] == prev
+					? neighbours[cur][1] : neighbours[cur][0];
+				prev = cur;
+				cur = next;
+			}
+			while(cur != vertidx);
 
-					return len1 < len2;
-				});
+			keep[chain[0]] = true;
+			keep[chain[chain.size()/3]] = true;
+			keep[chain[2*chain.size()/3]] = true;
 		}
 
-		return indices;
-	}
-	// ------------------------------------------------------------------------
+		// collect the chains between the kept vertices, as long as vertices
+		// have to be kept to split loops or repeated edges
+		std::vector<std::vector<t_vert_index>> chains;
+		bool split_chains = true;
 
+		while(split_chains)
+		{
+			split_chains = false;
+			chains.clear();
 
-	void Clear()
+			std::vector<bool> traced(num_verts, false);
+			std::unordered_set<t_vert_indices,
+				t_bisector_hash<t_vert_indices>,
+				t_bisector_equ<t_vert_indices>> seen_edges;
+
+			// direct edges between kept vertices
+			for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+			{
+				if(!keep[vertidx])
+					continue;
+
+				for(t_vert_index neighbour : neighbours[vertidx])
+				{
+					if(!keep[neighbour] || neighbour <= vertidx)
+						continue;
+
+					chains.emplace_back(std::vector<t_vert_index>{ vertidx, neighbour });
+					seen_edges.insert(std::make_pair(vertidx, neighbour));
+				}
+			}
+
+			for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+			{
+				if(!keep[vertidx])
+					continue;
+
+				for(t_vert_index neighbour : neighbours[vertidx])
+				{
+					// chain already traced from its other end
+					if(keep[neighbour] || traced[neighbour])
+						continue;
+
+					trace_chain(vertidx, neighbour, chain);
+					for(std::size_t chainidx=1; chainidx<chain.size()-1; ++chainidx)
+						traced[chain[chainidx]] = true;
+
+					const t_vert_index endidx = chain.back();
+					const std::size_t num_inner = chain.size() - 2;
+
+					if(endidx == vertidx)
+					{
+						keep[chain[1 + num_inner/3]] = true;
+						keep[chain[1 + 2*num_inner/3]] = true;
+						split_chains = true;
+					}
+					else if(seen_edges.find(std::make_pair(vertidx, endidx)) != seen_edges.end())
+					{
+						keep[chain[1 + num_inner/2]] = true;
+						split_chains = true;
+					}
+					else
+					{
+						seen_edges.insert(std::make_pair(vertidx, endidx));
+						chains.push_back(chain);
+					}
+				}
+			}
+		}
+
+		// new indices of the kept vertices
+		std::vector<t_vert_index> remap(num_verts, removed);
+		std::size_t num_kept = 0;
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(keep[vertidx])
+				remap[vertidx] = num_kept++;
+		}
+
+		if(num_kept == num_verts)
+			return 0;
+
+		// get the bisector between two adjacent vertices, oriented from the first to the second one
+		auto get_bisector = [this, max_seg_len](t_vert_index idx0, t_vert_index idx1,
+			std::vector<t_vec>& points)
+		{
+			if(auto iter = parabolic_edges.find(std::make_pair(idx0, idx1));
+				iter != parabolic_edges.end() && iter->second.size())
+			{
+				const std::vector<t_vec>& bisector = iter->second;
+				const bool inverted =
+					tl2::norm<t_vec>(bisector.front() - vertices[idx0]) >
+					tl2::norm<t_vec>(bisector.front() - vertices[idx1]);
+
+				if(inverted)
+					points.insert(points.end(), bisector.rbegin() + 1, bisector.rend());
+				else
+					points.insert(points.end(), bisector.begin() + 1, bisector.end());
+				return;
+			}
+
+			const t_vec& vert0 = vertices[idx0];
+			const t_vec& vert1 = vertices[idx1];
+
+			if(max_seg_len > 0)
+			{
+				// limit the subdivisions of very long bisectors
+				const std::size_t num_segs = std::size_t(std::min<t_scalar>(
+					std::ceil(tl2::norm<t_vec>(vert1 - vert0) / max_seg_len), t_scalar(256)));
+				for(std::size_t seg=1; seg<num_segs; ++seg)
+					points.emplace_back(vert0 + (vert1 - vert0) * (t_scalar(seg) / t_scalar(num_segs)));
+			}
+
+			points.push_back(vert1);
+		};
+
+		// get the inner chain vertices between two adjacent vertices from an
+		// earlier contraction, oriented from the first to the second one
+		auto get_chain_vertices = [this](t_vert_index idx0, t_vert_index idx1,
+			std::vector<t_vec>& points)
+		{
+			auto iter = chain_vertices.find(std::make_pair(idx0, idx1));
+			if(iter == chain_vertices.end())
+				return;
+
+			if(iter->first.first == idx0)
+				points.insert(points.end(), iter->second.begin(), iter->second.end());
+			else
+				points.insert(points.end(), iter->second.rbegin(), iter->second.rend());
+		};
+
+		// rebuild the graph and the bisectors
+		t_graph newgraph{};
+		t_edgevec_lin new_linear_edges_vec{};
+		t_edgevec_quadr new_parabolic_edges_vec{};
+		t_edgevec_parabola new_parabolas_vec{};
+		t_edgemap_quadr new_chain_vertices{};
+
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(keep[vertidx])
+				newgraph.AddVertex(graph.GetVertexIdent(vertidx));
+		}
+
+		for(const std::vector<t_vert_index>& edge_chain : chains)
+		{
+			const t_vert_index idx0 = edge_chain.front();
+			const t_vert_index idx1 = edge_chain.back();
+
+			typename t_graph::t_weight weight{};
+			for(std::size_t chainidx=1; chainidx<edge_chain.size(); ++chainidx)
+			{
+				if(auto edge_weight = graph.GetWeight(edge_chain[chainidx - 1], edge_chain[chainidx]); edge_weight)
+					weight += *edge_weight;
+			}
+
+			newgraph.AddEdge(remap[idx0], remap[idx1], weight);
+			newgraph.AddEdge(remap[idx1], remap[idx0], weight);
+
+			// inner vertices of the chain, ordered from idx0 to idx1
+			std::vector<t_vec> inner_vertices;
+			for(std::size_t chainidx=1; chainidx<edge_chain.size(); ++chainidx)
+			{
+				get_chain_vertices(edge_chain[chainidx - 1], edge_chain[chainidx], inner_vertices);
+				if(chainidx < edge_chain.size() - 1)
+					inner_vertices.push_back(vertices[edge_chain[chainidx]]);
+			}
+
+			if(inner_vertices.size())
+			{
+				new_chain_vertices.emplace(std::make_pair(
+					std::make_pair(remap[idx0], remap[idx1]),
+					std::move(inner_vertices)));
+			}
+
+			// keep single linear bisectors
+			if(edge_chain.size() == 2 &&
+				parabolic_edges.find(std::make_pair(idx0, idx1)) == parabolic_edges.end())
+			{
+				if(auto iter = linear_edges.find(std::make_pair(
+					t_vert_index_opt{idx0}, t_vert_index_opt{idx1}));
+					iter != linear_edges.end())
+				{
+					new_linear_edges_vec.emplace_back(std::make_tuple(
+						iter->second, remap[idx0], remap[idx1]));
+				}
+				continue;
+			}
+
+			// keep the parameters of single quadratic bisectors
+			if(edge_chain.size() == 2)
+			{
+				if(auto iter = parabolas.find(std::make_pair(idx0, idx1)); iter != parabolas.end())
+				{
+					new_parabolas_vec.emplace_back(std::make_tuple(
+						iter->second, remap[idx0], remap[idx1]));
+				}
+			}
+
+			std::vector<t_vec> points{ vertices[idx0] };
+			for(std::size_t chainidx=1; chainidx<edge_chain.size(); ++chainidx)
+				get_bisector(edge_chain[chainidx - 1], edge_chain[chainidx], points);
+
+			new_parabolic_edges_vec.emplace_back(std::make_tuple(
+				std::move(points), remap[idx0], remap[idx1]));
+		}
+
+		// infinite linear bisectors
+		for(const auto& edge : linear_edges_vec)
+		{
+			const t_vert_index_opt& idx0 = std::get<1>(edge);
+			const t_vert_index_opt& idx1 = std::get<2>(edge);
+			if(idx0 && idx1)
+				continue;
+
+			t_vert_index_opt newidx0, newidx1;
+			if(idx0 && *idx0 < num_verts)
+				newidx0 = remap[*idx0];
+			if(idx1 && *idx1 < num_verts)
+				newidx1 = remap[*idx1];
+
+			new_linear_edges_vec.emplace_back(std::make_tuple(
+				std::get<0>(edge), newidx0, newidx1));
+		}
+
+		graph = std::move(newgraph);
+		linear_edges_vec = std::move(new_linear_edges_vec);
+		parabolic_edges_vec = std::move(new_parabolic_edges_vec);
+		parabolas_vec = std::move(new_parabolas_vec);
+		chain_vertices = std::move(new_chain_vertices);
+
+		// compact the vertex coordinates
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			if(remap[vertidx] != removed && remap[vertidx] != vertidx)
+				vertices[remap[vertidx]] = std::move(vertices[vertidx]);
+		}
+		vertices.resize(num_kept);
+
+		if(vertex_dists.size() == num_verts)
+		{
+			for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+			{
+				if(remap[vertidx] != removed)
+					vertex_dists[remap[vertidx]] = vertex_dists[vertidx];
+			}
+			vertex_dists.resize(num_kept);
+		}
+
+		linear_edges.clear();
+		parabolic_edges.clear();
+		parabolas.clear();
+		CreateEdgeMaps();
+
+		idxtree.clear();
+		CreateIndexTree();
+
+		return num_verts - num_kept;
+	}
+
+
+	/*
+	 * convert edge vectors to edge map
+	 * TODO: generate them directly and remove the vector types
+	 */
+	void CreateEdgeMaps()
+	{
+		for(const auto& edge : parabolic_edges_vec)
+		{
+			std::size_t idx1 = std::get<1>(edge);
+			std::size_t idx2 = std::get<2>(edge);
+
+			parabolic_edges.emplace(
+				std::make_pair(
+					std::make_pair(idx1, idx2),	// key
+					std::move(std::get<0>(edge))));
+		}
+
+		for(const auto& edge : parabolas_vec)
+		{
+			std::size_t idx1 = std::get<1>(edge);
+			std::size_t idx2 = std::get<2>(edge);
+
+			parabolas.emplace(
+				std::make_pair(
+					std::make_pair(idx1, idx2),	// key
+					std::move(std::get<0>(edge))));
+		}
+
+		for(const auto& edge : linear_edges_vec)
+		{
+			const auto& _idx1 = std::get<1>(edge);
+			const auto& _idx2 = std::get<2>(edge);
+
+			std::size_t idx1 = _idx1 ? *_idx1 : std::numeric_limits<std::size_t>::max();
+			std::size_t idx2 = _idx2 ? *_idx2 : std::numeric_limits<std::size_t>::max();
+
+			linear_edges.emplace(
+				std::make_pair(
+					std::make_pair(idx1, idx2),	// key
+					std::move(std::get<0>(edge))));
+		}
+	}
+
+
+	/**
+	 * get the points of the quadratic bisector between two voronoi vertices, ordered from idx0 to idx1.
+	 * bisectors with known parameters are sampled with a maximum chord distance of max_dist,
+	 * the others are returned as stored.
+	 */
+	std::vector<t_vec> GetParabolicEdge(t_vert_index idx0, t_vert_index idx1, t_scalar max_dist) const
+	{
+		if(auto iter = parabolas.find(std::make_pair(idx0, idx1));
+			iter != parabolas.end() && idx0 < vertices.size() && idx1 < vertices.size())
+		{
+			return sample_parabola<t_vec, t_line>(iter->second,
+				vertices[idx0], vertices[idx1], max_dist);
+		}
+
+		auto iter = parabolic_edges.find(std::make_pair(idx0, idx1));
+		if(iter == parabolic_edges.end())
+			return {};
+
+		std::vector<t_vec> points = iter->second;
+		if(points.size() && idx0 < vertices.size() && idx1 < vertices.size() &&
+			tl2::norm<t_vec>(points.front() - vertices[idx0]) >
+			tl2::norm<t_vec>(points.front() - vertices[idx1]))
+		{
+			std::reverse(points.begin(), points.end());
+		}
+
+		return points;
+	}
+
+
+	/**
+	 * create a spatial index tree,
+	 * it contains the voronoi vertices followed by the inner chain vertices
+	 */
+	void CreateIndexTree()
+	{
+		// the diagram is complete, merge the graph's pending edges
+		// before it gets read, possibly from several threads
+		CompactGraph();
+
+		// the inner chain vertices are reached from the closer vertex of their edge
+		chain_retraction_points.clear();
+		for(const auto& [indices, points] : chain_vertices)
+		{
+			for(std::size_t pointidx=0; pointidx<points.size(); ++pointidx)
+			{
+				const t_vert_index vertidx = 2*pointidx + 1 < points.size()
+					? indices.first : indices.second;
+				chain_retraction_points.emplace_back(std::make_pair(points[pointidx], vertidx));
+			}
+		}
+
+#if GEO_VORONOI_INDEX_TREE == 1
+		// iterate voronoi vertices
+		for(std::size_t idx=0; idx<vertices.size(); ++idx)
+		{
+			// convert vertex to index vertex and insert it into the tree
+			const t_vec& vert = vertices[idx];
+			t_idxvertex<t_scalar> idxvert{vert[0], vert[1]};
+
+			idxtree.insert(std::make_tuple(idxvert, idx));
+		}
+
+		for(std::size_t idx=0; idx<chain_retraction_points.size(); ++idx)
+		{
+			const t_vec& vert = chain_retraction_points[idx].first;
+			t_idxvertex<t_scalar> idxvert{vert[0], vert[1]};
+
+			idxtree.insert(std::make_tuple(idxvert, vertices.size() + idx));
+		}
+#elif GEO_VORONOI_INDEX_TREE == 2
+		// the tree indices are the voronoi vertex indices, followed by the chain vertices
+		std::vector<t_vec> idxverts = vertices;
+		idxverts.reserve(vertices.size() + chain_retraction_points.size());
+		for(const auto& point : chain_retraction_points)
+			idxverts.push_back(point.first);
+
+		idxtree.create(idxverts);
+#endif
+	}
+
+
+	/**
+	 * get the closest n points of the voronoi graph to which a path can retract,
+	 * these are the voronoi vertices and the inner vertices of contracted chains
+	 * @returns the points and the voronoi vertices from which they are reached
+	 */
+	std::vector<std::pair<t_vec, t_vert_index>>
+	GetClosestRetractionPoints(const t_vec& vec, std::size_t n = 1, bool sort = false) const
+	{
+#if GEO_VORONOI_INDEX_TREE == 1
+		std::vector<std::size_t> indices;
+		indices.reserve(n);
+
+		idxtree.query(boost::geometry::index::nearest(
+			t_idxvertex<t_scalar>(vec[0], vec[1]), n),
+			boost::make_function_output_iterator([&indices](const auto& val)
+			{
+				indices.push_back(std::get<1>(val));
+			}));
+#elif GEO_VORONOI_INDEX_TREE == 2
+		// the kd tree already returns the indices sorted by distance
+		std::vector<std::size_t> indices = idxtree.get_closest(vec, n);
+		sort = false;
+#endif
+
+		std::vector<std::pair<t_vec, t_vert_index>> points;
+		points.reserve(indices.size());
+
+		for(std::size_t idx : indices)
+		{
+			if(idx < vertices.size())
+				points.emplace_back(std::make_pair(vertices[idx], idx));
+			else if(idx - vertices.size() < chain_retraction_points.size())
+				points.push_back(chain_retraction_points[idx - vertices.size()]);
+		}
+
+		if(sort)
+		{
+			std::stable_sort(points.begin(), points.end(),
+				[&vec](const auto& point1, const auto& point2) -> bool
+				{
+					using t_real = typename t_vec::value_type;
+
+					t_vec dir1 = point1.first - vec;
+					t_vec dir2 = point2.first - vec;
+
+					t_real len1 = tl2::inner<t_vec>(dir1, dir1);
+					t_real len2 = tl2::inner<t_vec>(dir2, dir2);
+
+					return len1 < len2;
+				});
+		}
+
+		return points;
+	}
+	// ------------------------------------------------------------------------
+
+
+	void Clear()
 	{
 		vertices.clear();
+		vertex_dists.clear();
 		linear_edges.clear();
 		parabolic_edges.clear();
+		parabolas.clear();
+		chain_vertices.clear();
+		chain_retraction_points.clear();
 		graph.Clear();
 		idxtree.clear();
 	}
@@ -730,7 +1407,11 @@ public:
 	const t_edgemap_quadr& GetParabolicEdges() const { return parabolic_edges; }
 	const t_edgevec_lin& GetLinearEdgesVec() const { return linear_edges_vec; }
 	const t_edgevec_quadr& GetParabolicEdgesVec() const { return parabolic_edges_vec; }
+	const t_edgemap_parabola& GetParabolas() const { return parabolas; }
+	const t_edgevec_parabola& GetParabolasVec() const { return parabolas_vec; }
+	const t_edgemap_quadr& GetChainVertices() const { return chain_vertices; }
 	const std::vector<t_vec>& GetVoronoiVertices() const { return vertices; }
+	const std::vector<t_scalar>& GetVoronoiVertexDists() const { return vertex_dists; }
 	const t_graph& GetVoronoiGraph() const { return graph; }
 	const t_idxtree& GetVoronoiIndexTree() const { return idxtree; }
 
@@ -738,7 +1419,11 @@ public:
 	t_edgemap_quadr& GetParabolicEdges() { return parabolic_edges; }
 	t_edgevec_lin& GetLinearEdgesVec() { return linear_edges_vec; }
 	t_edgevec_quadr& GetParabolicEdgesVec() { return parabolic_edges_vec; }
+	t_edgemap_parabola& GetParabolas() { return parabolas; }
+	t_edgevec_parabola& GetParabolasVec() { return parabolas_vec; }
+	t_edgemap_quadr& GetChainVertices() { return chain_vertices; }
 	std::vector<t_vec>& GetVoronoiVertices() { return vertices; }
+	std::vector<t_scalar>& GetVoronoiVertexDists() { return vertex_dists; }
 	t_graph& GetVoronoiGraph() { return graph; }
 // ------------------------------------------------------------------------
 
@@ -751,9 +1436,18 @@ private:
 	// container type mapping voronoi vertex indices to their respective quadratic bisectors
 	t_edgemap_quadr parabolic_edges{};
 
+	// container type mapping voronoi vertex indices to the parameters of their quadratic bisectors,
+	// only available for bisectors that can be re-sampled
+	t_edgemap_parabola parabolas{};
+
 	// TODO: get rid of these and use the above maps directly
 	t_edgevec_lin linear_edges_vec{};
 	t_edgevec_quadr parabolic_edges_vec{};
+	t_edgevec_parabola parabolas_vec{};
+
+	// container type mapping the vertex indices of contracted edges to their removed
+	// inner chain vertices, ordered from the first to the second vertex of the key
+	t_edgemap_quadr chain_vertices{};
 	// ------------------------------------------------------------------------
 
 
@@ -761,12 +1455,23 @@ private:
 	// vertices
 	std::vector<t_vec> vertices{};
 
+	// distances of the vertices to their generating line segments,
+	// only available for freshly calculated diagrams
+	std::vector<t_scalar> vertex_dists{};
+
 	// voronoi vertex graph
 	// graph vertex indices correspond to those of the "vertices" vector
 	t_graph graph{};
 
+	// inner chain vertices in the index tree and the voronoi vertices from which they are reached
+	std::vector<std::pair<t_vec, t_vert_index>> chain_retraction_points{};
+
 	// voronoi vertex spatial index tree
+#if GEO_VORONOI_INDEX_TREE == 1
 	t_idxtree idxtree{typename t_idxtree::parameters_type(8)};
+#elif GEO_VORONOI_INDEX_TREE == 2
+	t_idxtree idxtree{2};
+#endif
 	// ------------------------------------------------------------------------
 };
 
@@ -787,7 +1492,8 @@ VoronoiLinesResults<t_vec, t_line, t_graph>
 calc_voro(const std::vector<t_line>& lines,
 	typename t_vec::value_type eps = std::sqrt(std::numeric_limits<typename t_vec::value_type>::epsilon()),
 	typename t_vec::value_type para_edge_eps = 1e-2,
-	const VoronoiLinesRegions<t_vec, t_line>* regions = nullptr)
+	const VoronoiLinesRegions<t_vec, t_line>* regions = nullptr,
+	unsigned int num_threads = 1)
 requires tl2::is_vec<t_vec> && is_graph<t_graph>
 {
 	namespace poly = boost::polygon;
@@ -857,20 +1563,45 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 		return cell->source_index();
 	};
 
+	// line group ranges [begin, end, group index], sorted by their begin index
+	using t_grouprange = std::tuple<std::size_t, std::size_t, std::size_t>;
+	std::vector<t_grouprange> group_ranges;
+	if(regions && regions->GetLineGroups())
+	{
+		const auto& line_groups = *regions->GetLineGroups();
+		group_ranges.reserve(line_groups.size());
+
+		for(std::size_t grpidx=0; grpidx<line_groups.size(); ++grpidx)
+		{
+			auto [grp_beg, grp_end] = line_groups[grpidx];
+			if(grp_beg < grp_end)
+				group_ranges.emplace_back(std::make_tuple(grp_beg, grp_end, grpidx));
+		}
+
+		std::stable_sort(group_ranges.begin(), group_ranges.end(),
+			[](const t_grouprange& range1, const t_grouprange& range2) -> bool
+		{
+			return std::get<0>(range1) < std::get<0>(range2);
+		});
+	}
+
 	// get the group index of the line segment
-	auto get_group_idx = [regions](std::size_t segidx)
+	auto get_group_idx = [&group_ranges](std::size_t segidx)
 		-> std::optional<std::size_t>
 	{
-		if(!regions)
-			return std::nullopt;
-
-		for(std::size_t grpidx=0; grpidx<regions->GetLineGroups()->size(); ++grpidx)
+		// find the last group starting at or before the segment
+		auto iter = std::upper_bound(group_ranges.begin(), group_ranges.end(), segidx,
+			[](std::size_t idx, const t_grouprange& range) -> bool
 		{
-			auto [grp_beg, grp_end] = (*regions->GetLineGroups())[grpidx];
+			return idx < std::get<0>(range);
+		});
 
-			if(segidx >= grp_beg && segidx < grp_end)
-				return grpidx;
-		}
+		if(iter == group_ranges.begin())
+			return std::nullopt;
+		--iter;
+
+		if(segidx < std::get<1>(*iter))
+			return std::get<2>(*iter);
 
 		// line is in neither region
 		return std::nullopt;
@@ -884,47 +1615,151 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 	t_graph& graph = results.GetVoronoiGraph();
 
 	// voronoi vertices
-	std::vector<const typename t_vorotraits::vertex_type*> vorovertices;
 	auto& vertices = results.GetVoronoiVertices();
-	vorovertices.reserve(voro.vertices().size());
+	auto& vertex_dists = results.GetVoronoiVertexDists();
 	vertices.reserve(voro.vertices().size());
+	vertex_dists.reserve(voro.vertices().size());
 
 	for(std::size_t vertidx=0; vertidx<voro.vertices().size(); ++vertidx)
 	{
 		const typename t_vorotraits::vertex_type* vert = &voro.vertices()[vertidx];
 		t_vec vorovert = tl2::create<t_vec>({ vert->x()/scale, vert->y()/scale });
 
-		vorovertices.push_back(vert);
+		// the vertex is equidistant to the generators of all its cells
+		t_real dist = 0;
+		if(const auto* edge = vert->incident_edge(); edge && edge->cell())
+		{
+			const t_line& line = lines[edge->cell()->source_index()];
+			dist = dist_pt_segment<t_vec>(vorovert, std::get<0>(line), std::get<1>(line));
+		}
+
 		vertices.emplace_back(std::move(vorovert));
+		vertex_dists.push_back(dist);
 		graph.AddVertex(std::to_string(vertices.size()));
 	}
 
 
-	// get the index of the given voronoi vertex
+	// get the index of the given voronoi vertex,
+	// the vertices are stored contiguously in the diagram
+	const typename t_vorotraits::vertex_type* vorovertices = voro.vertices().data();
+	const std::size_t num_vorovertices = voro.vertices().size();
+
 	auto get_vertex_idx =
-		[&vorovertices](const typename t_vorotraits::vertex_type* vert)
+		[vorovertices, num_vorovertices](const typename t_vorotraits::vertex_type* vert)
 			-> std::optional<std::size_t>
 	{
 		// infinite edge?
 		if(!vert)
 			return std::nullopt;
 
-		std::size_t idx = 0;
-		for(const typename t_vorotraits::vertex_type* vertex : vorovertices)
-		{
-			if(vertex == vert)
-				return idx;
-			++idx;
-		}
+		const std::size_t idx = static_cast<std::size_t>(vert - vorovertices);
+		if(idx >= num_vorovertices)
+			return std::nullopt;
 
-		return std::nullopt;
+		return idx;
 	};
 
 
-	// edges
-	//auto& all_parabolic_edges = results.GetParabolicEdges();
+	// classify the voronoi vertices
+	std::vector<std::uint8_t> vert_invalid(num_vorovertices, 0);
+	std::vector<std::uint8_t> vert_in_region(num_vorovertices, 0);
+	const bool check_regions = regions && regions->GetLineGroups()->size()
+		&& regions->GetRemoveVoronoiVertices();
+
+	if(regions)
+	{
+		for_each_chunk(num_vorovertices, num_threads,
+			[regions, check_regions, eps, &lines, &vertices, &vert_invalid, &vert_in_region]
+			(std::size_t begin, std::size_t end)
+		{
+			for(std::size_t vertidx=begin; vertidx<end; ++vertidx)
+			{
+				// vertices that don't satisfy the external validation function
+				vert_invalid[vertidx] = !regions->ValidateVertex(vertices[vertidx]);
+
+				// vertices inside regions
+				if(check_regions)
+					vert_in_region[vertidx] = regions->IsVertexInRegion(lines, vertices[vertidx], eps);
+			}
+		});
+	}
+
+
+	// classify the voronoi edges, an edge and its twin share their flags
+	const auto* voroedges = voro.edges().data();
+	const std::size_t num_voroedges = voro.edges().size();
+	std::vector<std::uint8_t> keep_edge(num_voroedges, 0);
+
+	for_each_chunk(num_voroedges, num_threads,
+		[regions, check_regions, eps, voroedges, &lines, &vertices,
+		&vert_invalid, &vert_in_region, &keep_edge,
+		&get_vertex_idx, &get_segment_idx, &get_group_idx]
+		(std::size_t begin, std::size_t end)
+	{
+		for(std::size_t edgeidx=begin; edgeidx<end; ++edgeidx)
+		{
+			const auto& edge = voroedges[edgeidx];
+			const std::size_t twinidx = static_cast<std::size_t>(edge.twin() - voroedges);
+			if(twinidx < edgeidx)
+				continue;
+
+			// only bisectors, no internal edges
+			if(edge.is_secondary())
+				continue;
+
+			// line groups defined?
+			if(regions)
+			{
+				auto vert0idx = get_vertex_idx(edge.vertex0());
+				auto vert1idx = get_vertex_idx(edge.vertex1());
+
+				// remove vertices that don't satisfy the external validation function
+				if(vert0idx && vert1idx && vert_invalid[*vert0idx] && vert_invalid[*vert1idx])
+					continue;
+
+				// remove vertices inside regions
+				if(regions->GetLineGroups()->size())
+				{
+					// get index of the segment
+					auto seg1idx = get_segment_idx(edge, false);
+					auto seg2idx = get_segment_idx(edge, true);
+
+					if(seg1idx && seg2idx && regions->GetGroupLines())
+					{
+						// get the group index of the segments
+						auto region1 = get_group_idx(*seg1idx);
+						auto region2 = get_group_idx(*seg2idx);
+
+						// are the generating line segments part of the same group?
+						// if so, ignore this voronoi edge
+						if(region1 && region2 && *region1 == *region2)
+							continue;
+					}
+
+					if(check_regions)
+					{
+						bool in_region = false;
+						if(vert0idx && vert1idx)
+							in_region = vert_in_region[*vert0idx] || vert_in_region[*vert1idx];
+						else
+							in_region = regions->IsVertexInRegion(lines, vertices, vert0idx, vert1idx, eps);
+
+						if(in_region)
+							continue;
+					}
+				}
+			}
+
+			keep_edge[edgeidx] = 1;
+		}
+	});
+
+
+	// edges
+	//auto& all_parabolic_edges = results.GetParabolicEdges();
 	//auto& linear_edges = results.GetLinearEdges();
 	auto& all_parabolic_edges_vec = results.GetParabolicEdgesVec();
+	auto& parabolas_vec = results.GetParabolasVec();
 	auto& linear_edges_vec = results.GetLinearEdgesVec();
 
 	linear_edges_vec.reserve(voro.edges().size());
@@ -935,8 +1770,10 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 		t_bisector_hash<t_bisector>,
 		t_bisector_equ<t_bisector>> seen_bisectors;
 
-	for(const auto& edge : voro.edges())
+	for(std::size_t edgeidx=0; edgeidx<num_voroedges; ++edgeidx)
 	{
+		const auto& edge = voroedges[edgeidx];
+
 		// only bisectors, no internal edges
 		if(edge.is_secondary())
 			continue;
@@ -959,48 +1796,10 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 				seen_bisectors.insert(bisector);
 		}
 
-		// line groups defined?
-		if(regions)
-		{
-			bool vert_1_invalid = false;
-			bool vert_2_invalid = false;
-
-			// remove vertices that don't satisfy the external validation function
-			if(vert0idx && !regions->ValidateVertex(vertices[*vert0idx]))
-				vert_1_invalid = true;
-			if(vert1idx && !regions->ValidateVertex(vertices[*vert1idx]))
-				vert_2_invalid = true;
-
-			if(vert_1_invalid && vert_2_invalid)
-				continue;
-
-			// remove vertices inside regions
-			if(regions->GetLineGroups()->size())
-			{
-				// get index of the segment
-				auto seg1idx = get_segment_idx(edge, false);
-				auto seg2idx = get_segment_idx(edge, true);
-
-				if(seg1idx && seg2idx)
-				{
-					// get the group index of the segments
-					auto region1 = get_group_idx(*seg1idx);
-					auto region2 = get_group_idx(*seg2idx);
-
-					if(regions->GetGroupLines())
-					{
-						// are the generating line segments part of the same group?
-						// if so, ignore this voronoi edge and skip to next one
-						if(region1 && region2 && *region1 == *region2)
-							continue;
-					}
-				}
-
-				if(regions->IsVertexInRegion(lines,
-					vertices, vert0idx, vert1idx, eps))
-					continue;
-			}
-		}
+		// was the edge (or its twin) removed in the classification?
+		const std::size_t twinidx = static_cast<std::size_t>(edge.twin() - voroedges);
+		if(!keep_edge[std::min(edgeidx, twinidx)])
+			continue;
 
 		if(valid_vertices)
 		{
@@ -1058,37 +1857,12 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 
 
 		// converter functions
-		auto to_point_data = [](const t_vec& vec) -> poly::point_data<t_real>
-		{
-			return poly::point_data<t_real>{vec[0], vec[1]};
-		};
-
-		auto vertex_to_point_data = [&scale](const typename t_vorotraits::vertex_type& vec)
-			-> poly::point_data<t_real>
-		{
-			return poly::point_data<t_real>{vec.x()/scale, vec.y()/scale};
-		};
-
-		auto to_vec = [](const poly::point_data<t_real>& pt) -> t_vec
-		{
-			return tl2::create<t_vec>({ pt.x(), pt.y() });
-		};
-
 		auto vertex_to_vec = [](const typename t_vorotraits::vertex_type& vec)
 			-> t_vec
 		{
 			return tl2::create<t_vec>({ vec.x(), vec.y() });
 		};
 
-		auto to_segment_data = [&to_point_data](const t_line& line)
-			-> poly::segment_data<t_real>
-		{
-			auto pt1 = to_point_data(std::get<0>(line));
-			auto pt2 = to_point_data(std::get<1>(line));
-
-			return poly::segment_data<t_real>{pt1, pt2};
-		};
-
 
 		// parabolic edge
 		if(edge.is_curved() && edge.is_finite())
@@ -1098,23 +1872,13 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 			if(!seg || !pt)
 				continue;
 
-			std::vector<poly::point_data<t_real>> parabola{{
-				vertex_to_point_data(*vert0),
-				vertex_to_point_data(*vert1)
-			}};
+			// adaptively sample the parabola up to the given chord distance
+			VoronoiParabola<t_vec, t_line> parabola{ .focus = *pt, .directrix = *seg };
+			std::vector<t_vec> parabolic_edges = sample_parabola<t_vec, t_line>(
+				parabola, vertices[*vert0idx], vertices[*vert1idx], para_edge_eps);
 
-			poly::voronoi_visual_utils<t_real>::discretize(
-				to_point_data(*pt), to_segment_data(*seg),
-				para_edge_eps, &parabola);
-
-			if(parabola.size())
+			if(parabolic_edges.size())
 			{
-				std::vector<t_vec> parabolic_edges;
-				parabolic_edges.reserve(parabola.size());
-
-				for(const auto& parabola_pt : parabola)
-					parabolic_edges.emplace_back(to_vec(parabola_pt));
-
 				// update edge weight for parabolic case
 				t_real len = path_length<t_vec>(parabolic_edges);
 				graph.SetWeight(*vert0idx, *vert1idx, len);
@@ -1124,6 +1888,10 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 					std::make_tuple(
 						std::move(parabolic_edges),
 						*vert0idx, *vert1idx));
+				parabolas_vec.emplace_back(
+					std::make_tuple(
+						std::move(parabola),
+						*vert0idx, *vert1idx));
 				/*all_parabolic_edges.emplace(
 					std::make_pair(
 						std::make_pair(*vert0idx, *vert1idx),
@@ -1206,6 +1974,1042 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 }
 
 
+/**
+ * voronoi diagram for line segments, calculated in overlapping tiles (using boost)
+ *
+ * every tile only sees the line segments close to it. the tile keeps the edges
+ * inside the bounding rectangle of the line segments whose lexicographically smaller
+ * vertex lies in its core rectangle, these are exact if the empty circles around all
+ * their points lie inside the tile's extended rectangle. otherwise the extended
+ * rectangle grows and the tile is recalculated.
+ *
+ * the edges leaving the bounding rectangle are calculated in an outer pass, which only
+ * sees the line segments whose voronoi cells can reach outside the bounding rectangle,
+ * and the ones inside the empty circles around the edges' inner parts.
+ * the tiles and the outer pass are calculated in parallel and the kept edges are
+ * stitched afterwards.
+ *
+ * the vertices at infinity aren't calculated, so the infinite edges are missing.
+ */
+template<class t_vec,
+	class t_line = std::pair<t_vec, t_vec>,
+	class t_graph = AdjacencyMatrix<typename t_vec::value_type>,
+	class t_int = int>
+VoronoiLinesResults<t_vec, t_line, t_graph>
+calc_voro_tiled(const std::vector<t_line>& lines,
+	typename t_vec::value_type eps = std::sqrt(std::numeric_limits<typename t_vec::value_type>::epsilon()),
+	typename t_vec::value_type para_edge_eps = 1e-2,
+	const VoronoiLinesRegions<t_vec, t_line>* regions = nullptr,
+	unsigned int tiles_per_axis = 2,
+	typename t_vec::value_type overlap = 0.1,
+	unsigned int num_threads = 1)
+requires tl2::is_vec<t_vec> && is_graph<t_graph>
+{
+	using t_real = typename t_vec::value_type;
+	using t_results = VoronoiLinesResults<t_vec, t_line, t_graph>;
+	using t_regions = VoronoiLinesRegions<t_vec, t_line>;
+	using t_vert_index_opt = typename t_results::t_vert_index_opt;
+
+	// rectangle [min_x, min_y, max_x, max_y]
+	using t_rect = std::array<t_real, 4>;
+
+	// bounding rectangle of all line segments
+	t_rect bounds{{
+		std::numeric_limits<t_real>::max(), std::numeric_limits<t_real>::max(),
+		std::numeric_limits<t_real>::lowest(), std::numeric_limits<t_real>::lowest() }};
+
+	for(const t_line& line : lines)
+	{
+		for(const t_vec* vec : { &std::get<0>(line), &std::get<1>(line) })
+		{
+			bounds[0] = std::min(bounds[0], (*vec)[0]);
+			bounds[1] = std::min(bounds[1], (*vec)[1]);
+			bounds[2] = std::max(bounds[2], (*vec)[0]);
+			bounds[3] = std::max(bounds[3], (*vec)[1]);
+		}
+	}
+
+	if(lines.size() == 0 || tiles_per_axis <= 1)
+	{
+		return calc_voro<t_vec, t_line, t_graph, t_int>(
+			lines, eps, para_edge_eps, regions, num_threads);
+	}
+
+	const t_real tile_w = (bounds[2] - bounds[0]) / t_real(tiles_per_axis);
+	const t_real tile_h = (bounds[3] - bounds[1]) / t_real(tiles_per_axis);
+	const std::size_t num_tiles = std::size_t(tiles_per_axis) * std::size_t(tiles_per_axis);
+
+	// is the rectangle inside the other one?
+	auto rect_inside = [](const t_rect& rect, const t_rect& outer) -> bool
+	{
+		return rect[0] >= outer[0] && rect[1] >= outer[1] &&
+			rect[2] <= outer[2] && rect[3] <= outer[3];
+	};
+
+	// is the point inside the rectangle?
+	auto pt_inside = [](const t_vec& pt, const t_rect& rect) -> bool
+	{
+		return pt[0] >= rect[0] && pt[1] >= rect[1] &&
+			pt[0] <= rect[2] && pt[1] <= rect[3];
+	};
+
+	// group indices of the line segments
+	constexpr std::size_t no_group = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> line_groups(lines.size(), no_group);
+	const bool has_groups = regions && regions->GetLineGroups() && regions->GetLineGroups()->size();
+
+	if(has_groups)
+	{
+		const auto& groups = *regions->GetLineGroups();
+		for(std::size_t grpidx=0; grpidx<groups.size(); ++grpidx)
+		{
+			auto [grp_beg, grp_end] = groups[grpidx];
+			for(std::size_t lineidx=grp_beg; lineidx<std::min(grp_end, lines.size()); ++lineidx)
+				line_groups[lineidx] = grpidx;
+		}
+	}
+
+	// the tiles test the vertices against the regions of all line segments
+	std::function<bool(const t_vec&)> region_func =
+		[regions, &lines, eps](const t_vec& vert) -> bool
+	{
+		return regions->IsVertexInRegion(lines, vert, eps);
+	};
+
+	// select the line segments for which pred(lineidx) is true, and their line groups
+	auto select_lines = [&lines, &line_groups](const auto& pred, std::vector<t_line>& sel_lines,
+		std::vector<std::pair<std::size_t, std::size_t>>& sel_groups)
+	{
+		sel_lines.clear();
+		sel_groups.clear();
+		std::size_t last_group = no_group;
+
+		for(std::size_t lineidx=0; lineidx<lines.size(); ++lineidx)
+		{
+			if(!pred(lineidx))
+				continue;
+
+			// the lines of a group stay contiguous
+			const std::size_t group = line_groups[lineidx];
+			if(group != no_group)
+			{
+				if(group == last_group)
+					++std::get<1>(*sel_groups.rbegin());
+				else
+					sel_groups.emplace_back(std::make_pair(sel_lines.size(), sel_lines.size() + 1));
+			}
+			last_group = group;
+
+			sel_lines.push_back(lines[lineidx]);
+		}
+	};
+
+	// calculate the voronoi diagram of a subset of the line segments
+	auto calc_lines = [&](const std::vector<t_line>& sel_lines,
+		std::vector<std::pair<std::size_t, std::size_t>>& sel_groups) -> t_results
+	{
+		// keep the region checks enabled even if no groups are selected
+		if(has_groups && sel_groups.size() == 0)
+			sel_groups.emplace_back(std::make_pair(0, 0));
+
+		if(!regions)
+		{
+			return calc_voro<t_vec, t_line, t_graph, t_int>(
+				sel_lines, eps, para_edge_eps, nullptr, 1);
+		}
+
+		t_regions sel_regions = *regions;
+		sel_regions.SetLineGroups(&sel_groups);
+		sel_regions.SetPointsOutsideRegions(nullptr);
+		sel_regions.SetInvertedRegions(nullptr);
+		sel_regions.SetRegionFunc(&region_func);
+
+		return calc_voro<t_vec, t_line, t_graph, t_int>(
+			sel_lines, eps, para_edge_eps, &sel_regions, 1);
+	};
+
+	// is the line segment touching the rectangle?
+	auto line_in_rect = [](const t_line& line, const t_rect& rect) -> bool
+	{
+		return std::max(std::get<0>(line)[0], std::get<1>(line)[0]) >= rect[0] &&
+			std::max(std::get<0>(line)[1], std::get<1>(line)[1]) >= rect[1] &&
+			std::min(std::get<0>(line)[0], std::get<1>(line)[0]) <= rect[2] &&
+			std::min(std::get<0>(line)[1], std::get<1>(line)[1]) <= rect[3];
+	};
+
+	// bounding box of a circle, including the tolerance
+	auto get_circle_rect = [eps](const t_vec& centre, t_real rad) -> t_rect
+	{
+		rad = rad*(t_real(1) + eps) + eps;
+		return t_rect{{ centre[0] - rad, centre[1] - rad,
+			centre[0] + rad, centre[1] + rad }};
+	};
+
+	// iterate the edges of a graph for which pred(vert0, vert1) is true
+	auto for_each_edge_if = [](const t_results& res, const auto& pred, const auto& func)
+	{
+		const t_graph& graph = res.GetVoronoiGraph();
+		const auto& vertices = res.GetVoronoiVertices();
+
+		for(std::size_t vert0idx=0; vert0idx<graph.GetNumVertices(); ++vert0idx)
+		{
+			for(std::size_t vert1idx : graph.GetNeighbours(vert0idx))
+			{
+				if(vert1idx <= vert0idx)
+					continue;
+				if(!pred(vertices[vert0idx], vertices[vert1idx]))
+					continue;
+
+				func(vert0idx, vert1idx);
+			}
+		}
+	};
+
+	// the vertices inside the bounding rectangle are calculated by the tiles
+	const t_rect bounds_eps{{ bounds[0] - eps, bounds[1] - eps,
+		bounds[2] + eps, bounds[3] + eps }};
+
+	// call func with the bounding boxes of the empty circles around the points of a
+	// straight piece (or ray) inside the bounding rectangle. the distance to the
+	// generators is convex along straight pieces, so the boxes at the end points also
+	// contain the ones between, get_rad gives an upper bound of the distance
+	auto for_each_piece_circle = [&bounds, &bounds_eps, &get_circle_rect](
+		const t_vec& pt0, const t_vec& pt1, bool ray, const auto& get_rad, const auto& func)
+	{
+		const t_vec dir = pt1 - pt0;
+		t_real param0 = 0;
+		t_real param1 = ray ? std::numeric_limits<t_real>::max() : t_real(1);
+
+		for(std::size_t i=0; i<2; ++i)
+		{
+			// parallel to the border
+			if(std::abs(dir[i]) <= std::numeric_limits<t_real>::epsilon())
+			{
+				if(pt0[i] < bounds_eps[i] || pt0[i] > bounds_eps[i + 2])
+					return;
+				continue;
+			}
+
+			t_real param_lower = (bounds[i] - pt0[i]) / dir[i];
+			t_real param_upper = (bounds[i + 2] - pt0[i]) / dir[i];
+			if(param_lower > param_upper)
+				std::swap(param_lower, param_upper);
+
+			param0 = std::max(param0, param_lower);
+			param1 = std::min(param1, param_upper);
+		}
+
+		if(param0 > param1)
+			return;
+
+		const t_vec clipped0 = pt0 + param0*dir;
+		const t_vec clipped1 = pt0 + param1*dir;
+		func(get_circle_rect(clipped0, get_rad(clipped0)));
+		func(get_circle_rect(clipped1, get_rad(clipped1)));
+	};
+
+	// call func with the bounding boxes of the empty circles around
+	// the points of the finite edges inside the bounding rectangle
+	auto for_each_edge_circle = [&for_each_piece_circle](const t_results& res,
+		std::size_t vert0idx, std::size_t vert1idx, const auto& func)
+	{
+		const auto& vertices = res.GetVoronoiVertices();
+		const auto& dists = res.GetVoronoiVertexDists();
+		const auto& parabolic_edges = res.GetParabolicEdges();
+		const t_vec& vert0 = vertices[vert0idx];
+		const t_vec& vert1 = vertices[vert1idx];
+
+		// points along the edge
+		std::vector<t_vec> pts{{ vert0 }};
+		if(auto iter = parabolic_edges.find(std::make_pair(vert0idx, vert1idx));
+			iter != parabolic_edges.end())
+		{
+			if(std::get<0>(iter->first) == vert0idx)
+				pts.insert(pts.end(), iter->second.begin(), iter->second.end());
+			else
+				pts.insert(pts.end(), iter->second.rbegin(), iter->second.rend());
+		}
+		pts.push_back(vert1);
+
+		auto get_rad = [&](const t_vec& pt) -> t_real
+		{
+			return std::min(
+				tl2::norm<t_vec>(pt - vert0) + dists[vert0idx],
+				tl2::norm<t_vec>(pt - vert1) + dists[vert1idx]);
+		};
+
+		for(std::size_t ptidx=0; ptidx+1<pts.size(); ++ptidx)
+			for_each_piece_circle(pts[ptidx], pts[ptidx + 1], false, get_rad, func);
+	};
+
+	// call func with the bounding boxes of the empty circles around the points of the
+	// infinite edges inside the bounding rectangle, if pred(vert) is true for their vertex
+	auto for_each_infinite_edge_circle = [&for_each_piece_circle](const t_results& res,
+		const auto& pred, const auto& func)
+	{
+		const auto& vertices = res.GetVoronoiVertices();
+		const auto& dists = res.GetVoronoiVertexDists();
+
+		for(const auto& [line, vert0idx, vert1idx] : res.GetLinearEdgesVec())
+		{
+			if(vert0idx.has_value() == vert1idx.has_value())
+				continue;
+
+			const std::size_t vertidx = vert0idx ? *vert0idx : *vert1idx;
+			const t_vec& vert = vertices[vertidx];
+			if(!pred(vert))
+				continue;
+
+			auto get_rad = [&vert, &dists, vertidx](const t_vec& pt) -> t_real
+			{
+				return tl2::norm<t_vec>(pt - vert) + dists[vertidx];
+			};
+
+			// the line starts at the finite vertex
+			for_each_piece_circle(std::get<0>(line), std::get<1>(line), true, get_rad, func);
+		}
+	};
+
+
+	struct t_tile
+	{
+		t_rect core{}, ext{};
+		t_results results{};
+	};
+
+	std::vector<t_tile> tiles(num_tiles);
+
+	// is the edge assigned to the tile?
+	auto is_tile_edge = [&pt_inside, &bounds_eps, eps](const t_tile& tile,
+		const t_vec& vert0, const t_vec& vert1) -> bool
+	{
+		const t_rect core{{ tile.core[0] - eps, tile.core[1] - eps,
+			tile.core[2] + eps, tile.core[3] + eps }};
+
+		// degenerate edge
+		if(std::abs(vert0[0] - vert1[0]) <= eps && std::abs(vert0[1] - vert1[1]) <= eps)
+			return pt_inside(vert0, core) || pt_inside(vert1, core);
+
+		// edges leaving the bounding rectangle belong to the outer pass
+		if(!pt_inside(vert0, bounds_eps) || !pt_inside(vert1, bounds_eps))
+			return false;
+
+		bool vert0_first = vert0[0] < vert1[0] || (vert0[0] == vert1[0] && vert0[1] < vert1[1]);
+		return pt_inside(vert0_first ? vert0 : vert1, core);
+	};
+
+	// calculate the voronoi diagram of a tile
+	auto calc_tile = [&](std::size_t tileidx)
+	{
+		t_tile& tile = tiles[tileidx];
+		const std::size_t tile_x = tileidx % tiles_per_axis;
+		const std::size_t tile_y = tileidx / tiles_per_axis;
+
+		const t_real overlap_len = overlap * std::max(tile_w, tile_h);
+		tile.core[0] = bounds[0] + t_real(tile_x) * tile_w;
+		tile.core[1] = bounds[1] + t_real(tile_y) * tile_h;
+		tile.core[2] = bounds[0] + t_real(tile_x + 1) * tile_w;
+		tile.core[3] = bounds[1] + t_real(tile_y + 1) * tile_h;
+		tile.ext = t_rect{{ tile.core[0] - overlap_len, tile.core[1] - overlap_len,
+			tile.core[2] + overlap_len, tile.core[3] + overlap_len }};
+
+		// line segments touching the extended tile, and their line groups
+		std::vector<t_line> tile_lines;
+		std::vector<std::pair<std::size_t, std::size_t>> tile_groups;
+
+		auto select_tile_lines = [&]()
+		{
+			select_lines([&lines, &line_in_rect, &tile](std::size_t lineidx) -> bool
+			{
+				return line_in_rect(lines[lineidx], tile.ext);
+			}, tile_lines, tile_groups);
+		};
+
+		// the extended tile has to contain the empty circles around all points of the core,
+		// the distance to the closest line segment is 1-lipschitz, so its maximum
+		// is bounded by the values on a sample grid plus half the grid diagonal
+		const t_rect& sample_rect = tile.core;
+		constexpr std::size_t num_samples = 16;
+		const t_real sample_w = (sample_rect[2] - sample_rect[0]) / t_real(num_samples);
+		const t_real sample_h = (sample_rect[3] - sample_rect[1]) / t_real(num_samples);
+
+		while(true)
+		{
+			select_tile_lines();
+
+			// no line segments in the tile: extend it to all of them
+			if(tile_lines.size() == 0)
+			{
+				tile.ext = t_rect{{
+					std::min(tile.ext[0], bounds[0]), std::min(tile.ext[1], bounds[1]),
+					std::max(tile.ext[2], bounds[2]), std::max(tile.ext[3], bounds[3]) }};
+				continue;
+			}
+
+			t_real max_dist = 0;
+			for(std::size_t sample_y=0; sample_y<num_samples; ++sample_y)
+			for(std::size_t sample_x=0; sample_x<num_samples; ++sample_x)
+			{
+				const t_vec pt = tl2::create<t_vec>({
+					sample_rect[0] + (t_real(sample_x) + t_real(0.5)) * sample_w,
+					sample_rect[1] + (t_real(sample_y) + t_real(0.5)) * sample_h });
+
+				// an upper bound is sufficient, so only check the tile's line segments
+				t_real dist = std::numeric_limits<t_real>::max();
+				for(const t_line& line : tile_lines)
+					dist = std::min(dist, dist_pt_segment<t_vec>(pt, std::get<0>(line), std::get<1>(line)));
+				max_dist = std::max(max_dist, dist);
+			}
+
+			max_dist += t_real(0.5)*std::sqrt(sample_w*sample_w + sample_h*sample_h) + eps;
+			const t_rect ext{{
+				std::min(tile.ext[0], sample_rect[0] - max_dist),
+				std::min(tile.ext[1], sample_rect[1] - max_dist),
+				std::max(tile.ext[2], sample_rect[2] + max_dist),
+				std::max(tile.ext[3], sample_rect[3] + max_dist) }};
+
+			if(rect_inside(ext, tile.ext))
+				break;
+			tile.ext = ext;
+		}
+
+		while(true)
+		{
+			const bool complete = (tile_lines.size() == lines.size());
+			tile.results = calc_lines(tile_lines, tile_groups);
+
+			// the diagram of all line segments is exact
+			if(complete)
+				break;
+
+			// check if the empty circles around the edges at the core's vertices are inside the
+			// extended tile. the edges at a core vertex are exact up to their other vertex,
+			// which is wrong if a line segment is missing, but then it lies in the checked circles
+			t_rect ext = tile.ext;
+			const t_rect core{{ tile.core[0] - eps, tile.core[1] - eps,
+				tile.core[2] + eps, tile.core[3] + eps }};
+
+			auto at_core = [&pt_inside, &core](const t_vec& vert0, const t_vec& vert1) -> bool
+			{
+				return pt_inside(vert0, core) || pt_inside(vert1, core);
+			};
+
+			auto add_circle = [&ext](const t_rect& circle)
+			{
+				ext[0] = std::min(ext[0], circle[0]);
+				ext[1] = std::min(ext[1], circle[1]);
+				ext[2] = std::max(ext[2], circle[2]);
+				ext[3] = std::max(ext[3], circle[3]);
+			};
+
+			for_each_edge_if(tile.results, at_core, [&](std::size_t vert0idx, std::size_t vert1idx)
+			{
+				for_each_edge_circle(tile.results, vert0idx, vert1idx, add_circle);
+			});
+
+			// infinite edges of the tile can be finite with all line segments
+			for_each_infinite_edge_circle(tile.results, [&pt_inside, &core](const t_vec& vert) -> bool
+			{
+				return pt_inside(vert, core);
+			}, add_circle);
+
+			if(rect_inside(ext, tile.ext))
+				break;
+
+			// grow the tile and recalculate
+			tile.ext = ext;
+			select_tile_lines();
+		}
+	};
+
+
+	// the outer pass calculates the edges leaving the bounding rectangle
+	t_results outer_results{};
+
+	// is the edge assigned to the outer pass?
+	auto is_outer_edge = [&pt_inside, &bounds_eps](const t_vec& vert0, const t_vec& vert1) -> bool
+	{
+		return !pt_inside(vert0, bounds_eps) || !pt_inside(vert1, bounds_eps);
+	};
+
+	auto calc_outer = [&]()
+	{
+		// the voronoi cell of a line segment can only reach outside the bounding rectangle
+		// if the line segment is closest to a point on its border. as the distance to the
+		// closest line segment is 1-lipschitz, a line segment can only be the closest one
+		// to a point between two border samples if it is close to one of the samples
+		constexpr std::size_t num_samples = 16;
+		std::vector<std::pair<t_vec, t_real>> samples;
+		samples.reserve(4 * num_samples * tiles_per_axis + 4);
+
+		const t_real sample_w = (bounds[2] - bounds[0]) / t_real(num_samples * tiles_per_axis);
+		const t_real sample_h = (bounds[3] - bounds[1]) / t_real(num_samples * tiles_per_axis);
+
+		for(std::size_t sample=0; sample<=num_samples * tiles_per_axis; ++sample)
+		{
+			const t_real x = bounds[0] + t_real(sample) * sample_w;
+			const t_real y = bounds[1] + t_real(sample) * sample_h;
+
+			for(const t_vec& pt : {
+				tl2::create<t_vec>({ x, bounds[1] }), tl2::create<t_vec>({ x, bounds[3] }),
+				tl2::create<t_vec>({ bounds[0], y }), tl2::create<t_vec>({ bounds[2], y }) })
+			{
+				t_real dist = std::numeric_limits<t_real>::max();
+				for(const t_line& line : lines)
+					dist = std::min(dist, dist_pt_segment<t_vec>(pt, std::get<0>(line), std::get<1>(line)));
+
+				samples.emplace_back(std::make_pair(pt, dist + std::max(sample_w, sample_h) + eps));
+			}
+		}
+
+		std::vector<bool> selected(lines.size(), false);
+		for(std::size_t lineidx=0; lineidx<lines.size(); ++lineidx)
+		{
+			const t_line& line = lines[lineidx];
+			selected[lineidx] = std::any_of(samples.begin(), samples.end(),
+				[&line](const std::pair<t_vec, t_real>& sample) -> bool
+			{
+				return dist_pt_segment<t_vec>(sample.first,
+					std::get<0>(line), std::get<1>(line)) <= sample.second;
+			});
+		}
+
+		std::vector<t_line> outer_lines;
+		std::vector<std::pair<std::size_t, std::size_t>> outer_groups;
+
+		while(true)
+		{
+			select_lines([&selected](std::size_t lineidx) -> bool
+			{
+				return selected[lineidx];
+			}, outer_lines, outer_groups);
+
+			const bool complete = (outer_lines.size() == lines.size());
+			outer_results = calc_lines(outer_lines, outer_groups);
+
+			// the diagram of all line segments is exact
+			if(complete)
+				break;
+
+			// outside the bounding rectangle the selected line segments already
+			// give the exact diagram. inside it, the empty circles around the
+			// edges have to contain only selected line segments
+			std::vector<t_rect> circles;
+			auto add_circle = [&circles](const t_rect& circle)
+			{
+				circles.push_back(circle);
+			};
+
+			for_each_edge_if(outer_results, is_outer_edge, [&](std::size_t vert0idx, std::size_t vert1idx)
+			{
+				for_each_edge_circle(outer_results, vert0idx, vert1idx, add_circle);
+			});
+
+			// infinite edges can be finite with all line segments
+			for_each_infinite_edge_circle(outer_results, [&pt_inside, &bounds_eps](const t_vec& vert) -> bool
+			{
+				return !pt_inside(vert, bounds_eps);
+			}, add_circle);
+
+			// add the line segments touching the empty circles
+			bool grown = false;
+			for(std::size_t lineidx=0; lineidx<lines.size(); ++lineidx)
+			{
+				if(selected[lineidx])
+					continue;
+
+				for(const t_rect& circle : circles)
+				{
+					if(line_in_rect(lines[lineidx], circle))
+					{
+						selected[lineidx] = grown = true;
+						break;
+					}
+				}
+			}
+
+			if(!grown)
+				break;
+		}
+	};
+
+	// the outer pass runs alongside the tiles
+	for_each_chunk(num_tiles + 1, num_threads, [&calc_tile, &calc_outer, num_tiles]
+		(std::size_t begin, std::size_t end)
+	{
+		for(std::size_t tileidx=begin; tileidx<end; ++tileidx)
+		{
+			if(tileidx < num_tiles)
+				calc_tile(tileidx);
+			else
+				calc_outer();
+		}
+	});
+
+
+	// stitch the tiles
+	t_results results{};
+	auto& vertices = results.GetVoronoiVertices();
+	auto& vertex_dists = results.GetVoronoiVertexDists();
+	auto& linear_edges_vec = results.GetLinearEdgesVec();
+	auto& parabolic_edges_vec = results.GetParabolicEdgesVec();
+	auto& parabolas_vec = results.GetParabolasVec();
+	t_graph& graph = results.GetVoronoiGraph();
+
+	// vertices in cells of size eps to merge the ones found in several tiles
+	const t_real cell_size = std::max(eps, std::numeric_limits<t_real>::epsilon());
+	std::map<std::pair<std::int64_t, std::int64_t>, std::vector<std::size_t>> vertex_cells;
+
+	auto get_vertex_idx = [&](const t_vec& vert, t_real dist) -> std::size_t
+	{
+		const std::int64_t cell_x = std::int64_t(std::floor(vert[0] / cell_size));
+		const std::int64_t cell_y = std::int64_t(std::floor(vert[1] / cell_size));
+
+		for(std::int64_t y = cell_y - 1; y <= cell_y + 1; ++y)
+		for(std::int64_t x = cell_x - 1; x <= cell_x + 1; ++x)
+		{
+			auto iter = vertex_cells.find(std::make_pair(x, y));
+			if(iter == vertex_cells.end())
+				continue;
+
+			for(std::size_t idx : iter->second)
+			{
+				if(std::abs(vertices[idx][0] - vert[0]) <= eps &&
+					std::abs(vertices[idx][1] - vert[1]) <= eps)
+					return idx;
+			}
+		}
+
+		vertices.push_back(vert);
+		vertex_dists.push_back(dist);
+		graph.AddVertex(std::to_string(vertices.size()));
+		vertex_cells[std::make_pair(cell_x, cell_y)].push_back(vertices.size() - 1);
+
+		return vertices.size() - 1;
+	};
+
+	using t_bisector = std::pair<std::size_t, std::size_t>;
+	std::unordered_set<t_bisector,
+		t_bisector_hash<t_bisector>,
+		t_bisector_equ<t_bisector>> seen_bisectors;
+
+	// add the edges assigned to a tile or the outer pass
+	auto stitch = [&](const t_results& part_results, const auto& is_owned)
+	{
+		const auto& part_vertices = part_results.GetVoronoiVertices();
+		const auto& part_dists = part_results.GetVoronoiVertexDists();
+		const t_graph& part_graph = part_results.GetVoronoiGraph();
+		const auto& part_linear_edges = part_results.GetLinearEdges();
+		const auto& part_parabolic_edges = part_results.GetParabolicEdges();
+		const auto& part_parabolas = part_results.GetParabolas();
+
+		for_each_edge_if(part_results, is_owned, [&](std::size_t vert0idx, std::size_t vert1idx)
+		{
+			std::size_t idx0 = get_vertex_idx(part_vertices[vert0idx], part_dists[vert0idx]);
+			std::size_t idx1 = get_vertex_idx(part_vertices[vert1idx], part_dists[vert1idx]);
+			if(idx0 == idx1)
+				return;
+
+			// edge already found in another tile?
+			auto bisector = std::make_pair(idx0, idx1);
+			if(seen_bisectors.find(bisector) != seen_bisectors.end())
+				return;
+			seen_bisectors.insert(bisector);
+
+			auto weight = part_graph.GetWeight(vert0idx, vert1idx);
+			t_real len = weight ? *weight : tl2::norm<t_vec>(vertices[idx1] - vertices[idx0]);
+			graph.AddEdge(idx0, idx1, len);
+			graph.AddEdge(idx1, idx0, len);
+
+			// edge geometry in the orientation of the part's edge
+			if(auto iter = part_parabolic_edges.find(std::make_pair(vert0idx, vert1idx));
+				iter != part_parabolic_edges.end())
+			{
+				bool swapped = (std::get<0>(iter->first) != vert0idx);
+				parabolic_edges_vec.emplace_back(std::make_tuple(
+					iter->second, swapped ? idx1 : idx0, swapped ? idx0 : idx1));
+
+				if(auto iter_para = part_parabolas.find(std::make_pair(vert0idx, vert1idx));
+					iter_para != part_parabolas.end())
+				{
+					parabolas_vec.emplace_back(std::make_tuple(
+						iter_para->second, idx0, idx1));
+				}
+			}
+			else if(auto iter = part_linear_edges.find(std::make_pair(
+				t_vert_index_opt{vert0idx}, t_vert_index_opt{vert1idx}));
+				iter != part_linear_edges.end())
+			{
+				bool swapped = (std::get<0>(iter->first) != vert0idx);
+				linear_edges_vec.emplace_back(std::make_tuple(
+					iter->second, t_vert_index_opt{swapped ? idx1 : idx0},
+					t_vert_index_opt{swapped ? idx0 : idx1}));
+			}
+		});
+	};
+
+	for(const t_tile& tile : tiles)
+	{
+		stitch(tile.results, [&is_tile_edge, &tile](const t_vec& vert0, const t_vec& vert1) -> bool
+		{
+			return is_tile_edge(tile, vert0, vert1);
+		});
+	}
+
+	stitch(outer_results, is_outer_edge);
+
+	results.CreateEdgeMaps();
+	results.CreateIndexTree();
+
+	return results;
+}
+
+
+/**
+ * voronoi diagram of the regions of set pixels in an image, approximated by the
+ * medial axis of the unset pixels which is found from the image's feature transform
+ *
+ * the graph vertices are the junctions and end points of the thinned medial axis,
+ * the pixel chains between them are stored as quadratic bisectors.
+ * no line segments are needed and the cost is linear in the number of pixels.
+ * if the regions' group_lines option is set, only the bisectors between different
+ * regions are kept, otherwise also the ones of a region with itself whose
+ * closest pixels are further apart than min_feature_dist.
+ */
+template<class t_vec,
+	class t_line = std::pair<t_vec, t_vec>,
+	class t_graph = AdjacencyMatrix<typename t_vec::value_type>,
+	class t_imageview>
+VoronoiLinesResults<t_vec, t_line, t_graph>
+calc_voro_raster(const t_imageview& img,
+	const RegionLabels* labels = nullptr,
+	const VoronoiLinesRegions<t_vec, t_line>* regions = nullptr,
+	typename t_vec::value_type min_feature_dist = 4,
+	unsigned int num_threads = 1)
+requires tl2::is_vec<t_vec> && is_graph<t_graph>
+{
+	using t_real = typename t_vec::value_type;
+	using t_results = VoronoiLinesResults<t_vec, t_line, t_graph>;
+	using t_vert_index = typename t_results::t_vert_index;
+
+	t_results results;
+	auto [width, height] = get_image_dims(img);
+	if(!width || !height)
+		return results;
+
+	// regions of set and unset pixels
+	RegionLabels own_labels;
+	if(!labels || labels->GetWidth() != width || labels->GetHeight() != height)
+	{
+		own_labels.Calculate(img, num_threads);
+		labels = &own_labels;
+	}
+
+	// closest set pixels
+	ClosestPixelField<t_vec, t_real> field;
+	field.Init(width, height);
+
+	for_each_chunk(width, num_threads, [&field, &img](std::size_t begin, std::size_t end)
+	{
+		field.CalcColumns(begin, end, [&img](std::size_t x, std::size_t y) -> bool
+		{
+			return bool(get_pixel(img, int(x), int(y)));
+		});
+	});
+
+	for_each_chunk(height, num_threads, [&field](std::size_t begin, std::size_t end)
+	{
+		for(std::size_t y=begin; y<end; ++y)
+			field.CalcRow(y);
+	});
+
+	// medial axis
+	const std::vector<t_line> no_lines{};
+	const t_real eps = std::numeric_limits<t_real>::epsilon();
+	auto is_excluded = [regions, &no_lines, eps](std::size_t x, std::size_t y) -> bool
+	{
+		if(!regions)
+			return false;
+
+		const t_vec vert = tl2::create<t_vec>({ t_real(x), t_real(y) });
+		if(regions->GetRegionFunc() && regions->IsVertexInRegion(no_lines, vert, eps))
+			return true;
+
+		return !regions->ValidateVertex(vert);
+	};
+
+	if(regions && regions->GetGroupLines())
+		min_feature_dist = std::numeric_limits<t_real>::max();
+
+	Image<std::uint8_t> axis = calc_medial_axis(field, *labels,
+		min_feature_dist, is_excluded, num_threads);
+	thin_skeleton(axis);
+
+
+	// ------------------------------------------------------------------------
+	// graph of the medial axis
+	// ------------------------------------------------------------------------
+	auto& vertices = results.GetVoronoiVertices();
+	auto& vertex_dists = results.GetVoronoiVertexDists();
+	t_graph& graph = results.GetVoronoiGraph();
+	auto& parabolic_edges_vec = results.GetParabolicEdgesVec();
+	auto& linear_edges_vec = results.GetLinearEdgesVec();
+
+	const std::array<std::array<int, 2>, 8> neighbours{{
+		{{ 1, 0 }}, {{ 1, -1 }}, {{ 0, -1 }}, {{ -1, -1 }},
+		{{ -1, 0 }}, {{ -1, 1 }}, {{ 0, 1 }}, {{ 1, 1 }} }};
+
+	// call func on the flat indices of the neighbouring axis pixels
+	auto for_each_neighbour = [&axis, &neighbours, width](std::size_t idx, auto&& func)
+	{
+		const int x = int(idx % width);
+		const int y = int(idx / width);
+
+		for(const auto& [dx, dy] : neighbours)
+		{
+			if(get_pixel(axis, x + dx, y + dy))
+				func(std::size_t(y + dy)*width + std::size_t(x + dx));
+		}
+	};
+
+	auto get_num_neighbours = [&for_each_neighbour](std::size_t idx) -> std::size_t
+	{
+		std::size_t num = 0;
+		for_each_neighbour(idx, [&num](std::size_t) { ++num; });
+		return num;
+	};
+
+	auto get_pos = [width](std::size_t idx) -> t_vec
+	{
+		return tl2::create<t_vec>({ t_real(idx % width), t_real(idx / width) });
+	};
+
+	auto add_vertex = [&vertices, &vertex_dists, &graph, &field, &get_pos, width]
+		(std::size_t idx) -> t_vert_index
+	{
+		vertices.emplace_back(get_pos(idx));
+		vertex_dists.push_back(field.GetDist(idx % width, idx / width));
+		graph.AddVertex(std::to_string(vertices.size()));
+		return vertices.size() - 1;
+	};
+
+	// already added edges
+	using t_bisector = std::pair<t_vert_index, t_vert_index>;
+	std::unordered_set<t_bisector,
+		t_bisector_hash<t_bisector>,
+		t_bisector_equ<t_bisector>> seen_bisectors;
+
+	// add an edge along the pixels of a chain, loops and
+	// repeated edges are split at inserted vertices
+	std::function<void(t_vert_index, t_vert_index,
+		const std::size_t*, const std::size_t*)> add_edge;
+	add_edge = [&](t_vert_index vert0idx, t_vert_index vert1idx,
+		const std::size_t* chain_begin, const std::size_t* chain_end)
+	{
+		const std::size_t chain_len = std::size_t(chain_end - chain_begin);
+
+		if(vert0idx == vert1idx)
+		{
+			if(chain_len < 3)
+				return;
+
+			const std::size_t* split1 = chain_begin + chain_len/3;
+			const std::size_t* split2 = chain_begin + 2*chain_len/3;
+			const t_vert_index split1idx = add_vertex(*split1);
+			const t_vert_index split2idx = add_vertex(*split2);
+
+			add_edge(vert0idx, split1idx, chain_begin, split1);
+			add_edge(split1idx, split2idx, split1 + 1, split2);
+			add_edge(split2idx, vert1idx, split2 + 1, chain_end);
+			return;
+		}
+
+		if(seen_bisectors.find(std::make_pair(vert0idx, vert1idx)) != seen_bisectors.end())
+		{
+			if(chain_len < 1)
+				return;
+
+			const std::size_t* split = chain_begin + chain_len/2;
+			const t_vert_index splitidx = add_vertex(*split);
+
+			add_edge(vert0idx, splitidx, chain_begin, split);
+			add_edge(splitidx, vert1idx, split + 1, chain_end);
+			return;
+		}
+
+		seen_bisectors.insert(std::make_pair(vert0idx, vert1idx));
+
+		std::vector<t_vec> points;
+		points.reserve(chain_len + 2);
+		points.push_back(vertices[vert0idx]);
+		for(const std::size_t* pix=chain_begin; pix!=chain_end; ++pix)
+			points.emplace_back(get_pos(*pix));
+		points.push_back(vertices[vert1idx]);
+
+		t_real len = 0;
+		for(std::size_t ptidx=1; ptidx<points.size(); ++ptidx)
+			len += tl2::norm(points[ptidx] - points[ptidx - 1]);
+
+		graph.AddEdge(vert0idx, vert1idx, len);
+		graph.AddEdge(vert1idx, vert0idx, len);
+
+		if(chain_len)
+		{
+			parabolic_edges_vec.emplace_back(
+				std::make_tuple(std::move(points), vert0idx, vert1idx));
+		}
+		else
+		{
+			linear_edges_vec.emplace_back(std::make_tuple(
+				std::make_pair(vertices[vert0idx], vertices[vert1idx]),
+				vert0idx, vert1idx));
+		}
+	};
+
+	std::vector<std::size_t> axis_pixels;
+	for(std::size_t y=0; y<height; ++y)
+		for(std::size_t x=0; x<width; ++x)
+			if(axis.GetPixel(x, y))
+				axis_pixels.push_back(y*width + x);
+
+	// the junction and end pixels are the nodes, adjacent nodes form a single vertex
+	// at the node pixel farthest from the walls
+	std::unordered_map<std::size_t, t_vert_index> node_vertices;
+	for(std::size_t idx : axis_pixels)
+	{
+		const std::size_t num_neighbours = get_num_neighbours(idx);
+		if(num_neighbours != 2 && num_neighbours != 0)
+			node_vertices.emplace(idx, 0);
+	}
+
+	for(std::size_t start_idx : axis_pixels)
+	{
+		auto iter = node_vertices.find(start_idx);
+		if(iter == node_vertices.end() || iter->second != 0)
+			continue;
+
+		std::vector<std::size_t> cluster{ start_idx };
+		iter->second = 1;
+		for(std::size_t clusteridx=0; clusteridx<cluster.size(); ++clusteridx)
+		{
+			for_each_neighbour(cluster[clusteridx], [&cluster, &node_vertices](std::size_t idx)
+			{
+				if(auto iter = node_vertices.find(idx); iter != node_vertices.end() && iter->second == 0)
+				{
+					iter->second = 1;
+					cluster.push_back(idx);
+				}
+			});
+		}
+
+		auto iter_max = std::max_element(cluster.begin(), cluster.end(),
+			[&field, width](std::size_t idx1, std::size_t idx2) -> bool
+		{
+			return field.GetDist(idx1 % width, idx1 / width) < field.GetDist(idx2 % width, idx2 / width);
+		});
+
+		// vertex indices are stored with an offset of 1, 0 means unassigned
+		const t_vert_index vertidx = add_vertex(*iter_max);
+		for(std::size_t idx : cluster)
+			node_vertices[idx] = vertidx + 1;
+	}
+
+	// trace the chains of pixels between the nodes
+	std::unordered_set<std::size_t> visited;
+	std::vector<std::size_t> chain;
+
+	auto trace_chain = [&](std::size_t start_idx, std::size_t first_idx) -> std::optional<std::size_t>
+	{
+		chain.clear();
+		std::size_t prev_idx = start_idx, cur_idx = first_idx;
+
+		while(true)
+		{
+			visited.insert(cur_idx);
+			chain.push_back(cur_idx);
+
+			std::optional<std::size_t> next_idx;
+			for_each_neighbour(cur_idx, [&next_idx, prev_idx](std::size_t idx)
+			{
+				if(idx != prev_idx && !next_idx)
+					next_idx = idx;
+			});
+
+			if(!next_idx)
+				return std::nullopt;
+
+			// arrived at a node or back at the start
+			if(*next_idx == start_idx || node_vertices.contains(*next_idx))
+				return *next_idx;
+
+			// ran into an already traced chain
+			if(visited.contains(*next_idx))
+				return std::nullopt;
+
+			prev_idx = cur_idx;
+			cur_idx = *next_idx;
+		}
+	};
+
+	for(std::size_t start_idx : axis_pixels)
+	{
+		auto iter_start = node_vertices.find(start_idx);
+		if(iter_start == node_vertices.end())
+			continue;
+
+		for_each_neighbour(start_idx, [&](std::size_t first_idx)
+		{
+			if(node_vertices.contains(first_idx) || visited.contains(first_idx))
+				return;
+
+			if(auto end_idx = trace_chain(start_idx, first_idx); end_idx)
+			{
+				const t_vert_index vert0idx = iter_start->second - 1;
+				const t_vert_index vert1idx = node_vertices[*end_idx] - 1;
+
+				// also pass through the node pixels if they aren't the vertices
+				if(!tl2::equals<t_vec>(get_pos(start_idx), vertices[vert0idx]))
+					chain.insert(chain.begin(), start_idx);
+				if(!tl2::equals<t_vec>(get_pos(*end_idx), vertices[vert1idx]))
+					chain.push_back(*end_idx);
+
+				add_edge(vert0idx, vert1idx, chain.data(), chain.data() + chain.size());
+			}
+		});
+	}
+
+	// remaining closed loops without nodes
+	for(std::size_t start_idx : axis_pixels)
+	{
+		if(node_vertices.contains(start_idx) || visited.contains(start_idx))
+			continue;
+
+		visited.insert(start_idx);
+
+		std::optional<std::size_t> first_idx;
+		for_each_neighbour(start_idx, [&first_idx](std::size_t idx)
+		{
+			if(!first_idx)
+				first_idx = idx;
+		});
+
+		if(!first_idx)
+			continue;
+
+		if(auto end_idx = trace_chain(start_idx, *first_idx); end_idx)
+		{
+			const t_vert_index vertidx = add_vertex(start_idx);
+			add_edge(vertidx, vertidx, chain.data(), chain.data() + chain.size());
+		}
+	}
+
+	results.CreateEdgeMaps();
+	results.CreateIndexTree();
+
+	return results;
+}
+
+
 #ifdef USE_OVD
 /**
  * voronoi diagram for line segments (using ovd)
@@ -26,7 +26,6 @@
  */
 
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <random>
 
@@ -37,20 +36,18 @@ using t_real = double;
 using t_vec = tl2::vec<t_real, std::vector>;
 
 
-void test_kd(const std::vector<t_vec>& points, const t_vec& query,
-	const char* outfile)
+void test_kd(const std::vector<t_vec>& points, const t_vec& query)
 {
+	using namespace tl2_ops;
+
 	geo::KdTree<t_vec> kd(2);
 	kd.create(points);
 	std::cout << kd << std::endl;
 
-	std::ofstream ofstr{outfile};
-	geo::write_graph(ofstr, kd.get_root());
-
-	if(const auto* node = kd.get_closest(query); node)
+	for(std::size_t idx : kd.get_closest(query, 3))
 	{
-		using namespace tl2_ops;
-		std::cout << "closest: " << *node->vec << std::endl;
+		std::cout << "closest: " << kd.get_vec(idx)
+			<< " (index " << idx << ")" << std::endl;
 	}
 
 
@@ -74,7 +71,7 @@ int main()
 			tl2::create<t_vec>({ 7., 10. }),
 		}};
 
-		test_kd(points, query, "kdtree.dot");
+		test_kd(points, query);
 	}
 
 	std::cout << "\n\n--------------------------------------------------------------------------------" << std::endl;
@@ -96,7 +93,7 @@ int main()
 			points.emplace_back(std::move(vec));
 		}
 
-		test_kd(points, query, "kdtree_rnd.dot");
+		test_kd(points, query);
 	}
 
 	return 0;
@@ -0,0 +1,262 @@
+/**
+ * testing the simd collision kernels against a scalar reference
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * References:
+ *  * https://www.boost.org/doc/libs/1_76_0/libs/test/doc/html/index.html
+ *
+ * the test is built once for every lane type:
+ * g++ -I.. -Wall -Wextra -std=c++20 -mavx2 -DUSE_AVX2 -o collision_lanes_avx2 collision_lanes.cpp
+ * g++ -I.. -Wall -Wextra -std=c++20 -o collision_lanes_sse2 collision_lanes.cpp
+ * g++ -I.. -Wall -Wextra -std=c++20 -DTASPATHS_NO_SIMD -o collision_lanes_scalar collision_lanes.cpp
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#define BOOST_TEST_MODULE test_collision_lanes
+
+#include <boost/test/included/unit_test.hpp>
+namespace test = boost::unit_test;
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <iostream>
+
+#include "src/core/CollisionLanes.h"
+
+
+constexpr std::size_t N = COLLISION_BOX_VERTS;
+
+
+// ----------------------------------------------------------------------------
+// scalar reference, using the same operations as the kernels
+// ----------------------------------------------------------------------------
+static t_real ref_min(t_real a, t_real b) { return a < b ? a : b; }
+static t_real ref_max(t_real a, t_real b) { return a > b ? a : b; }
+
+
+static bool ref_circle_box(t_real x, t_real y, t_real rad,
+	const t_real* box_x, const t_real* box_y)
+{
+	t_real area = 0;
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+		area = area + (box_x[idx1]*box_y[idx2] - box_x[idx2]*box_y[idx1]);
+	}
+
+	bool inside = (area != 0);
+	t_real min_dist_sq = std::numeric_limits<t_real>::max();
+
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+
+		const t_real edge_x = box_x[idx2] - box_x[idx1];
+		const t_real edge_y = box_y[idx2] - box_y[idx1];
+		const t_real pt_x = x - box_x[idx1];
+		const t_real pt_y = y - box_y[idx1];
+
+		inside = inside && !((edge_x*pt_y - edge_y*pt_x) * area < 0);
+
+		const t_real len_sq = edge_x*edge_x + edge_y*edge_y;
+		t_real param = len_sq > 0 ? (pt_x*edge_x + pt_y*edge_y) / len_sq : 0;
+		param = ref_min(ref_max(param, 0), 1);
+
+		const t_real dx = pt_x - param*edge_x;
+		const t_real dy = pt_y - param*edge_y;
+		min_dist_sq = ref_min(min_dist_sq, dx*dx + dy*dy);
+	}
+
+	return inside || (min_dist_sq < rad*rad);
+}
+
+
+static bool ref_separated_box_box(
+	const t_real* box1_x, const t_real* box1_y,
+	const t_real* box2_x, const t_real* box2_y,
+	t_real margin)
+{
+	for(std::size_t idx1=0; idx1<N; ++idx1)
+	{
+		std::size_t idx2 = (idx1 + 1) % N;
+
+		const t_real norm_x = box1_y[idx1] - box1_y[idx2];
+		const t_real norm_y = box1_x[idx2] - box1_x[idx1];
+		if(norm_x == 0 && norm_y == 0)
+			continue;
+
+		t_real min1 = norm_x*box1_x[0] + norm_y*box1_y[0];
+		t_real min2 = norm_x*box2_x[0] + norm_y*box2_y[0];
+		t_real max1 = min1, max2 = min2;
+
+		for(std::size_t vert=1; vert<N; ++vert)
+		{
+			const t_real proj1 = norm_x*box1_x[vert] + norm_y*box1_y[vert];
+			const t_real proj2 = norm_x*box2_x[vert] + norm_y*box2_y[vert];
+
+			min1 = ref_min(min1, proj1);
+			max1 = ref_max(max1, proj1);
+			min2 = ref_min(min2, proj2);
+			max2 = ref_max(max2, proj2);
+		}
+
+		if(margin > 0)
+		{
+			const t_real margin_sq = (margin*margin) * (norm_x*norm_x + norm_y*norm_y);
+			const t_real gap1 = min2 - max1;
+			const t_real gap2 = min1 - max2;
+
+			if((gap1 > 0 && gap1*gap1 > margin_sq) || (gap2 > 0 && gap2*gap2 > margin_sq))
+				return true;
+		}
+		else if(max1 < min2 || max2 < min1)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+static bool ref_box_box(
+	const t_real* box1_x, const t_real* box1_y,
+	const t_real* box2_x, const t_real* box2_y,
+	t_real margin)
+{
+	return !(ref_separated_box_box(box1_x, box1_y, box2_x, box2_y, margin) ||
+		ref_separated_box_box(box2_x, box2_y, box1_x, box1_y, margin));
+}
+// ----------------------------------------------------------------------------
+
+
+BOOST_AUTO_TEST_CASE(collision_lanes)
+{
+	using t_lanes = CollisionLanes;
+	constexpr std::size_t L = t_lanes::NUM;
+	std::cout << "Testing " << t_lanes::NAME << " collision lanes." << std::endl;
+
+	constexpr std::size_t num_prims = 100000;
+	std::mt19937 rng{1234};
+	std::uniform_real_distribution<t_real> dist{-2., 2.};
+
+	// random, partly degenerate, rotated boxes
+	auto create_box = [&rng, &dist](std::size_t idx, t_real* box_x, t_real* box_y)
+	{
+		const t_real x = dist(rng), y = dist(rng), angle = dist(rng);
+		t_real w = std::abs(dist(rng)), h = std::abs(dist(rng));
+		if(idx % 7 == 0)
+			w = 0;
+
+		const t_real c = std::cos(angle), s = std::sin(angle);
+		const t_real corners_x[N] = { w, -w, -w, w };
+		const t_real corners_y[N] = { -h, -h, h, h };
+
+		for(std::size_t vert=0; vert<N; ++vert)
+		{
+			box_x[vert] = c*corners_x[vert] - s*corners_y[vert] + x;
+			box_y[vert] = s*corners_x[vert] + c*corners_y[vert] + y;
+		}
+	};
+
+	// the same primitives for all lane types
+	std::vector<t_real> boxes1_x(num_prims*N), boxes1_y(num_prims*N);
+	std::vector<t_real> boxes2_x(num_prims*N), boxes2_y(num_prims*N);
+	std::vector<t_real> circles_x(num_prims), circles_y(num_prims), circles_rad(num_prims);
+
+	for(std::size_t prim=0; prim<num_prims; ++prim)
+	{
+		create_box(prim, boxes1_x.data() + prim*N, boxes1_y.data() + prim*N);
+		create_box(prim + 1, boxes2_x.data() + prim*N, boxes2_y.data() + prim*N);
+
+		circles_x[prim] = dist(rng);
+		circles_y[prim] = dist(rng);
+		circles_rad[prim] = std::abs(dist(rng)) * 0.5;
+	}
+
+	std::size_t num_box_hits = 0, num_circle_hits = 0;
+	std::size_t num_box_mismatches = 0, num_circle_mismatches = 0;
+
+	for(std::size_t prim=0; prim<num_prims; prim+=L)
+	{
+		// primitives in lane-interleaved layout
+		t_real box1_x[N][L], box1_y[N][L], box2_x[N][L], box2_y[N][L];
+
+		for(std::size_t lane=0; lane<L; ++lane)
+		{
+			for(std::size_t vert=0; vert<N; ++vert)
+			{
+				box1_x[vert][lane] = boxes1_x[(prim + lane)*N + vert];
+				box1_y[vert][lane] = boxes1_y[(prim + lane)*N + vert];
+				box2_x[vert][lane] = boxes2_x[(prim + lane)*N + vert];
+				box2_y[vert][lane] = boxes2_y[(prim + lane)*N + vert];
+			}
+		}
+
+		const t_real *circ_x = circles_x.data() + prim;
+		const t_real *circ_y = circles_y.data() + prim;
+		const t_real *circ_rad = circles_rad.data() + prim;
+
+		t_lanes b1x[N], b1y[N], b2x[N], b2y[N];
+		for(std::size_t vert=0; vert<N; ++vert)
+		{
+			b1x[vert] = t_lanes::load(box1_x[vert]); b1y[vert] = t_lanes::load(box1_y[vert]);
+			b2x[vert] = t_lanes::load(box2_x[vert]); b2y[vert] = t_lanes::load(box2_y[vert]);
+		}
+
+		// blocks of eight primitives with and without margin
+		const t_real margin = (prim / 8) % 2 ? 0.25 : 0.;
+		auto box_hit = collide_box_box(b1x, b1y, b2x, b2y, margin);
+		auto circle_hit = collide_circle_box(t_lanes::load(circ_x),
+			t_lanes::load(circ_y), t_lanes::load(circ_rad), b1x, b1y);
+
+		for(std::size_t lane=0; lane<L; ++lane)
+		{
+			t_real b1x_ref[N], b1y_ref[N], b2x_ref[N], b2y_ref[N];
+			for(std::size_t vert=0; vert<N; ++vert)
+			{
+				b1x_ref[vert] = box1_x[vert][lane]; b1y_ref[vert] = box1_y[vert][lane];
+				b2x_ref[vert] = box2_x[vert][lane]; b2y_ref[vert] = box2_y[vert][lane];
+			}
+
+			bool box_ref = ref_box_box(b1x_ref, b1y_ref, b2x_ref, b2y_ref, margin);
+			bool circle_ref = ref_circle_box(circ_x[lane], circ_y[lane], circ_rad[lane],
+				b1x_ref, b1y_ref);
+
+			num_box_hits += box_ref;
+			num_circle_hits += circle_ref;
+			num_box_mismatches += (t_lanes::get(box_hit, lane) != box_ref);
+			num_circle_mismatches += (t_lanes::get(circle_hit, lane) != circle_ref);
+		}
+	}
+
+	std::cout << "Box collisions: " << num_box_hits
+		<< ", circle collisions: " << num_circle_hits << "." << std::endl;
+
+	// both outcomes have to be tested
+	BOOST_TEST((num_box_hits > 0 && num_box_hits < num_prims));
+	BOOST_TEST((num_circle_hits > 0 && num_circle_hits < num_prims));
+
+	BOOST_TEST((num_box_mismatches == 0));
+	BOOST_TEST((num_circle_mismatches == 0));
+}
@@ -42,9 +42,10 @@ namespace ty = boost::typeindex;
 
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
-	decltype(std::tuple<                      // test dijkstra's algorithm using both an
-		geo::AdjacencyMatrix<unsigned int>,   // adjacency matrix, and
-		geo::AdjacencyList<unsigned int>>{})) // an adjacency list
+	decltype(std::tuple<                      // test dijkstra's algorithm using an
+		geo::AdjacencyMatrix<unsigned int>,   // adjacency matrix,
+		geo::AdjacencyList<unsigned int>,     // an adjacency list, and
+		geo::CsrGraph<unsigned int>>{}))      // a compressed sparse row graph
 {
 	// create a graph
 	t_graph graph;
@@ -68,12 +69,22 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
 	graph.AddEdge("v4", "v2", 1);
 	graph.AddEdge("v4", "v5", 2);
 
+	// merge the pending edges of the compressed sparse row graph
+	if constexpr(requires { graph.Compact(); })
+	{
+		BOOST_TEST(!graph.IsCompact());
+		graph.Compact();
+		BOOST_TEST(graph.IsCompact());
+	}
+
 	//print_graph<t_graph>(graph, std::cout);
 
-	// run two versions of dijkstra's algorithm
+	// run three versions of dijkstra's algorithm
 	auto predecessors = dijk<t_graph>(graph, "v1");
 	auto predecessors_mod = dijk_mod<t_graph>(graph, "v1");
+	auto predecessors_heap = dijk_heap<t_graph>(graph, "v1");
 	BOOST_TEST((predecessors.size() == predecessors_mod.size()));
+	BOOST_TEST((predecessors_heap == predecessors));
 
 	// verify that both version give the same predecessors
 	for(std::size_t i=0; i<graph.GetNumVertices(); ++i)
@@ -107,4 +118,29 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
 		if(predecessors[i] && expected_predecessors[i])
 			BOOST_TEST((*predecessors[i] == *expected_predecessors[i]));
 	}
+
+	// early termination and re-use of the workspace
+	geo::DijkWorkspace<unsigned int> workspace;
+	BOOST_TEST(dijk_heap<t_graph>(graph, 0, 2, workspace));
+	BOOST_TEST((workspace.GetPath(2) == std::vector<std::size_t>{{ 0, 1, 2 }}));
+	BOOST_TEST((*workspace.GetDistance(2) == 4));
+	BOOST_TEST((!workspace.IsSettled(4)));
+
+	BOOST_TEST(dijk_heap<t_graph>(graph, 3, 2, workspace));
+	BOOST_TEST((workspace.GetPath(2) == std::vector<std::size_t>{{ 3, 1, 2 }}));
+	BOOST_TEST((*workspace.GetDistance(2) == 4));
+	BOOST_TEST((!workspace.GetDistance(0)));
+
+	// a* search, using the exact remaining distances as heuristic
+	auto heuristic = [](std::size_t idx) -> unsigned int
+	{
+		const unsigned int dists_to_target[] = { 4, 3, 0, 4, 100 };
+		return dists_to_target[idx];
+	};
+
+	using t_weight_func = std::optional<unsigned int>(std::size_t, std::size_t);
+	BOOST_TEST((dijk_heap<t_graph, t_weight_func, decltype(heuristic)>(
+		graph, 0, 2, workspace, nullptr, &heuristic)));
+	BOOST_TEST((workspace.GetPath(2) == std::vector<std::size_t>{{ 0, 1, 2 }}));
+	BOOST_TEST((workspace.GetNumSettled() == 3));
 }
@@ -0,0 +1,612 @@
+/**
+ * testing image containers and algorithms
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * References:
+ *  * https://www.boost.org/doc/libs/1_76_0/libs/test/doc/html/index.html
+ *
+ * g++ -I.. -Wall -Wextra -Weffc++ -std=c++20 -o img img.cpp
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#define BOOST_TEST_MODULE test_img
+
+#include <boost/test/included/unit_test.hpp>
+namespace test = boost::unit_test;
+
+#include <cstdint>
+#include <random>
+#include <iostream>
+
+#include "src/libs/img.h"
+#include "src/libs/hull.h"
+
+
+BOOST_AUTO_TEST_CASE(packed_img)
+{
+	using t_pixel = std::uint8_t;
+	const t_pixel vals[] = { 0x00, 0xf0, 0xff };
+
+	// odd width to test the padding of the rows
+	const std::size_t width = 301, height = 37;
+
+	geo::Image<t_pixel> img(width, height);
+	geo::PackedImage<t_pixel, 2> packed(width, height);
+	static_assert(geo::is_image<decltype(packed)>);
+
+	// fill both images with random spans of pixels
+	std::mt19937 rng{1234};
+	std::uniform_int_distribution<std::size_t> dist_val{0, 2};
+	std::uniform_int_distribution<std::size_t> dist_len{1, 80};
+
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width;)
+		{
+			t_pixel val = vals[dist_val(rng)];
+			std::size_t end = std::min(x + dist_len(rng), width);
+
+			for(; x<end; ++x)
+			{
+				img.SetPixel(x, y, val);
+				packed.SetPixel(x, y, val);
+			}
+		}
+	}
+
+	// copies
+	geo::Image<t_pixel> img_copy = img;
+	geo::PackedImage<t_pixel, 2> packed_copy = packed;
+
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width; ++x)
+		{
+			BOOST_TEST((packed.GetPixel(x, y) == img.GetPixel(x, y)));
+			BOOST_TEST((img_copy.GetPixel(x, y) == img.GetPixel(x, y)));
+			BOOST_TEST((packed_copy.GetPixel(x, y) == img.GetPixel(x, y)));
+		}
+	}
+
+	// compare the runs of the packed image with and without rle
+	for(int rle=0; rle<2; ++rle)
+	{
+		if(rle)
+			packed.CreateRuns();
+		BOOST_TEST((packed.HasRuns() == bool(rle)));
+
+		for(std::size_t y=0; y<height; ++y)
+		{
+			std::size_t last_end = 0;
+			t_pixel last_val = 0;
+
+			geo::for_each_run(packed, y, [&](std::size_t begin, std::size_t end, t_pixel val) -> bool
+			{
+				// the runs are contiguous and maximal
+				BOOST_TEST(begin == last_end);
+				BOOST_TEST(begin < end);
+				if(begin > 0)
+					BOOST_TEST((val != last_val));
+
+				for(std::size_t x=begin; x<end; ++x)
+					BOOST_TEST((img.GetPixel(x, y) == val));
+
+				auto run = packed.GetRun((begin + end) / 2, y);
+				BOOST_TEST(run.begin == begin);
+				BOOST_TEST(run.end == end);
+				BOOST_TEST((run.value == val));
+
+				last_end = end;
+				last_val = val;
+				return true;
+			});
+
+			BOOST_TEST(last_end == width);
+		}
+	}
+
+	// setting a pixel invalidates the runs
+	packed.SetPixel(0, 0, 0xff);
+	BOOST_TEST(!packed.HasRuns());
+
+	// only four values fit into the palette
+	packed.SetPixel(0, 0, 0x0f);
+	BOOST_CHECK_THROW(packed.SetPixel(1, 0, 0x01), std::out_of_range);
+	BOOST_TEST((packed.GetPixel(0, 0) == 0x0f));
+
+	std::cout << "Memory: " << width*height*sizeof(t_pixel) << " bytes (unpacked), "
+		<< packed.GetMemorySize() << " bytes (packed)." << std::endl;
+}
+
+
+BOOST_AUTO_TEST_CASE(closest_pixel_field)
+{
+	using t_scalar = double;
+	using t_vec = tl2::vec<t_scalar, std::vector>;
+
+	const std::size_t width = 97, height = 61;
+	geo::Image<std::uint8_t> img(width, height);
+
+	std::mt19937 rng{5678};
+	std::uniform_int_distribution<std::size_t> dist_x{0, width - 1};
+	std::uniform_int_distribution<std::size_t> dist_y{0, height - 1};
+
+	// some random obstacle pixels
+	std::vector<t_vec> features;
+	for(std::size_t i=0; i<40; ++i)
+	{
+		std::size_t x = dist_x(rng), y = dist_y(rng);
+		img.SetPixel(x, y, 0xff);
+	}
+
+	// features are the pixels to the right of the set ones
+	for(std::size_t y=0; y<height; ++y)
+		for(std::size_t x=1; x<width; ++x)
+			if(img.GetPixel(x - 1, y))
+				features.emplace_back(tl2::create<t_vec>({ t_scalar(x), t_scalar(y) }));
+
+	// isotropic and anisotropic metrics
+	const t_scalar scales[][2] = { { 1., 1. }, { 3., 1. }, { 0.25, 2. } };
+	for(const auto [scale_x, scale_y] : scales)
+	{
+		auto field = geo::build_closest_pixel_field<t_vec>(img, scale_x, scale_y);
+		BOOST_TEST(field.IsValid());
+
+		// compare with the brute-force distances
+		for(std::size_t y=0; y<height; ++y)
+		{
+			for(std::size_t x=0; x<width; ++x)
+			{
+				t_scalar min_dist = std::numeric_limits<t_scalar>::max();
+				for(const t_vec& feature : features)
+				{
+					t_scalar dx = scale_x * (feature[0] - t_scalar(x));
+					t_scalar dy = scale_y * (feature[1] - t_scalar(y));
+					min_dist = std::min(min_dist, std::sqrt(dx*dx + dy*dy));
+				}
+
+				BOOST_TEST(field.GetDist(x, y) == min_dist, boost::test_tools::tolerance(1e-9));
+			}
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(closest_pixel_candidates)
+{
+	using t_scalar = double;
+	using t_vec = tl2::vec<t_scalar, std::vector>;
+
+	const std::size_t width = 83, height = 71;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	// some random obstacle rectangles
+	std::mt19937 rng{91011};
+	std::uniform_int_distribution<std::size_t> dist_x{0, width - 1};
+	std::uniform_int_distribution<std::size_t> dist_y{0, height - 1};
+	std::uniform_int_distribution<std::size_t> dist_len{1, 20};
+
+	for(std::size_t i=0; i<12; ++i)
+	{
+		std::size_t x0 = dist_x(rng), y0 = dist_y(rng);
+		std::size_t x1 = std::min(x0 + dist_len(rng), width);
+		std::size_t y1 = std::min(y0 + dist_len(rng), height);
+
+		for(std::size_t y=y0; y<y1; ++y)
+			for(std::size_t x=x0; x<x1; ++x)
+				img.SetPixel(x, y, i % 2 ? 0xff : 0xf0);
+	}
+	img.CreateRuns();
+
+	auto field = geo::build_closest_pixel_field<t_vec>(img);
+	auto candidates = geo::get_closest_pixel_candidates<t_vec>(img);
+
+	// the closest candidates are as close as the closest pixels for all free positions
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width; ++x)
+		{
+			if(x > 0 && img.GetPixel(x - 1, y))
+				continue;
+
+			t_scalar min_dist = std::numeric_limits<t_scalar>::max();
+			for(const t_vec& candidate : candidates)
+			{
+				t_scalar dx = candidate[0] - t_scalar(x);
+				t_scalar dy = candidate[1] - t_scalar(y);
+				min_dist = std::min(min_dist, std::sqrt(dx*dx + dy*dy));
+			}
+
+			BOOST_TEST(field.GetDist(x, y) == min_dist, boost::test_tools::tolerance(1e-9));
+		}
+	}
+
+	std::cout << "Closest pixel candidates: " << candidates.size() << std::endl;
+}
+
+
+BOOST_AUTO_TEST_CASE(contours)
+{
+	using t_vec = tl2::vec<int, std::vector>;
+
+	const std::size_t width = 157, height = 389;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	// some random obstacle rectangles and pixels
+	std::mt19937 rng{121314};
+	std::uniform_int_distribution<std::size_t> dist_x{0, width - 1};
+	std::uniform_int_distribution<std::size_t> dist_y{0, height - 1};
+	std::uniform_int_distribution<std::size_t> dist_len{1, 60};
+
+	for(std::size_t i=0; i<40; ++i)
+	{
+		std::size_t x0 = dist_x(rng), y0 = dist_y(rng);
+		std::size_t x1 = std::min(x0 + dist_len(rng), width);
+		std::size_t y1 = std::min(y0 + dist_len(rng), height);
+
+		for(std::size_t y=y0; y<y1; ++y)
+			for(std::size_t x=x0; x<x1; ++x)
+				img.SetPixel(x, y, 0xff);
+	}
+
+	for(std::size_t i=0; i<200; ++i)
+		img.SetPixel(dist_x(rng), dist_y(rng), 0xf0);
+
+	// the parallel tracing finds the same contours
+	auto contours = geo::trace_contour<t_vec>(img);
+	auto contours_par = geo::trace_contour_parallel<t_vec>(img, 4);
+
+	std::sort(contours.begin(), contours.end());
+	std::sort(contours_par.begin(), contours_par.end());
+
+	BOOST_TEST(contours.size() > 0);
+	BOOST_TEST((contours == contours_par));
+
+	std::cout << "Contours: " << contours.size() << std::endl;
+}
+
+
+BOOST_AUTO_TEST_CASE(isolines)
+{
+	using t_scalar = double;
+	using t_vec = tl2::vec<t_scalar, std::vector>;
+
+	// disk with a hole
+	const t_scalar centre_x = 30.3, centre_y = 29.6;
+	const t_scalar rad_outer = 20.2, rad_inner = 7.7;
+
+	auto is_set = [&](const t_vec& pos) -> bool
+	{
+		t_scalar dx = pos[0] - centre_x, dy = pos[1] - centre_y;
+		t_scalar rad = std::sqrt(dx*dx + dy*dy);
+		return rad < rad_outer && rad > rad_inner;
+	};
+
+	const std::size_t width = 61, height = 59;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	for(std::size_t y=0; y<height; ++y)
+		for(std::size_t x=0; x<width; ++x)
+			if(is_set(tl2::create<t_vec>({ t_scalar(x), t_scalar(y) })))
+				img.SetPixel(x, y, 0xff);
+	img.CreateRuns();
+
+	// maximum deviation of the crossing points from the exact contours
+	for(unsigned int num_bisections : { 0u, 10u })
+	{
+		auto contours = geo::trace_isolines<t_vec>(img, is_set, num_bisections);
+		BOOST_TEST(contours.size() == 2);
+
+		t_scalar max_err = 0;
+		for(const auto& contour : contours)
+		{
+			for(const t_vec& pos : contour)
+			{
+				t_scalar dx = pos[0] - centre_x, dy = pos[1] - centre_y;
+				t_scalar rad = std::sqrt(dx*dx + dy*dy);
+				max_err = std::max(max_err, std::min(
+					std::abs(rad - rad_outer), std::abs(rad - rad_inner)));
+			}
+		}
+
+		BOOST_TEST(max_err < (num_bisections ? 1e-3 : 0.5));
+	}
+
+	// the contours have the same orientations as the pixel contours
+	auto pixel_contours = geo::trace_contour<tl2::vec<int, std::vector>>(img);
+	auto contours = geo::trace_isolines<t_vec>(img);
+	BOOST_TEST(pixel_contours.size() == contours.size());
+
+	auto get_area = [](const auto& contour) -> t_scalar
+	{
+		t_scalar area = 0;
+		for(std::size_t idx1=0; idx1<contour.size(); ++idx1)
+		{
+			std::size_t idx2 = (idx1 + 1) % contour.size();
+			area += t_scalar(contour[idx1][0]) * t_scalar(contour[idx2][1])
+				- t_scalar(contour[idx2][0]) * t_scalar(contour[idx1][1]);
+		}
+		return area;
+	};
+
+	for(std::size_t idx=0; idx<std::min(contours.size(), pixel_contours.size()); ++idx)
+		BOOST_TEST(((get_area(contours[idx]) > 0) == (get_area(pixel_contours[idx]) > 0)));
+}
+
+
+BOOST_AUTO_TEST_CASE(contour_decimation)
+{
+	using t_scalar = double;
+	using t_vec = tl2::vec<t_scalar, std::vector>;
+
+	// ring-shaped obstacle with wavy borders
+	const std::size_t width = 120, height = 100;
+	const t_scalar centre_x = 61.2, centre_y = 48.7;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width; ++x)
+		{
+			t_scalar dx = t_scalar(x) - centre_x, dy = t_scalar(y) - centre_y;
+			t_scalar angle = std::atan2(dy, dx);
+			t_scalar rad = std::sqrt(dx*dx + dy*dy);
+
+			if(rad < 30. + 8.*std::sin(3.*angle) + 4.*std::cos(7.*angle) &&
+				rad > 10. + 3.*std::sin(5.*angle))
+				img.SetPixel(x, y, 0xff);
+		}
+	}
+
+	// distance of a point to a line segment
+	auto get_dist = [](const t_vec& vert1, const t_vec& vert2, const t_vec& pt) -> t_scalar
+	{
+		t_vec dir = vert2 - vert1;
+		t_scalar len2 = tl2::inner<t_vec>(dir, dir);
+		t_scalar param = len2 > 0. ? std::clamp(tl2::inner<t_vec>(pt - vert1, dir) / len2, 0., 1.) : 0.;
+		return tl2::norm<t_vec>(vert1 + param*dir - pt);
+	};
+
+	// winding number of a point with respect to a polygon
+	auto get_winding = [](const std::vector<t_vec>& poly, const t_vec& pt) -> int
+	{
+		int winding = 0;
+		for(std::size_t idx1=0; idx1<poly.size(); ++idx1)
+		{
+			const t_vec& vert1 = poly[idx1];
+			const t_vec& vert2 = poly[(idx1 + 1) % poly.size()];
+			t_scalar side = geo::side_of_line<t_vec>(vert1, vert2, pt);
+
+			if(vert1[1] <= pt[1] && vert2[1] > pt[1] && side > 0.)
+				++winding;
+			else if(vert1[1] > pt[1] && vert2[1] <= pt[1] && side < 0.)
+				--winding;
+		}
+		return winding;
+	};
+
+	const t_scalar max_dist = 0.8;
+	std::size_t num_verts = 0, num_verts_decimated = 0;
+
+	for(const auto& contour : geo::trace_isolines<t_vec>(img))
+	{
+		std::vector<t_vec> decimated = contour;
+		std::size_t num_removed = geo::decimate_contour<t_vec, t_scalar>(decimated, max_dist);
+
+		BOOST_TEST(decimated.size() + num_removed == contour.size());
+		BOOST_TEST(decimated.size() >= 3);
+		num_verts += contour.size();
+		num_verts_decimated += decimated.size();
+
+		// the obstacle is on the left side of the contours, i.e. inside the
+		// positively oriented ones and outside the others; it may only grow
+		t_scalar area = 0;
+		for(std::size_t idx1=0; idx1<contour.size(); ++idx1)
+		{
+			std::size_t idx2 = (idx1 + 1) % contour.size();
+			area += contour[idx1][0]*contour[idx2][1] - contour[idx2][0]*contour[idx1][1];
+		}
+		const bool obstacle_inside = area > 0.;
+
+		for(const t_vec& pt : contour)
+		{
+			t_scalar min_dist = std::numeric_limits<t_scalar>::max();
+			for(std::size_t idx=0; idx<decimated.size(); ++idx)
+				min_dist = std::min(min_dist, get_dist(decimated[idx], decimated[(idx + 1) % decimated.size()], pt));
+
+			BOOST_TEST(min_dist <= max_dist + 1e-6);
+			if(min_dist < 1e-6)
+				continue;
+
+			int winding = get_winding(decimated, pt);
+			BOOST_TEST((obstacle_inside ? winding != 0 : winding == 0));
+		}
+	}
+
+	BOOST_TEST(num_verts_decimated < num_verts);
+	std::cout << "Contour vertices: " << num_verts << " (original), "
+		<< num_verts_decimated << " (decimated)." << std::endl;
+}
+
+
+
+BOOST_AUTO_TEST_CASE(contour_decimation_neighbours)
+{
+	using t_scalar = double;
+	using t_vec = tl2::vec<t_scalar, std::vector>;
+
+	// two interlocking combs, separated by narrow gaps
+	const std::size_t width = 80, height = 120;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	for(std::size_t y=0; y<height; ++y)
+	{
+		const std::size_t tooth = y % 10;
+		for(std::size_t x=0; x<width; ++x)
+		{
+			bool left = x < 34 || (x < 39 && tooth < 4);
+			bool right = x > 41 || (x > 35 && tooth >= 5 && tooth < 9);
+
+			if(left || right)
+				img.SetPixel(x, y, 0xff);
+		}
+	}
+
+	const std::vector<std::vector<t_vec>> contours = geo::trace_isolines<t_vec>(img);
+	BOOST_TEST(contours.size() >= 2);
+
+	// number of intersections between line segments of different contours
+	auto get_num_intersections = [](const std::vector<std::vector<t_vec>>& polys) -> std::size_t
+	{
+		std::size_t num_inters = 0;
+		for(std::size_t poly1=0; poly1<polys.size(); ++poly1)
+		for(std::size_t poly2=poly1+1; poly2<polys.size(); ++poly2)
+		for(std::size_t idx1=0; idx1<polys[poly1].size(); ++idx1)
+		for(std::size_t idx2=0; idx2<polys[poly2].size(); ++idx2)
+		{
+			const t_vec& vert1a = polys[poly1][idx1];
+			const t_vec& vert1b = polys[poly1][(idx1 + 1) % polys[poly1].size()];
+			const t_vec& vert2a = polys[poly2][idx2];
+			const t_vec& vert2b = polys[poly2][(idx2 + 1) % polys[poly2].size()];
+
+			if(geo::intersect_lines_check<t_vec>(vert1a, vert1b, vert2a, vert2b))
+				++num_inters;
+		}
+		return num_inters;
+	};
+
+	BOOST_TEST(get_num_intersections(contours) == 0);
+
+	// the deviation is larger than the gaps
+	const t_scalar max_dist = 6.;
+	const geo::ContourSegmentGrid<t_vec, t_scalar> segment_grid(contours);
+
+	std::vector<std::vector<t_vec>> decimated = contours;
+	std::vector<std::vector<t_vec>> decimated_unchecked = contours;
+	std::size_t num_verts = 0, num_verts_decimated = 0;
+
+	for(std::size_t contouridx=0; contouridx<contours.size(); ++contouridx)
+	{
+		geo::decimate_contour<t_vec, t_scalar>(decimated[contouridx],
+			max_dist, true, 1., 1., 1e-6, &segment_grid, contouridx);
+		geo::decimate_contour<t_vec, t_scalar>(decimated_unchecked[contouridx], max_dist);
+
+		num_verts += contours[contouridx].size();
+		num_verts_decimated += decimated[contouridx].size();
+	}
+
+	// without checking the neighbours the contours grow into each other
+	BOOST_TEST(get_num_intersections(decimated_unchecked) > 0);
+	BOOST_TEST(get_num_intersections(decimated) == 0);
+
+	// the outer borders can still be decimated
+	BOOST_TEST(num_verts_decimated < num_verts);
+	std::cout << "Contour vertices: " << num_verts << " (original), "
+		<< num_verts_decimated << " (decimated next to neighbours)." << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(region_labels)
+{
+	const std::size_t width = 143, height = 277;
+	geo::PackedImage<std::uint8_t, 2> img(width, height);
+
+	// random noise with some larger obstacles
+	std::mt19937 rng{151617};
+	std::uniform_int_distribution<int> dist_val{0, 9};
+
+	for(std::size_t y=0; y<height; ++y)
+		for(std::size_t x=0; x<width; ++x)
+			if(int val = dist_val(rng); val < 4)
+				img.SetPixel(x, y, val < 2 ? 0xff : 0xf0);
+	img.CreateRuns();
+
+	auto labels = geo::label_regions(img, 1);
+	auto labels_par = geo::label_regions(img, 4);
+	BOOST_TEST(labels.GetNumRegions() == labels_par.GetNumRegions());
+
+	// flood fill the regions to compare them with the labels
+	using t_label = geo::RegionLabels::t_label;
+	std::vector<t_label> filled(width*height, geo::RegionLabels::NO_LABEL);
+	std::vector<bool> border;
+	std::vector<std::pair<int, int>> stack;
+	t_label num_regions = 0;
+
+	for(std::size_t y0=0; y0<height; ++y0)
+	{
+		for(std::size_t x0=0; x0<width; ++x0)
+		{
+			if(filled[y0*width + x0] != geo::RegionLabels::NO_LABEL)
+				continue;
+
+			const bool set = img.GetPixel(x0, y0) != 0;
+			const t_label label = num_regions++;
+			border.push_back(false);
+
+			stack.emplace_back(int(x0), int(y0));
+			filled[y0*width + x0] = label;
+
+			while(stack.size())
+			{
+				auto [x, y] = stack.back();
+				stack.pop_back();
+
+				if(x == 0 || y == 0 || x == int(width) - 1 || y == int(height) - 1)
+					border[label] = true;
+
+				for(int dy=-1; dy<=1; ++dy)
+				{
+					for(int dx=-1; dx<=1; ++dx)
+					{
+						// unset pixels are 4-connected, set ones 8-connected
+						if((dx == 0 && dy == 0) || (!set && dx != 0 && dy != 0))
+							continue;
+
+						int x1 = x + dx, y1 = y + dy;
+						if(x1 < 0 || y1 < 0 || x1 >= int(width) || y1 >= int(height))
+							continue;
+						if((img.GetPixel(x1, y1) != 0) != set || filled[y1*width + x1] != geo::RegionLabels::NO_LABEL)
+							continue;
+
+						filled[y1*width + x1] = label;
+						stack.emplace_back(x1, y1);
+					}
+				}
+			}
+		}
+	}
+
+	// the regions are numbered in the order of their first pixels
+	BOOST_TEST(labels.GetNumRegions() == num_regions);
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width; ++x)
+		{
+			t_label label = labels.GetLabel(x, y);
+			BOOST_TEST(label == filled[y*width + x]);
+			BOOST_TEST(labels_par.GetLabel(x, y) == label);
+			BOOST_TEST(labels.IsSet(label) == (img.GetPixel(x, y) != 0));
+			BOOST_TEST(labels.IsEnclosed(label) == !border[filled[y*width + x]]);
+		}
+	}
+
+	std::cout << "Regions: " << num_regions << std::endl;
+}
@@ -48,6 +48,8 @@ namespace ty = boost::typeindex;
 #include <tuple>
 #include <vector>
 #include <random>
+#include <numeric>
+#include <algorithm>
 #include <iostream>
 
 #include "src/libs/trees.h"
@@ -101,8 +103,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(trees, t_scalar,
 
 	// get point closest to the query point
 	t_vec closest_kd;
-	if(const auto* node = kd.get_closest(query); node)
-		closest_kd = *node->vec;
+	if(auto indices = kd.get_closest(query); indices.size())
+		closest_kd = kd.get_vec(indices[0]);
 
 
 	// create a two-dimensional R* tree
@@ -135,4 +137,47 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(trees, t_scalar,
 
 		BOOST_TEST((tl2::equals<t_vec>(closest_kd, closest_rt[0], eps)));
 	}
+
+
+	// brute-force distances to the query point
+	auto get_dist_sq = [&points, &query](std::size_t idx) -> t_scalar
+	{
+		t_vec dir = points[idx] - query;
+		return tl2::inner<t_vec>(dir, dir);
+	};
+
+	std::vector<std::size_t> sorted_indices(points.size());
+	std::iota(sorted_indices.begin(), sorted_indices.end(), 0);
+	std::sort(sorted_indices.begin(), sorted_indices.end(),
+		[&get_dist_sq](std::size_t idx1, std::size_t idx2) -> bool
+		{
+			return get_dist_sq(idx1) < get_dist_sq(idx2);
+		});
+
+	// test the k closest points
+	constexpr const std::size_t NUM_CLOSEST = 64;
+	std::vector<std::size_t> closest_k = kd.get_closest(query, NUM_CLOSEST);
+	BOOST_TEST(closest_k.size() == NUM_CLOSEST);
+	for(std::size_t i=0; i<std::min(NUM_CLOSEST, closest_k.size()); ++i)
+	{
+		BOOST_TEST(tl2::equals<t_scalar>(get_dist_sq(closest_k[i]),
+			get_dist_sq(sorted_indices[i]), eps*t_scalar(1e4)));
+	}
+
+	// test the radius query
+	const t_scalar rad = 10.;
+	std::size_t num_in_rad = std::count_if(points.begin(), points.end(),
+		[&query, rad](const t_vec& pt) -> bool
+		{
+			return tl2::norm<t_vec>(pt - query) <= rad;
+		});
+	BOOST_TEST(kd.get_in_radius(query, rad).size() == num_in_rad);
+
+	// test the batch query
+	std::vector<t_vec> queries{ query, points[0], points[1] };
+	auto closest_batch = kd.get_closest(queries, NUM_CLOSEST, 3);
+	BOOST_TEST(closest_batch.size() == queries.size());
+	BOOST_TEST((closest_batch[0] == closest_k));
+	BOOST_TEST((closest_batch[1].size() && closest_batch[1][0] == 0));
+	BOOST_TEST((closest_batch[2].size() && closest_batch[2][0] == 1));
 }
@@ -31,6 +31,8 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
+#include <random>
+#include <algorithm>
 
 #include <boost/test/included/unit_test.hpp>
 #include <boost/type_index.hpp>
@@ -84,3 +86,308 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(voronoi_lineseg, t_real,
 	BOOST_TEST((res_boost.GetVoronoiVertices().size() ==
 		res_cgal.GetVoronoiVertices().size()));
 }
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(voronoi_tiled, t_real, decltype(std::tuple<double>{}))
+{
+	using t_graph = geo::AdjacencyList<t_real>;
+	const std::size_t num_lines = 200;
+
+	t_real eps = 1e-4;
+
+	// random non-intersecting line segments
+	std::mt19937 rng{5678};
+	std::uniform_real_distribution<t_real> dist_pos{0., 1e4};
+	std::uniform_real_distribution<t_real> dist_len{1., 100.};
+	std::uniform_real_distribution<t_real> dist_angle{0., 2.*tl2::pi<t_real>};
+
+	std::vector<t_line<t_real>> lines;
+	lines.reserve(num_lines);
+
+	while(lines.size() < num_lines)
+	{
+		const t_vec<t_real> pos = tl2::create<t_vec<t_real>>({ dist_pos(rng), dist_pos(rng) });
+		const t_real len = dist_len(rng), angle = dist_angle(rng);
+		const t_vec<t_real> dir = tl2::create<t_vec<t_real>>({
+			len*std::cos(angle), len*std::sin(angle) });
+		t_line<t_real> line = std::make_pair(pos, pos + dir);
+
+		bool intersects = std::any_of(lines.begin(), lines.end(),
+			[&line](const t_line<t_real>& other) -> bool
+		{
+			return geo::intersect_lines_check<t_vec<t_real>>(line, other);
+		});
+
+		if(!intersects)
+			lines.emplace_back(std::move(line));
+	}
+
+	t_real para_edge_eps = 1e-2;
+
+	auto res_serial = geo::calc_voro<t_vec<t_real>, t_line<t_real>, t_graph>
+		(lines, eps, para_edge_eps);
+	auto res_tiled = geo::calc_voro_tiled<t_vec<t_real>, t_line<t_real>, t_graph>
+		(lines, eps, para_edge_eps, nullptr, 4, 0.1, 4);
+
+	// get the non-degenerate edges
+	auto get_edges = [eps](const auto& res) -> std::vector<std::array<t_real, 4>>
+	{
+		const auto& graph = res.GetVoronoiGraph();
+		const auto& verts = res.GetVoronoiVertices();
+		std::vector<std::array<t_real, 4>> edges;
+
+		for(std::size_t vert1=0; vert1<graph.GetNumVertices(); ++vert1)
+		{
+			for(std::size_t vert2 : graph.GetNeighbours(vert1))
+			{
+				if(tl2::equals<t_vec<t_real>>(verts[vert1], verts[vert2], eps))
+					continue;
+				edges.emplace_back(std::array<t_real, 4>{{
+					verts[vert1][0], verts[vert1][1], verts[vert2][0], verts[vert2][1] }});
+			}
+		}
+
+		return edges;
+	};
+
+	auto edges_serial = get_edges(res_serial);
+	auto edges_tiled = get_edges(res_tiled);
+
+	std::cout << "Number of Voronoi edges: " << edges_serial.size() << " (serial), "
+		<< edges_tiled.size() << " (tiled)." << std::endl;
+	BOOST_TEST((edges_serial.size() == edges_tiled.size()));
+
+	// every edge of the serial diagram is also in the tiled one
+	for(const auto& edge : edges_serial)
+	{
+		bool found = std::find_if(edges_tiled.begin(), edges_tiled.end(),
+			[&edge, eps](const std::array<t_real, 4>& edge_tiled) -> bool
+		{
+			for(std::size_t i=0; i<4; ++i)
+			{
+				if(!tl2::equals<t_real>(edge[i], edge_tiled[i], eps))
+					return false;
+			}
+			return true;
+		}) != edges_tiled.end();
+
+		BOOST_TEST(found);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(voronoi_raster, t_real, decltype(std::tuple<double>{}))
+{
+	using t_graph = geo::AdjacencyList<t_real>;
+
+	// two obstacles with a corridor between them
+	const std::size_t width = 64, height = 32;
+	geo::Image<std::uint8_t> img(width, height);
+	for(std::size_t y=0; y<height; ++y)
+	{
+		for(std::size_t x=0; x<width; ++x)
+		{
+			if(x < 20 || x >= 44)
+				img.SetPixel(x, y, 0xff);
+		}
+	}
+
+	geo::VoronoiLinesRegions<t_vec<t_real>, t_line<t_real>> regions{};
+	regions.SetGroupLines(true);
+
+	auto res = geo::calc_voro_raster<t_vec<t_real>, t_line<t_real>, t_graph>
+		(img, nullptr, &regions, 4, 4);
+
+	// a single bisector along the middle of the corridor
+	const auto& verts = res.GetVoronoiVertices();
+	BOOST_TEST((verts.size() == 2));
+	BOOST_TEST((res.GetParabolicEdges().size() == 1));
+
+	for(const auto& [points, vert0, vert1] : res.GetParabolicEdgesVec())
+	{
+		BOOST_TEST((points.size() == height));
+		for(const t_vec<t_real>& pt : points)
+			BOOST_TEST((pt[0] >= 31. && pt[0] <= 32.));
+	}
+
+	for(t_real dist : res.GetVoronoiVertexDists())
+		BOOST_TEST((dist >= 12. && dist <= 13.));
+
+	// exclude the lower half of the corridor
+	std::function<bool(const t_vec<t_real>&)> region_func =
+		[](const t_vec<t_real>& vec) -> bool
+	{
+		return vec[1] >= t_real(height/2);
+	};
+	regions.SetRemoveVoronoiVertices(true);
+	regions.SetRegionFunc(&region_func);
+
+	res = geo::calc_voro_raster<t_vec<t_real>, t_line<t_real>, t_graph>
+		(img, nullptr, &regions, 4, 4);
+
+	BOOST_TEST((res.GetVoronoiVertices().size() == 2));
+	for(const t_vec<t_real>& vert : res.GetVoronoiVertices())
+		BOOST_TEST((vert[1] < t_real(height/2)));
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(voronoi_contract, t_real, decltype(std::tuple<double>{}))
+{
+	using t_graph = geo::AdjacencyList<t_real>;
+
+	// grid of square obstacles
+	std::vector<t_line<t_real>> lines;
+	std::vector<std::pair<std::size_t, std::size_t>> groups;
+	for(int i=0; i<8; ++i)
+	{
+		for(int j=0; j<8; ++j)
+		{
+			t_real x = i*10 + (j%3), y = j*10 + (i%4), w = 3 + (i+j)%4;
+			std::size_t begin = lines.size();
+
+			t_vec<t_real> pts[4] = {
+				tl2::create<t_vec<t_real>>({ x, y }), tl2::create<t_vec<t_real>>({ x + w, y }),
+				tl2::create<t_vec<t_real>>({ x + w, y + w }), tl2::create<t_vec<t_real>>({ x, y + w }) };
+			for(int k=0; k<4; ++k)
+				lines.emplace_back(std::make_pair(pts[k], pts[(k + 1) % 4]));
+
+			groups.emplace_back(std::make_pair(begin, lines.size()));
+		}
+	}
+
+	geo::VoronoiLinesRegions<t_vec<t_real>, t_line<t_real>> regions{};
+	regions.SetGroupLines(true);
+	regions.SetRemoveVoronoiVertices(true);
+	regions.SetLineGroups(&groups);
+
+	auto res = geo::calc_voro<t_vec<t_real>, t_line<t_real>, t_graph>
+		(lines, 1e-4, 1e-2, &regions);
+
+	auto get_weights = [](const auto& res) -> t_real
+	{
+		const auto& graph = res.GetVoronoiGraph();
+		t_real weights = 0;
+
+		for(std::size_t vert1=0; vert1<graph.GetNumVertices(); ++vert1)
+			for(std::size_t vert2 : graph.GetNeighbours(vert1))
+				weights += *graph.GetWeight(vert1, vert2);
+		return weights;
+	};
+
+	const std::size_t num_verts = res.GetVoronoiVertices().size();
+	const t_real weights = get_weights(res);
+
+	std::size_t num_removed = res.ContractChains(2.);
+	std::cout << "Contracted Voronoi vertices: " << num_verts << " -> "
+		<< res.GetVoronoiVertices().size() << "." << std::endl;
+
+	BOOST_TEST((num_removed > 0));
+	BOOST_TEST((res.GetVoronoiVertices().size() == num_verts - num_removed));
+	BOOST_TEST((res.GetVoronoiGraph().GetNumVertices() == num_verts - num_removed));
+	BOOST_TEST(tl2::equals<t_real>(get_weights(res), weights, 1e-6));
+
+	// every edge has a bisector running between its vertices
+	const auto& graph = res.GetVoronoiGraph();
+	const auto& verts = res.GetVoronoiVertices();
+	for(std::size_t vert1=0; vert1<graph.GetNumVertices(); ++vert1)
+	{
+		for(std::size_t vert2 : graph.GetNeighbours(vert1))
+		{
+			auto iter_quadr = res.GetParabolicEdges().find(std::make_pair(vert1, vert2));
+			if(iter_quadr == res.GetParabolicEdges().end())
+			{
+				BOOST_TEST((res.GetLinearEdges().find(std::make_pair(vert1, vert2))
+					!= res.GetLinearEdges().end()));
+				continue;
+			}
+
+			const auto& points = iter_quadr->second;
+			BOOST_TEST((tl2::equals<t_vec<t_real>>(points.front(), verts[vert1], 1e-6) ||
+				tl2::equals<t_vec<t_real>>(points.front(), verts[vert2], 1e-6)));
+			BOOST_TEST((tl2::equals<t_vec<t_real>>(points.back(), verts[vert1], 1e-6) ||
+				tl2::equals<t_vec<t_real>>(points.back(), verts[vert2], 1e-6)));
+		}
+	}
+
+	// the removed vertices are kept as inner chain vertices and can still be retracted to
+	std::size_t num_inner = 0;
+	for(const auto& [indices, points] : res.GetChainVertices())
+	{
+		BOOST_TEST((graph.GetWeight(indices.first, indices.second).has_value()));
+		num_inner += points.size();
+
+		for(const t_vec<t_real>& point : points)
+		{
+			auto closest = res.GetClosestRetractionPoints(point, 1);
+			BOOST_TEST((closest.size() == 1));
+			BOOST_TEST(tl2::equals<t_vec<t_real>>(closest[0].first, point, 1e-6));
+			BOOST_TEST((closest[0].second == indices.first || closest[0].second == indices.second));
+		}
+	}
+	BOOST_TEST((num_inner == num_removed));
+	BOOST_TEST((res.GetIndexTreeSize() == num_verts));
+
+	// nothing left to contract
+	BOOST_TEST((res.ContractChains(2.) == 0));
+}
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(voronoi_parabola, t_real, decltype(std::tuple<double>{}))
+{
+	// focus above a tilted directrix
+	geo::VoronoiParabola<t_vec<t_real>, t_line<t_real>> parabola{
+		.focus = tl2::create<t_vec<t_real>>({ 2., 5. }),
+		.directrix = std::make_pair(
+			tl2::create<t_vec<t_real>>({ -10., -1. }),
+			tl2::create<t_vec<t_real>>({ 10., 1. })) };
+
+	t_vec<t_real> dir = std::get<1>(parabola.directrix) - std::get<0>(parabola.directrix);
+	dir /= tl2::norm<t_vec<t_real>>(dir);
+	const t_vec<t_real> normal = tl2::create<t_vec<t_real>>({ -dir[1], dir[0] });
+
+	// points on the parabola
+	auto get_point = [&parabola, &dir, &normal](t_real x) -> t_vec<t_real>
+	{
+		t_real focus_x = tl2::inner<t_vec<t_real>>(parabola.focus - std::get<0>(parabola.directrix), dir);
+		t_real focus_y = tl2::inner<t_vec<t_real>>(parabola.focus - std::get<0>(parabola.directrix), normal);
+		t_real y = ((x - focus_x)*(x - focus_x) + focus_y*focus_y) / (2.*focus_y);
+
+		return std::get<0>(parabola.directrix) + x*dir + y*normal;
+	};
+
+	const t_vec<t_real> start = get_point(0.), end = get_point(25.);
+	std::size_t num_fine = 0;
+
+	for(t_real max_dist : { 1., 0.1, 0.01 })
+	{
+		auto points = geo::sample_parabola<t_vec<t_real>, t_line<t_real>>(
+			parabola, start, end, max_dist);
+
+		BOOST_TEST((points.size() > 2));
+		BOOST_TEST((points.size() > num_fine));
+		BOOST_TEST(tl2::equals<t_vec<t_real>>(points.front(), start, 1e-6));
+		BOOST_TEST(tl2::equals<t_vec<t_real>>(points.back(), end, 1e-6));
+		num_fine = points.size();
+
+		for(std::size_t idx=0; idx<points.size(); ++idx)
+		{
+			// equidistant to focus and directrix
+			t_real dist_focus = tl2::norm<t_vec<t_real>>(points[idx] - parabola.focus);
+			t_real dist_directrix = std::abs(tl2::inner<t_vec<t_real>>(
+				points[idx] - std::get<0>(parabola.directrix), normal));
+			BOOST_TEST(tl2::equals<t_real>(dist_focus, dist_directrix, 1e-6));
+
+			// the arc stays close to the chords
+			if(idx == 0)
+				continue;
+			for(t_real param : { 0.25, 0.5, 0.75 })
+			{
+				t_vec<t_real> pt_chord = points[idx-1] + param*(points[idx] - points[idx-1]);
+				t_real min_dist = std::numeric_limits<t_real>::max();
+				for(t_real x=0.; x<=25.; x+=1e-3)
+					min_dist = std::min(min_dist, tl2::norm<t_vec<t_real>>(get_point(x) - pt_chord));
+				BOOST_TEST((min_dist <= max_dist + 1e-3));
+			}
+		}
+	}
+}